@@ -0,0 +1,394 @@
+#include "Checkpoint.h"
+#include "GameOfLife.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'G', 'O', 'L', 'C', 'K', 'P', 'T', '\0'};
+const unsigned kVersion = 1;
+const size_t kFixedHeaderSize = 52;
+const size_t kDataAlignment = 64;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool kLittleEndian = false;
+#else
+const bool kLittleEndian = true;
+#endif
+
+void put32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+void put64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+uint32_t get32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t get64(const unsigned char* p) {
+    return static_cast<uint64_t>(get32(p)) | (static_cast<uint64_t>(get32(p + 4)) << 32);
+}
+
+std::string systemError(const std::string& what, const std::string& filename) {
+    return what + " " + filename + ": " + std::strerror(errno);
+}
+
+// Unpack table: entry b holds the 8 cells of byte b, one per byte
+struct UnpackTable {
+    uint64_t cells[256];
+
+    UnpackTable() {
+        for (unsigned b = 0; b < 256; b++) {
+            unsigned char bytes[8];
+            for (int i = 0; i < 8; i++) bytes[i] = (b >> i) & 1u;
+            std::memcpy(&cells[b], bytes, 8);
+        }
+    }
+};
+
+const UnpackTable& unpackTable() {
+    static const UnpackTable table;
+    return table;
+}
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+    MappedFile() : data_(nullptr), size_(0) {}
+
+    ~MappedFile() {
+        if (data_) munmap(data_, size_);
+    }
+
+    bool open(const std::string& filename, std::string& error) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = systemError("cannot open", filename);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            error = systemError("cannot stat", filename);
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ < kFixedHeaderSize) {
+            error = "not a checkpoint file: " + filename;
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            error = systemError("cannot map", filename);
+            return false;
+        }
+        data_ = p;
+        // The grid is read front to back exactly once
+        madvise(data_, size_, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    const unsigned char* data() const { return static_cast<const unsigned char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    void* data_;
+    size_t size_;
+};
+
+// Parse and check the header of a mapped checkpoint
+bool parseHeader(const MappedFile& file, const std::string& filename, CheckpointInfo& info,
+                 std::string& rngState, size_t& dataOffset, std::string& error) {
+    const unsigned char* p = file.data();
+    if (std::memcmp(p, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a checkpoint file: " + filename;
+        return false;
+    }
+    if (get32(p + 8) != kVersion) {
+        error = "unsupported checkpoint version in " + filename;
+        return false;
+    }
+    dataOffset = get32(p + 12);
+    uint64_t height = get64(p + 16);
+    uint64_t width = get64(p + 24);
+    uint32_t rngLength = get32(p + 48);
+    if (height == 0 || width == 0 || height > 0x7FFFFFFF || width > 0x7FFFFFFF ||
+        kFixedHeaderSize + rngLength > dataOffset || dataOffset > file.size()) {
+        error = "corrupt checkpoint header in " + filename;
+        return false;
+    }
+    uint64_t dataBytes = (height * width + 7) / 8;
+    if (file.size() - dataOffset != dataBytes) {
+        error = "checkpoint file is truncated: " + filename;
+        return false;
+    }
+
+    info.height = static_cast<int>(height);
+    info.width = static_cast<int>(width);
+    info.generation = static_cast<long long>(get64(p + 32));
+    info.birthMask = get32(p + 40);
+    info.survivalMask = get32(p + 44);
+    rngState.assign(reinterpret_cast<const char*>(p + kFixedHeaderSize), rngLength);
+    return true;
+}
+
+} // namespace
+
+void Checkpoint::packGrid(const GameOfLife& game, std::vector<unsigned char>& bits) {
+    const unsigned char* cells = game.cellData();
+    size_t count = static_cast<size_t>(game.getHeight()) * game.getWidth();
+    bits.resize((count + 7) / 8);
+
+    size_t i = 0;
+    if (kLittleEndian) {
+        // Gather the low bit of 8 cells into one byte with a multiply
+        for (; i + 8 <= count; i += 8) {
+            uint64_t v;
+            std::memcpy(&v, cells + i, 8);
+            bits[i / 8] = static_cast<unsigned char>((v * 0x0102040810204080ULL) >> 56);
+        }
+    }
+    for (; i < count; i++) {
+        if (i % 8 == 0) bits[i / 8] = 0;
+        bits[i / 8] |= static_cast<unsigned char>(cells[i] << (i % 8));
+    }
+}
+
+std::string Checkpoint::buildHeader(const GameOfLife& game) {
+    std::string rngState = game.getRngState();
+
+    std::string header(kMagic, sizeof(kMagic));
+    put32(header, kVersion);
+    size_t dataOffset = (kFixedHeaderSize + rngState.size() + kDataAlignment - 1) /
+                        kDataAlignment * kDataAlignment;
+    put32(header, static_cast<uint32_t>(dataOffset));
+    put64(header, static_cast<uint64_t>(game.getHeight()));
+    put64(header, static_cast<uint64_t>(game.getWidth()));
+    put64(header, static_cast<uint64_t>(game.getGeneration()));
+    put32(header, game.getRule().birthMask());
+    put32(header, game.getRule().survivalMask());
+    put32(header, static_cast<uint32_t>(rngState.size()));
+    header += rngState;
+    header.resize(dataOffset, '\0');
+    return header;
+}
+
+bool Checkpoint::writeFile(const std::string& filename, const std::string& header,
+                           const std::vector<unsigned char>& bits, std::string& error) {
+    std::string tmpName = filename + ".tmp";
+    int fd = ::open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = systemError("cannot create", tmpName);
+        return false;
+    }
+
+    const char* chunks[2] = {header.data(), reinterpret_cast<const char*>(bits.data())};
+    size_t sizes[2] = {header.size(), bits.size()};
+    for (int c = 0; c < 2; c++) {
+        const char* p = chunks[c];
+        size_t left = sizes[c];
+        while (left > 0) {
+            ssize_t n = ::write(fd, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error = systemError("cannot write", tmpName);
+                ::close(fd);
+                ::unlink(tmpName.c_str());
+                return false;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+
+    // The data must be on disk before the rename makes it visible
+    if (fsync(fd) != 0 || ::close(fd) != 0) {
+        error = systemError("cannot flush", tmpName);
+        ::unlink(tmpName.c_str());
+        return false;
+    }
+    if (std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+        error = systemError("cannot rename to", filename);
+        ::unlink(tmpName.c_str());
+        return false;
+    }
+
+    // Persist the rename itself
+    std::string dir = ".";
+    size_t slash = filename.rfind('/');
+    if (slash != std::string::npos) dir = slash == 0 ? "/" : filename.substr(0, slash);
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool Checkpoint::save(const std::string& filename, const GameOfLife& game, std::string& error) {
+    std::vector<unsigned char> bits;
+    packGrid(game, bits);
+    return writeFile(filename, buildHeader(game), bits, error);
+}
+
+bool Checkpoint::readInfo(const std::string& filename, CheckpointInfo& info, std::string& error) {
+    MappedFile file;
+    if (!file.open(filename, error)) {
+        return false;
+    }
+    std::string rngState;
+    size_t dataOffset;
+    return parseHeader(file, filename, info, rngState, dataOffset, error);
+}
+
+bool Checkpoint::restore(const std::string& filename, GameOfLife& game,
+                         CheckpointInfo& info, std::string& error) {
+    MappedFile file;
+    if (!file.open(filename, error)) {
+        return false;
+    }
+    std::string rngState;
+    size_t dataOffset;
+    if (!parseHeader(file, filename, info, rngState, dataOffset, error)) {
+        return false;
+    }
+    if (info.height != game.getHeight() || info.width != game.getWidth()) {
+        error = "checkpoint grid size does not match the game";
+        return false;
+    }
+    if (!game.setRngState(rngState)) {
+        error = "corrupt random number generator state in " + filename;
+        return false;
+    }
+
+    // Expand each byte to 8 cells with one table lookup
+    const uint64_t* table = unpackTable().cells;
+    const unsigned char* bits = file.data() + dataOffset;
+    unsigned char* cells = game.cellData();
+    size_t count = static_cast<size_t>(info.height) * info.width;
+    size_t full = count / 8;
+    for (size_t b = 0; b < full; b++) {
+        std::memcpy(cells + b * 8, &table[bits[b]], 8);
+    }
+    for (size_t i = full * 8; i < count; i++) {
+        cells[i] = (bits[i / 8] >> (i % 8)) & 1u;
+    }
+
+    game.setRule(Rule(info.birthMask, info.survivalMask));
+    game.setGeneration(info.generation);
+    return true;
+}
+
+CheckpointWriter::CheckpointWriter(const CheckpointOptions& options)
+    : options_(options), pending_(false), running_(true), written_(0), skipped_(0) {
+    writer_ = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void CheckpointWriter::capture(const GameOfLife& game) {
+    if (options_.every <= 0 || game.getGeneration() == 0 ||
+        game.getGeneration() % options_.every != 0) {
+        return;
+    }
+    if (!request(game)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        skipped_++;
+    }
+}
+
+bool CheckpointWriter::request(const GameOfLife& game) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_) {
+            return false;
+        }
+    }
+
+    // Only this thread sets pending_, so the buffers are ours until we do
+    Checkpoint::packGrid(game, bits_);
+    header_ = Checkpoint::buildHeader(game);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = true;
+    }
+    wake_.notify_one();
+    return true;
+}
+
+bool CheckpointWriter::writeNow(const GameOfLife& game) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !pending_; });
+    }
+
+    std::string error;
+    bool ok = Checkpoint::save(options_.filename, game, error);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) {
+        written_++;
+    } else {
+        error_ = error;
+    }
+    return ok;
+}
+
+unsigned long CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+unsigned long CheckpointWriter::skipped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skipped_;
+}
+
+std::string CheckpointWriter::lastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void CheckpointWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return pending_ || !running_; });
+        if (!pending_) {
+            break;
+        }
+
+        lock.unlock();
+        std::string error;
+        bool ok = Checkpoint::writeFile(options_.filename, header_, bits_, error);
+        lock.lock();
+
+        if (ok) {
+            written_++;
+        } else {
+            error_ = error;
+        }
+        pending_ = false;
+        idle_.notify_all();
+    }
+}
@@ -0,0 +1,212 @@
+/**
+ * @file Checkpoint.h
+ * @brief Binary checkpoints of the complete game state for long runs
+ * @author Your Name
+ * @date March 2025
+ */
+
+ #ifndef CHECKPOINT_H
+ #define CHECKPOINT_H
+
+ #include <condition_variable>
+ #include <mutex>
+ #include <string>
+ #include <thread>
+ #include <vector>
+
+ class GameOfLife;
+
+ /**
+  * @struct CheckpointInfo
+  * @brief Header fields of a checkpoint file
+  */
+ struct CheckpointInfo {
+     int height;            ///< Grid height
+     int width;             ///< Grid width
+     long long generation;  ///< Generation the checkpoint was taken at
+     unsigned birthMask;    ///< Birth mask of the rule
+     unsigned survivalMask; ///< Survival mask of the rule
+
+     CheckpointInfo() : height(0), width(0), generation(0), birthMask(0), survivalMask(0) {}
+ };
+
+ /**
+  * @class Checkpoint
+  * @brief Reads and writes checkpoint files
+  *
+  * A checkpoint holds everything needed to continue a run exactly: grid size,
+  * generation counter, rule, random number generator state and the grid with
+  * one bit per cell. All integers are little-endian. Layout:
+  *
+  * | Offset | Size | Field                                   |
+  * |--------|------|-----------------------------------------|
+  * | 0      | 8    | Magic "GOLCKPT\0"                       |
+  * | 8      | 4    | Format version (1)                      |
+  * | 12     | 4    | Offset of the grid data                 |
+  * | 16     | 8    | Height                                  |
+  * | 24     | 8    | Width                                   |
+  * | 32     | 8    | Generation                              |
+  * | 40     | 4    | Birth mask                              |
+  * | 44     | 4    | Survival mask                           |
+  * | 48     | 4    | Length of the RNG state                 |
+  * | 52     | n    | RNG state (text form of std::mt19937_64)|
+  * | ...    | ...  | Zero padding to a multiple of 64        |
+  * | data   | ...  | Grid, row-major, cell k in bit k%8 of byte k/8 |
+  */
+ class Checkpoint {
+ public:
+     /**
+      * @brief Write a checkpoint of the game synchronously
+      * @param filename The file to write; replaced atomically
+      * @param game The game to save
+      * @param error Receives a description of the problem on failure
+      * @return true if the checkpoint was written
+      */
+     static bool save(const std::string& filename, const GameOfLife& game, std::string& error);
+
+     /**
+      * @brief Read the header of a checkpoint file
+      * @param filename The file to read
+      * @param info Receives the header fields
+      * @param error Receives a description of the problem on failure
+      * @return true if the file is a valid checkpoint
+      */
+     static bool readInfo(const std::string& filename, CheckpointInfo& info, std::string& error);
+
+     /**
+      * @brief Restore a game from a checkpoint file
+      *
+      * The file is memory-mapped and the grid unpacked with a table lookup per
+      * byte. The game must have the size stored in the file (see readInfo()).
+      * @param filename The file to read
+      * @param game The game to restore into
+      * @param info Receives the header fields
+      * @param error Receives a description of the problem on failure
+      * @return true if the game was restored
+      */
+     static bool restore(const std::string& filename, GameOfLife& game,
+                         CheckpointInfo& info, std::string& error);
+
+     /**
+      * @brief Pack the grid into one bit per cell
+      * @param game The game to pack
+      * @param bits Receives (height * width + 7) / 8 bytes
+      */
+     static void packGrid(const GameOfLife& game, std::vector<unsigned char>& bits);
+
+     /**
+      * @brief Build the header for a packed grid
+      * @param game The game the grid was packed from
+      * @return Header bytes including padding; the grid follows directly
+      */
+     static std::string buildHeader(const GameOfLife& game);
+
+     /**
+      * @brief Write header and grid to a file atomically
+      *
+      * Writes to "<filename>.tmp", flushes it to disk and renames it over
+      * the old file, so a crash leaves either the old or the new checkpoint.
+      * @param filename The file to write
+      * @param header Header from buildHeader()
+      * @param bits Grid from packGrid()
+      * @param error Receives a description of the problem on failure
+      * @return true if the file was written
+      */
+     static bool writeFile(const std::string& filename, const std::string& header,
+                           const std::vector<unsigned char>& bits, std::string& error);
+ };
+
+ /**
+  * @struct CheckpointOptions
+  * @brief Settings of periodic checkpoints
+  */
+ struct CheckpointOptions {
+     std::string filename; ///< Checkpoint file, overwritten each time
+     int every;            ///< Write every Nth generation (0 = only on request)
+
+     CheckpointOptions() : filename("gameoflife.ckpt"), every(0) {}
+ };
+
+ /**
+  * @class CheckpointWriter
+  * @brief Writes checkpoints from a background thread
+  *
+  * The grid is packed on the simulation thread (one bit per cell, so the copy
+  * is 8 times smaller than the grid) and the file is written and synced by the
+  * writer thread. If the previous checkpoint is still being written, a
+  * periodic checkpoint is skipped rather than making the simulation wait.
+  */
+ class CheckpointWriter {
+ public:
+     /**
+      * @brief Create a writer and start its thread
+      * @param options Checkpoint settings
+      */
+     explicit CheckpointWriter(const CheckpointOptions& options);
+
+     /**
+      * @brief Wait for a pending checkpoint and stop the thread
+      */
+     ~CheckpointWriter();
+
+     /**
+      * @brief Offer the current generation for a periodic checkpoint
+      *
+      * Does nothing unless the generation is a multiple of the interval.
+      * @param game The game to save
+      */
+     void capture(const GameOfLife& game);
+
+     /**
+      * @brief Queue a checkpoint of the current generation
+      * @param game The game to save
+      * @return true if queued, false if the writer is still busy
+      */
+     bool request(const GameOfLife& game);
+
+     /**
+      * @brief Wait until the writer is idle, then write a checkpoint synchronously
+      * @param game The game to save
+      * @return true if the checkpoint was written
+      */
+     bool writeNow(const GameOfLife& game);
+
+     /**
+      * @brief Get the number of checkpoints written
+      * @return Checkpoints written
+      */
+     unsigned long written() const;
+
+     /**
+      * @brief Get the number of periodic checkpoints skipped because the writer was busy
+      * @return Checkpoints skipped
+      */
+     unsigned long skipped() const;
+
+     /**
+      * @brief Get the last error reported by the writer
+      * @return The error, empty if all writes succeeded
+      */
+     std::string lastError() const;
+
+ private:
+     /**
+      * @brief Body of the writer thread
+      */
+     void writerLoop();
+
+     CheckpointOptions options_;
+     std::thread writer_;
+     mutable std::mutex mutex_;
+     std::condition_variable wake_;
+     std::condition_variable idle_;
+     bool pending_;   ///< A packed checkpoint is waiting or being written
+     bool running_;
+     std::string header_;
+     std::vector<unsigned char> bits_;
+     unsigned long written_;
+     unsigned long skipped_;
+     std::string error_;
+ };
+
+ #endif // CHECKPOINT_H
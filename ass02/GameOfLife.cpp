@@ -1,50 +1,122 @@
 #include "GameOfLife.h"
+#include "TerminalRenderer.h"
+#include <ncurses.h>
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <thread>
 #include <chrono>
 #include <iostream>
 
+namespace {
+
+// Next state looked up in the rule's table (works for every rule)
+struct TableLookup {
+    const unsigned char* table;
+    unsigned char operator()(unsigned index) const { return table[index]; }
+};
+
+// Next state taken from a table folded into a compile-time constant
+template <unsigned PackedTable>
+struct PackedLookup {
+    unsigned char operator()(unsigned index) const {
+        return static_cast<unsigned char>((PackedTable >> index) & 1u);
+    }
+};
+
+/**
+ * Compute one generation on a torus. The lookup index is
+ * neighbors * 2 + alive, so there are no branches per cell.
+ */
+template <typename Lookup>
+inline void stepGrid(const unsigned char* cur, unsigned char* next,
+                     int height, int width, Lookup lookup) {
+    for (int i = 0; i < height; i++) {
+        const unsigned char* up = cur + static_cast<size_t>((i + height - 1) % height) * width;
+        const unsigned char* mid = cur + static_cast<size_t>(i) * width;
+        const unsigned char* down = cur + static_cast<size_t>((i + 1) % height) * width;
+        unsigned char* out = next + static_cast<size_t>(i) * width;
+        
+        // Interior columns need no wrapping
+        for (int j = 1; j < width - 1; j++) {
+            unsigned n = up[j - 1] + up[j] + up[j + 1] +
+                         mid[j - 1] + mid[j + 1] +
+                         down[j - 1] + down[j] + down[j + 1];
+            out[j] = lookup(n * 2 + mid[j]);
+        }
+        
+        // First and last column wrap around
+        for (int j = 0; j < width; j += (width > 1 ? width - 1 : 1)) {
+            int l = (j + width - 1) % width;
+            int r = (j + 1) % width;
+            unsigned n = up[l] + up[j] + up[r] +
+                         mid[l] + mid[r] +
+                         down[l] + down[j] + down[r];
+            out[j] = lookup(n * 2 + mid[j]);
+        }
+    }
+}
+
+void stepGeneric(const unsigned char* cur, unsigned char* next, int height, int width,
+                 const unsigned char* table) {
+    TableLookup lookup = {table};
+    stepGrid(cur, next, height, width, lookup);
+}
+
+template <unsigned PackedTable>
+void stepFixed(const unsigned char* cur, unsigned char* next, int height, int width,
+               const unsigned char*) {
+    stepGrid(cur, next, height, width, PackedLookup<PackedTable>());
+}
+
+// Rules that get their own compile-time specialized kernel
+constexpr unsigned kConway = packRuleTable(1u << 3, (1u << 2) | (1u << 3));
+constexpr unsigned kHighLife = packRuleTable((1u << 3) | (1u << 6), (1u << 2) | (1u << 3));
+constexpr unsigned kDayAndNight = packRuleTable((1u << 3) | (1u << 6) | (1u << 7) | (1u << 8),
+                                                (1u << 3) | (1u << 4) | (1u << 6) | (1u << 7) | (1u << 8));
+constexpr unsigned kSeeds = packRuleTable(1u << 2, 0u);
+
+struct SpecializedKernel {
+    unsigned packedTable;
+    void (*kernel)(const unsigned char*, unsigned char*, int, int, const unsigned char*);
+};
+
+const SpecializedKernel kSpecializedKernels[] = {
+    {kConway, &stepFixed<kConway>},
+    {kHighLife, &stepFixed<kHighLife>},
+    {kDayAndNight, &stepFixed<kDayAndNight>},
+    {kSeeds, &stepFixed<kSeeds>},
+};
+
+} // namespace
+
 GameOfLife::GameOfLife(int height, int width) 
-    : height_(height), width_(width), running_(true), generation_(0) {
+    : height_(height), width_(width), running_(true), generation_(0), stepDelayMs_(100),
+      timeLapse_(nullptr), checkpoint_(nullptr), kernel_(&stepGeneric) {
     // Initialize grid with all cells dead
-    grid_.resize(height_, std::vector<bool>(width_, false));
-    nextGrid_.resize(height_, std::vector<bool>(width_, false));
+    grid_.assign(static_cast<size_t>(height_) * width_, 0);
+    nextGrid_.assign(static_cast<size_t>(height_) * width_, 0);
     
-    // Initialize ncurses
-    initNCurses();
+    // Conway's rule by default
+    setRule(Rule());
     
     // Seed random number generator
-    std::srand(std::time(nullptr));
+    rng_.seed(static_cast<std::mt19937_64::result_type>(std::time(nullptr)));
 }
 
 GameOfLife::~GameOfLife() {
-    // End ncurses mode
-    endwin();
 }
 
-void GameOfLife::initNCurses() {
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    timeout(100); // Set getch() non-blocking with 100ms timeout
-    
-    // Check if terminal supports colors
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_BLACK, COLOR_GREEN);  // Live cells
-        init_pair(2, COLOR_BLACK, COLOR_BLACK);  // Dead cells
-    }
+void GameOfLife::setStepDelay(int milliseconds) {
+    stepDelayMs_ = milliseconds < 0 ? 0 : milliseconds;
 }
 
 void GameOfLife::initializeRandom() {
     for (int i = 0; i < height_; i++) {
         for (int j = 0; j < width_; j++) {
             // 25% chance of a cell being alive
-            grid_[i][j] = (std::rand() % 4 == 0);
+            grid_[cellIndex(i, j)] = (rng_() % 4 == 0);
         }
     }
 }
@@ -58,11 +130,7 @@ void GameOfLife::initializePattern(const std::vector<std::vector<bool>>& pattern
     int startCol = (width_ - patternWidth) / 2;
     
     // Clear the grid first
-    for (int i = 0; i < height_; i++) {
-        for (int j = 0; j < width_; j++) {
-            grid_[i][j] = false;
-        }
-    }
+    clear();
     
     // Place the pattern in the center
     for (int i = 0; i < patternHeight; i++) {
@@ -70,251 +138,199 @@ void GameOfLife::initializePattern(const std::vector<std::vector<bool>>& pattern
             int row = startRow + i;
             int col = startCol + j;
             if (row >= 0 && row < height_ && col >= 0 && col < width_) {
-                grid_[row][col] = pattern[i][j];
+                grid_[cellIndex(row, col)] = pattern[i][j];
             }
         }
     }
 }
 
+void GameOfLife::clear() {
+    std::fill(grid_.begin(), grid_.end(), 0);
+}
+
+void GameOfLife::setCell(int row, int col, bool alive) {
+    if (row >= 0 && row < height_ && col >= 0 && col < width_) {
+        grid_[cellIndex(row, col)] = alive ? 1 : 0;
+    }
+}
+
+long long GameOfLife::setRun(long long row, long long col, long long count) {
+    // Clip the run to the grid
+    if (row < 0 || row >= height_ || count <= 0) {
+        return 0;
+    }
+    long long begin = col < 0 ? 0 : col;
+    long long end = col + count < width_ ? col + count : width_;
+    if (begin >= end) {
+        return 0;
+    }
+    std::memset(&grid_[cellIndex(static_cast<int>(row), static_cast<int>(begin))], 1,
+                static_cast<size_t>(end - begin));
+    return end - begin;
+}
+
 void GameOfLife::run() {
+    // Set up the terminal; it is restored when the renderer goes out of scope
+    TerminalRenderer renderer;
+    
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point nextStep = Clock::now();
+    
     while (running_) {
-        // Clear screen
-        clear();
-        
-        // Draw the current state
-        draw();
-        
-        // Display generation count
-        mvprintw(height_ + 1, 0, "Generation: %d", generation_);
-        mvprintw(height_ + 2, 0, "Press 'q' to quit, 's' to save image, 'r' to randomize");
-        
-        // Process input
+        // Process input (non-blocking)
         int ch = getch();
         switch (ch) {
             case 'q':
             case 'Q':
                 running_ = false;
-                break;
+                continue;
             case 's':
             case 'S':
                 {
-                    std::string filename = "gameoflife_" + generateTimestamp() + ".bmp";
-                    if (saveAsBMP(filename)) {
-                        mvprintw(height_ + 3, 0, "Image saved as %s", filename.c_str());
-                        refresh();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                    std::string filename = "gameoflife_" + generateTimestamp() +
+                                           Snapshot::extension(snapshotOptions_.format);
+                    if (saveSnapshot(filename)) {
+                        renderer.showMessage("Image saved as " + filename);
                     } else {
-                        mvprintw(height_ + 3, 0, "Failed to save image");
-                        refresh();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                        renderer.showMessage("Failed to save image");
                     }
                 }
                 break;
+            case 'c':
+            case 'C':
+                if (!checkpoint_) {
+                    renderer.showMessage("Checkpoints are disabled (use --checkpoint FILE)");
+                } else if (checkpoint_->request(*this)) {
+                    renderer.showMessage("Checkpoint requested");
+                } else {
+                    renderer.showMessage("Previous checkpoint still being written");
+                }
+                break;
             case 'r':
             case 'R':
                 initializeRandom();
                 generation_ = 0;
                 break;
+            case '+':
+                setStepDelay(stepDelayMs_ / 2);
+                break;
+            case '-':
+                setStepDelay(stepDelayMs_ == 0 ? 1 : stepDelayMs_ * 2);
+                break;
+            case KEY_RESIZE:
+                renderer.invalidate();
+                break;
+        }
+        
+        // Draw the current state, unless the terminal is still busy with the
+        // previous frame; in that case this generation is simply not shown
+        if (renderer.frameDue()) {
+            renderer.present(*this);
+        } else {
+            renderer.skipFrame();
+        }
+        
+        // Hand the generation to the time-lapse recorder and the checkpoint
+        // writer (neither blocks on I/O)
+        if (timeLapse_) {
+            timeLapse_->capture(*this);
+        }
+        if (checkpoint_) {
+            checkpoint_->capture(*this);
         }
         
         // Update the game state
         update();
         generation_++;
         
-        // Small delay to control game speed
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Pace the simulation independently of the display
+        nextStep += std::chrono::milliseconds(stepDelayMs_);
+        Clock::time_point now = Clock::now();
+        if (nextStep > now) {
+            std::this_thread::sleep_until(nextStep);
+        } else {
+            nextStep = now;
+        }
     }
 }
 
 void GameOfLife::update() {
-    // Calculate the next generation
-    for (int i = 0; i < height_; i++) {
-        for (int j = 0; j < width_; j++) {
-            int neighbors = countNeighbors(i, j);
-            
-            // Apply Conway's Game of Life rules
-            if (grid_[i][j]) {
-                // Cell is alive
-                if (neighbors < 2 || neighbors > 3) {
-                    nextGrid_[i][j] = false; // Cell dies
-                } else {
-                    nextGrid_[i][j] = true;  // Cell survives
-                }
-            } else {
-                // Cell is dead
-                if (neighbors == 3) {
-                    nextGrid_[i][j] = true;  // Cell becomes alive
-                } else {
-                    nextGrid_[i][j] = false; // Cell stays dead
-                }
-            }
-        }
-    }
+    // Calculate the next generation with the kernel compiled for the rule
+    kernel_(grid_.data(), nextGrid_.data(), height_, width_, rule_.table());
     
-    // Update the grid with the new generation
-    grid_ = nextGrid_;
+    // Update the grid with the new generation (swap buffers, no copy)
+    grid_.swap(nextGrid_);
 }
 
-int GameOfLife::countNeighbors(int row, int col) {
-    int count = 0;
+void GameOfLife::setRule(const Rule& rule) {
+    rule_ = rule;
+    kernel_ = &stepGeneric;
     
-    // Check all 8 neighboring cells
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            // Skip the cell itself
-            if (i == 0 && j == 0) continue;
-            
-            // Calculate neighbor coordinates with wrapping
-            int neighborRow = (row + i + height_) % height_;
-            int neighborCol = (col + j + width_) % width_;
-            
-            // Count live neighbors
-            if (grid_[neighborRow][neighborCol]) {
-                count++;
-            }
+    // Use a kernel with the rule built in at compile time if there is one
+    for (size_t i = 0; i < sizeof(kSpecializedKernels) / sizeof(kSpecializedKernels[0]); i++) {
+        if (kSpecializedKernels[i].packedTable == rule.packedTable()) {
+            kernel_ = kSpecializedKernels[i].kernel;
+            break;
         }
     }
-    
-    return count;
 }
 
-void GameOfLife::draw() {
-    for (int i = 0; i < height_; i++) {
-        for (int j = 0; j < width_; j++) {
-            if (grid_[i][j]) {
-                // Cell is alive
-                if (has_colors()) {
-                    attron(COLOR_PAIR(1));
-                    mvaddch(i, j, ' ');
-                    attroff(COLOR_PAIR(1));
-                } else {
-                    mvaddch(i, j, '#');
-                }
-            } else {
-                // Cell is dead
-                if (has_colors()) {
-                    attron(COLOR_PAIR(2));
-                    mvaddch(i, j, ' ');
-                    attroff(COLOR_PAIR(2));
-                } else {
-                    mvaddch(i, j, '.');
-                }
-            }
+bool GameOfLife::hasSpecializedKernel() const {
+    return kernel_ != &stepGeneric;
+}
+
+long long GameOfLife::getPopulation() const {
+    long long population = 0;
+    for (size_t i = 0; i < grid_.size(); i++) {
+        population += grid_[i];
+    }
+    return population;
+}
+
+void GameOfLife::runHeadless(int generations) {
+    for (int g = 0; g < generations && running_; g++) {
+        if (timeLapse_) {
+            timeLapse_->capture(*this);
+        }
+        if (checkpoint_) {
+            checkpoint_->capture(*this);
         }
+        update();
+        generation_++;
     }
-    
-    // Update the screen
-    refresh();
 }
 
-std::string GameOfLife::generateTimestamp() {
-    auto now = std::time(nullptr);
-    auto tm = *std::localtime(&now);
-    
+std::string GameOfLife::getRngState() const {
     std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
+    oss << rng_;
     return oss.str();
 }
 
-bool GameOfLife::saveAsBMP(const std::string& filename) {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file) {
+bool GameOfLife::setRngState(const std::string& state) {
+    std::istringstream iss(state);
+    std::mt19937_64 rng;
+    iss >> rng;
+    if (iss.fail()) {
         return false;
     }
-    
-    // Write BMP header
-    writeBMPHeader(file, width_, height_);
-    
-    // Write BMP data
-    writeBMPData(file);
-    
-    file.close();
+    rng_ = rng;
     return true;
 }
 
-void GameOfLife::writeBMPHeader(std::ofstream& file, int width, int height) {
-    // Calculate row size and padding
-    int rowSize = ((width * 24 + 31) / 32) * 4;
-    int paddingSize = rowSize - width * 3;
-    int fileSize = 54 + rowSize * height;
-    
-    // BMP file header (14 bytes)
-    unsigned char bmpFileHeader[14] = {
-        'B', 'M',                       // Signature
-        0, 0, 0, 0,                     // File size in bytes
-        0, 0, 0, 0,                     // Reserved
-        54, 0, 0, 0                     // Offset to start of pixel data
-    };
-    
-    // Update file size in header
-    bmpFileHeader[2] = (unsigned char)(fileSize);
-    bmpFileHeader[3] = (unsigned char)(fileSize >> 8);
-    bmpFileHeader[4] = (unsigned char)(fileSize >> 16);
-    bmpFileHeader[5] = (unsigned char)(fileSize >> 24);
-    
-    // BMP info header (40 bytes)
-    unsigned char bmpInfoHeader[40] = {
-        40, 0, 0, 0,                    // Info header size
-        0, 0, 0, 0,                     // Width
-        0, 0, 0, 0,                     // Height
-        1, 0,                           // Number of color planes
-        24, 0,                          // Bits per pixel
-        0, 0, 0, 0,                     // Compression
-        0, 0, 0, 0,                     // Image size
-        0, 0, 0, 0,                     // X pixels per meter
-        0, 0, 0, 0,                     // Y pixels per meter
-        0, 0, 0, 0,                     // Colors in color table
-        0, 0, 0, 0                      // Important color count
-    };
-    
-    // Update width in header
-    bmpInfoHeader[4] = (unsigned char)(width);
-    bmpInfoHeader[5] = (unsigned char)(width >> 8);
-    bmpInfoHeader[6] = (unsigned char)(width >> 16);
-    bmpInfoHeader[7] = (unsigned char)(width >> 24);
-    
-    // Update height in header
-    bmpInfoHeader[8] = (unsigned char)(height);
-    bmpInfoHeader[9] = (unsigned char)(height >> 8);
-    bmpInfoHeader[10] = (unsigned char)(height >> 16);
-    bmpInfoHeader[11] = (unsigned char)(height >> 24);
+std::string GameOfLife::generateTimestamp() {
+    auto now = std::time(nullptr);
+    auto tm = *std::localtime(&now);
     
-    // Write headers
-    file.write(reinterpret_cast<char*>(bmpFileHeader), 14);
-    file.write(reinterpret_cast<char*>(bmpInfoHeader), 40);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
+    return oss.str();
 }
 
-void GameOfLife::writeBMPData(std::ofstream& file) {
-    // Calculate row size and padding
-    int rowSize = ((width_ * 24 + 31) / 32) * 4;
-    int paddingSize = rowSize - width_ * 3;
-    unsigned char padding[3] = {0, 0, 0};
-    
-    // BMP stores images bottom-up
-    for (int i = height_ - 1; i >= 0; i--) {
-        for (int j = 0; j < width_; j++) {
-            unsigned char color[3];
-            
-            // Set pixel color (BGR format)
-            if (grid_[i][j]) {
-                // Live cell - green
-                color[0] = 0;    // Blue
-                color[1] = 255;  // Green
-                color[2] = 0;    // Red
-            } else {
-                // Dead cell - black
-                color[0] = 0;    // Blue
-                color[1] = 0;    // Green
-                color[2] = 0;    // Red
-            }
-            
-            // Write pixel data
-            file.write(reinterpret_cast<char*>(color), 3);
-        }
-        
-        // Write padding
-        if (paddingSize > 0) {
-            file.write(reinterpret_cast<char*>(padding), paddingSize);
-        }
-    }
+bool GameOfLife::saveAsBMP(const std::string& filename) {
+    // 24-bit BMP with one pixel per cell
+    return Snapshot::save(filename, *this, SnapshotOptions());
+}
+
+bool GameOfLife::saveSnapshot(const std::string& filename) const {
+    return Snapshot::save(filename, *this, snapshotOptions_);
 }
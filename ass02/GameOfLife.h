@@ -1,6 +1,6 @@
 /**
  * @file GameOfLife.h
- * @brief Conway's Game of Life implementation using ncurses
+ * @brief Conway's Game of Life implementation
  * @author Your Name
  * @date March 2025
  */
@@ -8,20 +8,24 @@
  #ifndef GAME_OF_LIFE_H
  #define GAME_OF_LIFE_H
  
- #include <ncurses.h>
+ #include "Checkpoint.h"
+ #include "Rule.h"
+ #include "Snapshot.h"
  #include <vector>
  #include <string>
  #include <fstream>
  #include <ctime>
  #include <sstream>
  #include <iomanip>
+ #include <random>
  
  /**
   * @class GameOfLife
   * @brief Class implementing Conway's Game of Life simulation
   * 
   * This class provides functionality to run and visualize Conway's Game of Life
-  * using the ncurses library for terminal-based visualization.
+  * using the ncurses library for terminal-based visualization. The simulation
+  * itself does not depend on ncurses; the terminal is only set up by run().
   */
  class GameOfLife {
  public:
@@ -48,20 +52,146 @@
       */
      void initializePattern(const std::vector<std::vector<bool>>& pattern);
      
+     /**
+      * @brief Kill all cells
+      */
+     void clear();
+     
+     /**
+      * @brief Set the state of a single cell
+      *
+      * Coordinates outside the grid are ignored.
+      * @param row The row of the cell
+      * @param col The column of the cell
+      * @param alive The new state of the cell
+      */
+     void setCell(int row, int col, bool alive);
+     
+     /**
+      * @brief Bring a horizontal run of cells to life
+      *
+      * The run is clipped to the grid, so pattern loaders can pass coordinates
+      * of patterns larger than the grid without checking them first.
+      * @param row The row of the run
+      * @param col The column of the first cell of the run
+      * @param count The number of cells in the run
+      * @return The number of cells actually set inside the grid
+      */
+     long long setRun(long long row, long long col, long long count);
+     
      /**
       * @brief Run the game simulation
       */
      void run();
      
+     /**
+      * @brief Run the simulation without a terminal
+      * @param generations Number of generations to compute
+      */
+     void runHeadless(int generations);
+     
      /**
       * @brief Update the game state for one generation
       */
      void update();
      
      /**
-      * @brief Draw the current game state
+      * @brief Set the rule used by update()
+      *
+      * Common rules (Conway, HighLife, Day & Night, Seeds) use a stepping
+      * kernel specialized at compile time; all others use the generic kernel
+      * with the rule's lookup table.
+      * @param rule The rule
+      */
+     void setRule(const Rule& rule);
+     
+     /**
+      * @brief Get the rule used by update()
+      * @return The rule
+      */
+     const Rule& getRule() const { return rule_; }
+     
+     /**
+      * @brief Check whether the current rule has a specialized kernel
+      * @return true if update() uses a compile-time specialized kernel
+      */
+     bool hasSpecializedKernel() const;
+     
+     /**
+      * @brief Count the live cells
+      * @return The number of live cells
+      */
+     long long getPopulation() const;
+     
+     /**
+      * @brief Set the delay between two generations in run()
+      * @param milliseconds Delay in milliseconds, 0 runs as fast as possible
+      */
+     void setStepDelay(int milliseconds);
+     
+     /**
+      * @brief Get the height of the game grid
+      * @return The number of rows
+      */
+     int getHeight() const { return height_; }
+     
+     /**
+      * @brief Get the width of the game grid
+      * @return The number of columns
+      */
+     int getWidth() const { return width_; }
+     
+     /**
+      * @brief Get the current generation count
+      * @return The number of generations computed since the last reset
+      */
+     long long getGeneration() const { return generation_; }
+     
+     /**
+      * @brief Set the generation count (used when restoring a checkpoint)
+      * @param generation The generation count
+      */
+     void setGeneration(long long generation) { generation_ = generation; }
+     
+     /**
+      * @brief Get the state of the random number generator
+      * @return The generator state in text form
+      */
+     std::string getRngState() const;
+     
+     /**
+      * @brief Restore the state of the random number generator
+      * @param state A state returned by getRngState()
+      * @return true if the state was valid
+      */
+     bool setRngState(const std::string& state);
+     
+     /**
+      * @brief Check whether a cell is alive
+      * @param row The row of the cell
+      * @param col The column of the cell
+      * @return true if the cell is alive
+      */
+     bool isAlive(int row, int col) const { return grid_[cellIndex(row, col)] != 0; }
+     
+     /**
+      * @brief Get direct read access to one row of the grid
+      * @param row The row
+      * @return Pointer to getWidth() cells, 1 = alive, 0 = dead
+      */
+     const unsigned char* rowData(int row) const { return &grid_[cellIndex(row, 0)]; }
+     
+     /**
+      * @brief Get direct read access to the whole grid
+      * @return Pointer to getHeight() * getWidth() cells, row after row
       */
-     void draw();
+     const unsigned char* cellData() const { return grid_.data(); }
+     
+     /**
+      * @brief Get direct write access to the whole grid
+      * @return Pointer to getHeight() * getWidth() cells; store only 0 or 1
+      */
+     unsigned char* cellData() { return grid_.data(); }
      
      /**
       * @brief Save the current game state as a BMP image
@@ -69,47 +199,71 @@
       * @return true if the save was successful, false otherwise
       */
      bool saveAsBMP(const std::string& filename);
- 
- private:
+     
      /**
-      * @brief Initialize ncurses settings
+      * @brief Save the current game state using the snapshot options
+      * @param filename The name of the file to save to
+      * @return true if the save was successful, false otherwise
       */
-     void initNCurses();
+     bool saveSnapshot(const std::string& filename) const;
      
      /**
-      * @brief Count the number of live neighbors for a cell
-      * @param row The row of the cell
-      * @param col The column of the cell
-      * @return The number of live neighbors
+      * @brief Set the format and scale used by saveSnapshot() and the 's' key
+      * @param options The snapshot options
       */
-     int countNeighbors(int row, int col);
+     void setSnapshotOptions(const SnapshotOptions& options) { snapshotOptions_ = options; }
      
      /**
-      * @brief Generate a timestamp string for filenames
-      * @return A string containing the current timestamp
+      * @brief Get the snapshot options
+      * @return The snapshot options
       */
-     std::string generateTimestamp();
+     const SnapshotOptions& getSnapshotOptions() const { return snapshotOptions_; }
      
      /**
-      * @brief Write BMP file header
-      * @param file The file to write to
-      * @param width The width of the image
-      * @param height The height of the image
+      * @brief Attach a time-lapse recorder that is offered every generation
+      * @param recorder The recorder, or nullptr to detach; not owned
       */
-     void writeBMPHeader(std::ofstream& file, int width, int height);
+     void setTimeLapse(TimeLapseRecorder* recorder) { timeLapse_ = recorder; }
      
      /**
-      * @brief Write BMP image data
-      * @param file The file to write to
+      * @brief Attach a checkpoint writer that is offered every generation
+      *
+      * While run() is active the 'c' key also requests a checkpoint.
+      * @param writer The writer, or nullptr to detach; not owned
       */
-     void writeBMPData(std::ofstream& file);
+     void setCheckpointWriter(CheckpointWriter* writer) { checkpoint_ = writer; }
  
+ private:
+     /**
+      * @brief Get the index of a cell in the row-major grid storage
+      * @param row The row of the cell
+      * @param col The column of the cell
+      * @return The index into grid_
+      */
+     size_t cellIndex(int row, int col) const {
+         return static_cast<size_t>(row) * width_ + col;
+     }
+     
+     /**
+      * @brief Generate a timestamp string for filenames
+      * @return A string containing the current timestamp
+      */
+     std::string generateTimestamp();
+     
      int height_; ///< Height of the game grid
      int width_;  ///< Width of the game grid
-     std::vector<std::vector<bool>> grid_; ///< Current state of the game grid
-     std::vector<std::vector<bool>> nextGrid_; ///< Next state of the game grid
+     std::vector<unsigned char> grid_; ///< Current state of the game grid (row-major, 1 = alive)
+     std::vector<unsigned char> nextGrid_; ///< Next state of the game grid
      bool running_; ///< Flag indicating if the game is running
-     int generation_; ///< Current generation count
+     long long generation_; ///< Current generation count
+     int stepDelayMs_; ///< Delay between generations in run()
+     SnapshotOptions snapshotOptions_; ///< Format used when saving snapshots
+     TimeLapseRecorder* timeLapse_; ///< Optional time-lapse recorder (not owned)
+     CheckpointWriter* checkpoint_; ///< Optional checkpoint writer (not owned)
+     std::mt19937_64 rng_; ///< Random number generator, saved in checkpoints
+     Rule rule_; ///< Rule applied by update()
+     /// Stepping kernel for rule_: (current, next, height, width, lookup table)
+     void (*kernel_)(const unsigned char*, unsigned char*, int, int, const unsigned char*);
  };
  
  #endif // GAME_OF_LIFE_H
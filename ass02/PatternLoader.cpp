@@ -0,0 +1,433 @@
+#include "PatternLoader.h"
+#include "GameOfLife.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+/**
+ * Buffered byte reader, so the parsers can work one character at a time
+ * without holding the whole file in memory.
+ */
+class StreamReader {
+public:
+    explicit StreamReader(std::ifstream& file) : file_(file), pos_(0), end_(0) {}
+
+    int peek() {
+        if (pos_ == end_ && !fill()) return EOF;
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+
+    int get() {
+        if (pos_ == end_ && !fill()) return EOF;
+        return static_cast<unsigned char>(buffer_[pos_++]);
+    }
+
+    void skipLine() {
+        int c;
+        while ((c = get()) != EOF && c != '\n') {}
+    }
+
+    // Read one line without the line terminator; false at end of file
+    bool readLine(std::string& line) {
+        line.clear();
+        int c = get();
+        if (c == EOF) return false;
+        while (c != EOF && c != '\n') {
+            if (c != '\r') line += static_cast<char>(c);
+            c = get();
+        }
+        return true;
+    }
+
+    // Read an optionally signed decimal integer, skipping blanks before it
+    bool readInteger(long long& value) {
+        int c = peek();
+        while (c == ' ' || c == '\t') {
+            get();
+            c = peek();
+        }
+        bool negative = false;
+        if (c == '-' || c == '+') {
+            negative = (c == '-');
+            get();
+            c = peek();
+        }
+        if (c < '0' || c > '9') return false;
+        value = 0;
+        while (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            get();
+            c = peek();
+        }
+        if (negative) value = -value;
+        return true;
+    }
+
+private:
+    bool fill() {
+        file_.read(buffer_, sizeof(buffer_));
+        end_ = static_cast<size_t>(file_.gcount());
+        pos_ = 0;
+        return end_ > 0;
+    }
+
+    std::ifstream& file_;
+    char buffer_[1 << 16];
+    size_t pos_;
+    size_t end_;
+};
+
+bool startsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, std::string(prefix).size(), prefix) == 0;
+}
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Parse an RLE header line such as "x = 3, y = 3, rule = B3/S23"
+bool parseRLEHeader(const std::string& line, PatternInfo& info) {
+    bool haveX = false, haveY = false;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t comma = line.find(',', pos);
+        if (comma == std::string::npos) comma = line.size();
+        std::string item = line.substr(pos, comma - pos);
+        size_t eq = item.find('=');
+        if (eq != std::string::npos) {
+            std::string key = trim(item.substr(0, eq));
+            std::string value = trim(item.substr(eq + 1));
+            if (key == "x") {
+                info.width = std::strtoll(value.c_str(), nullptr, 10);
+                haveX = true;
+            } else if (key == "y") {
+                info.height = std::strtoll(value.c_str(), nullptr, 10);
+                haveY = true;
+            } else if (key == "rule") {
+                info.rule = value;
+            }
+        }
+        pos = comma + 1;
+    }
+    return haveX && haveY && info.width >= 0 && info.height >= 0;
+}
+
+bool loadRLE(StreamReader& in, std::string line, GameOfLife& game,
+             PatternInfo& info, std::string& error) {
+    info.format = "RLE";
+
+    // Skip comment lines until the header line
+    while (line.empty() || line[0] == '#') {
+        if (!in.readLine(line)) {
+            error = "missing RLE header line";
+            return false;
+        }
+        line = trim(line);
+    }
+    if (!parseRLEHeader(line, info)) {
+        error = "invalid RLE header: " + line;
+        return false;
+    }
+
+    // Center the bounding box on the grid
+    const long long startRow = (game.getHeight() - info.height) / 2;
+    const long long startCol = (game.getWidth() - info.width) / 2;
+
+    long long row = 0, col = 0, count = 0;
+    for (;;) {
+        int c = in.get();
+        if (c == EOF || c == '!') break;
+        if (c >= '0' && c <= '9') {
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        long long n = count > 0 ? count : 1;
+        count = 0;
+        switch (c) {
+            case 'b':
+            case '.':
+                col += n;
+                break;
+            case '$':
+                row += n;
+                col = 0;
+                break;
+            case ' ':
+            case '\t':
+            case '\r':
+            case '\n':
+                break;
+            case '#':
+                in.skipLine();
+                break;
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+                    // 'o' is a live cell; other letters are states of
+                    // multi-state rules and are treated as alive
+                    info.liveCells += game.setRun(startRow + row, startCol + col, n);
+                    col += n;
+                } else {
+                    error = std::string("unexpected character '") + static_cast<char>(c) +
+                            "' in RLE data";
+                    return false;
+                }
+                break;
+        }
+        // Nothing below the grid can be placed, stop reading early
+        if (startRow + row >= game.getHeight()) break;
+    }
+    return true;
+}
+
+bool loadLife106(StreamReader& in, GameOfLife& game, PatternInfo& info, std::string& error) {
+    info.format = "Life 1.06";
+
+    // Coordinates are relative to the pattern origin, which goes to the grid center
+    const long long originRow = game.getHeight() / 2;
+    const long long originCol = game.getWidth() / 2;
+    long long minX = 0, maxX = -1, minY = 0, maxY = -1;
+
+    for (;;) {
+        int c = in.peek();
+        if (c == EOF) break;
+        if (c == '#') {
+            in.skipLine();
+            continue;
+        }
+        long long x, y;
+        if (!in.readInteger(x)) {
+            // Blank line or trailing whitespace
+            in.skipLine();
+            continue;
+        }
+        if (!in.readInteger(y)) {
+            error = "invalid coordinate line in Life 1.06 file";
+            return false;
+        }
+        in.skipLine();
+
+        if (maxX < minX) {
+            minX = maxX = x;
+            minY = maxY = y;
+        } else {
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (y < minY) minY = y;
+            if (y > maxY) maxY = y;
+        }
+        info.liveCells += game.setRun(originRow + y, originCol + x, 1);
+    }
+
+    if (maxX >= minX) {
+        info.width = maxX - minX + 1;
+        info.height = maxY - minY + 1;
+    }
+    return true;
+}
+
+/**
+ * Node of a macrocell quadtree. Level 3 nodes are 8x8 leaves stored as one
+ * byte per row; higher levels refer to four children of the level below.
+ */
+struct MacroNode {
+    int level;
+    long long child[4];      // nw, ne, sw, se; 0 is the empty node
+    unsigned char rows[8];   // leaf rows, bit c = column c
+    bool empty;
+    long long top, left, bottom, right; // bounding box of live cells
+};
+
+class MacrocellEmitter {
+public:
+    MacrocellEmitter(const std::vector<MacroNode>& nodes, GameOfLife& game)
+        : nodes_(nodes), game_(game), placed_(0) {}
+
+    void emit(long long id, long long rowOff, long long colOff) {
+        if (id == 0) return;
+        const MacroNode& node = nodes_[id];
+        // Skip nodes whose live cells fall completely outside the grid
+        if (node.empty ||
+            rowOff + node.bottom < 0 || rowOff + node.top >= game_.getHeight() ||
+            colOff + node.right < 0 || colOff + node.left >= game_.getWidth()) {
+            return;
+        }
+        if (node.level == 3) {
+            for (int r = 0; r < 8; r++) {
+                unsigned bits = node.rows[r];
+                int c = 0;
+                while (bits) {
+                    // Emit each run of set bits as one call
+                    while (!(bits & 1u)) {
+                        bits >>= 1;
+                        c++;
+                    }
+                    int start = c;
+                    while (bits & 1u) {
+                        bits >>= 1;
+                        c++;
+                    }
+                    placed_ += game_.setRun(rowOff + r, colOff + start, c - start);
+                }
+            }
+            return;
+        }
+        long long half = 1LL << (node.level - 1);
+        emit(node.child[0], rowOff, colOff);
+        emit(node.child[1], rowOff, colOff + half);
+        emit(node.child[2], rowOff + half, colOff);
+        emit(node.child[3], rowOff + half, colOff + half);
+    }
+
+    long long placed() const { return placed_; }
+
+private:
+    const std::vector<MacroNode>& nodes_;
+    GameOfLife& game_;
+    long long placed_;
+};
+
+bool loadMacrocell(StreamReader& in, GameOfLife& game, PatternInfo& info, std::string& error) {
+    info.format = "Macrocell";
+
+    // Node 0 is the empty node; children always precede their parents
+    std::vector<MacroNode> nodes(1);
+    nodes[0].level = 0;
+    nodes[0].empty = true;
+
+    std::string line;
+    while (in.readLine(line)) {
+        if (line.empty()) continue;
+        if (line[0] == '#') {
+            if (startsWith(line, "#R")) info.rule = trim(line.substr(2));
+            continue;
+        }
+
+        MacroNode node = MacroNode();
+        node.empty = true;
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$') {
+            // 8x8 leaf: '.' dead, '*' alive, '$' ends a row
+            node.level = 3;
+            int r = 0, c = 0;
+            for (size_t i = 0; i < line.size() && r < 8; i++) {
+                char ch = line[i];
+                if (ch == '$') {
+                    r++;
+                    c = 0;
+                } else if (ch == '.' || ch == '*') {
+                    if (c >= 8) {
+                        error = "macrocell leaf row longer than 8 cells";
+                        return false;
+                    }
+                    if (ch == '*') {
+                        node.rows[r] |= static_cast<unsigned char>(1u << c);
+                        if (node.empty) {
+                            node.top = node.bottom = r;
+                            node.left = node.right = c;
+                            node.empty = false;
+                        } else {
+                            if (r > node.bottom) node.bottom = r;
+                            if (c < node.left) node.left = c;
+                            if (c > node.right) node.right = c;
+                        }
+                    }
+                    c++;
+                }
+            }
+        } else {
+            // Inner node: "level nw ne sw se"
+            long long level = 0;
+            if (std::sscanf(line.c_str(), "%lld %lld %lld %lld %lld", &level, &node.child[0],
+                            &node.child[1], &node.child[2], &node.child[3]) != 5) {
+                error = "invalid macrocell node line: " + line;
+                return false;
+            }
+            if (level < 4 || level > 62) {
+                error = "unsupported macrocell node level";
+                return false;
+            }
+            node.level = static_cast<int>(level);
+            long long half = 1LL << (level - 1);
+            for (int q = 0; q < 4; q++) {
+                long long id = node.child[q];
+                if (id < 0 || id >= static_cast<long long>(nodes.size()) ||
+                    (id != 0 && nodes[id].level != node.level - 1)) {
+                    error = "invalid macrocell child reference";
+                    return false;
+                }
+                const MacroNode& child = nodes[id];
+                if (id == 0 || child.empty) continue;
+                long long dr = (q >= 2) ? half : 0;
+                long long dc = (q & 1) ? half : 0;
+                if (node.empty) {
+                    node.top = child.top + dr;
+                    node.bottom = child.bottom + dr;
+                    node.left = child.left + dc;
+                    node.right = child.right + dc;
+                    node.empty = false;
+                } else {
+                    if (child.top + dr < node.top) node.top = child.top + dr;
+                    if (child.bottom + dr > node.bottom) node.bottom = child.bottom + dr;
+                    if (child.left + dc < node.left) node.left = child.left + dc;
+                    if (child.right + dc > node.right) node.right = child.right + dc;
+                }
+            }
+        }
+        nodes.push_back(node);
+    }
+
+    // The last node is the root
+    const MacroNode& root = nodes.back();
+    if (nodes.size() == 1 || root.empty) {
+        return true;
+    }
+    info.width = root.right - root.left + 1;
+    info.height = root.bottom - root.top + 1;
+
+    // Center the bounding box of the live cells on the grid
+    long long rowOff = (game.getHeight() - info.height) / 2 - root.top;
+    long long colOff = (game.getWidth() - info.width) / 2 - root.left;
+    MacrocellEmitter emitter(nodes, game);
+    emitter.emit(static_cast<long long>(nodes.size()) - 1, rowOff, colOff);
+    info.liveCells = emitter.placed();
+    return true;
+}
+
+} // namespace
+
+bool PatternLoader::load(const std::string& filename, GameOfLife& game,
+                         PatternInfo& info, std::string& error) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    info = PatternInfo();
+    game.clear();
+
+    StreamReader in(file);
+    std::string first;
+    if (!in.readLine(first)) {
+        error = filename + " is empty";
+        return false;
+    }
+    first = trim(first);
+
+    if (startsWith(first, "#Life 1.06")) {
+        return loadLife106(in, game, info, error);
+    }
+    if (startsWith(first, "[M2]")) {
+        return loadMacrocell(in, game, info, error);
+    }
+    if (startsWith(first, "#Life")) {
+        error = "unsupported Life format: " + first;
+        return false;
+    }
+    return loadRLE(in, first, game, info, error);
+}
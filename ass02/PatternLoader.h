@@ -0,0 +1,62 @@
+/**
+ * @file PatternLoader.h
+ * @brief Streaming loader for RLE, Life 1.06 and macrocell pattern files
+ * @author Your Name
+ * @date March 2025
+ */
+
+ #ifndef PATTERN_LOADER_H
+ #define PATTERN_LOADER_H
+
+ #include <string>
+
+ class GameOfLife;
+
+ /**
+  * @struct PatternInfo
+  * @brief Information about a loaded pattern
+  */
+ struct PatternInfo {
+     std::string format;   ///< File format ("RLE", "Life 1.06" or "Macrocell")
+     std::string rule;     ///< Rule given in the file, empty if none
+     long long width;      ///< Width of the pattern bounding box
+     long long height;     ///< Height of the pattern bounding box
+     long long liveCells;  ///< Live cells placed on the grid (after clipping)
+
+     PatternInfo() : width(0), height(0), liveCells(0) {}
+ };
+
+ /**
+  * @class PatternLoader
+  * @brief Loads community pattern files directly into a GameOfLife grid
+  *
+  * Files are parsed while they are read, in fixed-size chunks, and live cells
+  * are written straight into the grid as horizontal runs. No dense copy of
+  * the pattern is ever built, so the cost depends on the file size and the
+  * part of the pattern that lands on the grid, not on the pattern area.
+  *
+  * Placement depends on the format. For RLE and macrocell the pattern's
+  * bounding box is centered on the grid, like GameOfLife::initializePattern().
+  * Life 1.06 coordinates are relative to the pattern origin, which is put at
+  * the grid center, so the bounding box is centered only if the file is.
+  * Cells falling outside the grid are dropped.
+  */
+ class PatternLoader {
+ public:
+     /**
+      * @brief Load a pattern file into a game, replacing its current state
+      *
+      * The format is detected from the file contents: files starting with
+      * "#Life 1.06" are Life 1.06, files starting with "[M2]" are macrocell,
+      * anything else is parsed as RLE.
+      * @param filename The file to load
+      * @param game The game to load into
+      * @param info Receives information about the pattern
+      * @param error Receives a description of the problem if loading fails
+      * @return true if the pattern was loaded, false otherwise
+      */
+     static bool load(const std::string& filename, GameOfLife& game,
+                      PatternInfo& info, std::string& error);
+ };
+
+ #endif // PATTERN_LOADER_H
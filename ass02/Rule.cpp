@@ -0,0 +1,111 @@
+#include "Rule.h"
+#include <cctype>
+
+namespace {
+
+struct NamedRule {
+    const char* name;
+    unsigned birth;
+    unsigned survival;
+};
+
+// Masks: bit n stands for n live neighbors
+const NamedRule kNamedRules[] = {
+    {"conway",      1u << 3,                                   (1u << 2) | (1u << 3)},
+    {"life",        1u << 3,                                   (1u << 2) | (1u << 3)},
+    {"highlife",    (1u << 3) | (1u << 6),                     (1u << 2) | (1u << 3)},
+    {"dayandnight", (1u << 3) | (1u << 6) | (1u << 7) | (1u << 8),
+                    (1u << 3) | (1u << 4) | (1u << 6) | (1u << 7) | (1u << 8)},
+    {"seeds",       1u << 2,                                   0u},
+};
+
+std::string lowercase(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == ' ' || c == '\t' || c == '&' || c == '_' || c == '-') continue;
+        out += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+// Parse a run of digits 0-8 into a mask
+bool parseDigits(const std::string& s, unsigned& mask) {
+    mask = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] < '0' || s[i] > '8') return false;
+        mask |= 1u << (s[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+Rule::Rule() : birth_(1u << 3), survival_((1u << 2) | (1u << 3)), packed_(0) {
+    compile();
+}
+
+Rule::Rule(unsigned birthMask, unsigned survivalMask)
+    : birth_(birthMask & 0x1FF), survival_(survivalMask & 0x1FF), packed_(0) {
+    compile();
+}
+
+void Rule::compile() {
+    packed_ = packRuleTable(birth_, survival_);
+    for (unsigned n = 0; n <= 8; n++) {
+        table_[n * 2 + 0] = static_cast<unsigned char>((birth_ >> n) & 1u);
+        table_[n * 2 + 1] = static_cast<unsigned char>((survival_ >> n) & 1u);
+    }
+}
+
+bool Rule::parse(const std::string& text, Rule& rule, std::string& error) {
+    std::string s = lowercase(text);
+
+    // Drop a bounded-grid suffix such as ":T100,100"; the grid is always a torus here
+    size_t colon = s.find(':');
+    if (colon != std::string::npos) s = s.substr(0, colon);
+
+    for (size_t i = 0; i < sizeof(kNamedRules) / sizeof(kNamedRules[0]); i++) {
+        if (s == kNamedRules[i].name) {
+            rule = Rule(kNamedRules[i].birth, kNamedRules[i].survival);
+            return true;
+        }
+    }
+
+    size_t slash = s.find('/');
+    if (slash == std::string::npos) {
+        error = "rule must have the form B.../S...: " + text;
+        return false;
+    }
+    std::string first = s.substr(0, slash);
+    std::string second = s.substr(slash + 1);
+
+    unsigned birth = 0, survival = 0;
+    bool ok;
+    if (!first.empty() && first[0] == 'b' && !second.empty() && second[0] == 's') {
+        ok = parseDigits(first.substr(1), birth) && parseDigits(second.substr(1), survival);
+    } else if (!first.empty() && first[0] == 's' && !second.empty() && second[0] == 'b') {
+        ok = parseDigits(first.substr(1), survival) && parseDigits(second.substr(1), birth);
+    } else {
+        // Old notation "survival/birth", e.g. "23/3"
+        ok = parseDigits(first, survival) && parseDigits(second, birth);
+    }
+    if (!ok) {
+        error = "invalid neighbor count in rule: " + text;
+        return false;
+    }
+    rule = Rule(birth, survival);
+    return true;
+}
+
+std::string Rule::toString() const {
+    std::string s = "B";
+    for (unsigned n = 0; n <= 8; n++) {
+        if (birth_ & (1u << n)) s += static_cast<char>('0' + n);
+    }
+    s += "/S";
+    for (unsigned n = 0; n <= 8; n++) {
+        if (survival_ & (1u << n)) s += static_cast<char>('0' + n);
+    }
+    return s;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file Rule.h
+ * @brief Outer-totalistic Life-like rules in B/S notation
+ * @author Your Name
+ * @date March 2025
+ */
+
+ #ifndef RULE_H
+ #define RULE_H
+
+ #include <string>
+
+ /**
+  * @class Rule
+  * @brief A Life-like rule compiled into a lookup table
+  *
+  * A rule says for which neighbor counts a dead cell is born (B) and a live
+  * cell survives (S), e.g. "B3/S23" for Conway's Game of Life or "B36/S23"
+  * for HighLife. The rule is compiled into a table indexed by
+  * (neighbors * 2 + alive), so the next state of a cell is a single lookup
+  * without branches.
+  */
+ class Rule {
+ public:
+     /**
+      * @brief Create Conway's rule B3/S23
+      */
+     Rule();
+
+     /**
+      * @brief Create a rule from neighbor-count bit masks
+      * @param birthMask Bit n set if a dead cell with n neighbors is born
+      * @param survivalMask Bit n set if a live cell with n neighbors survives
+      */
+     Rule(unsigned birthMask, unsigned survivalMask);
+
+     /**
+      * @brief Parse a rule string
+      *
+      * Accepts "B3/S23" (any case, either order), the older "S/B" form
+      * "23/3", and the names "Conway", "HighLife", "DayAndNight" and
+      * "Seeds". A Golly bounded-grid suffix such as ":T100,100" is ignored.
+      * @param text The rule string
+      * @param rule Receives the parsed rule
+      * @param error Receives a description of the problem on failure
+      * @return true if the string was a valid rule
+      */
+     static bool parse(const std::string& text, Rule& rule, std::string& error);
+
+     /**
+      * @brief Format the rule in B/S notation
+      * @return The rule string, e.g. "B3/S23"
+      */
+     std::string toString() const;
+
+     /**
+      * @brief Get the birth mask
+      * @return Bit n set if a dead cell with n neighbors is born
+      */
+     unsigned birthMask() const { return birth_; }
+
+     /**
+      * @brief Get the survival mask
+      * @return Bit n set if a live cell with n neighbors survives
+      */
+     unsigned survivalMask() const { return survival_; }
+
+     /**
+      * @brief Get the compiled lookup table
+      * @return 18 entries, indexed by neighbors * 2 + alive, holding 0 or 1
+      */
+     const unsigned char* table() const { return table_; }
+
+     /**
+      * @brief Get the lookup table packed into the bits of one integer
+      * @return Bit (neighbors * 2 + alive) holds the next state
+      */
+     unsigned packedTable() const { return packed_; }
+
+     /**
+      * @brief Get the next state of a cell
+      * @param alive 1 if the cell is alive, 0 otherwise
+      * @param neighbors Number of live neighbors (0 to 8)
+      * @return 1 if the cell is alive in the next generation, 0 otherwise
+      */
+     unsigned char next(unsigned alive, unsigned neighbors) const {
+         return table_[neighbors * 2 + alive];
+     }
+
+     bool operator==(const Rule& other) const {
+         return birth_ == other.birth_ && survival_ == other.survival_;
+     }
+
+     bool operator!=(const Rule& other) const { return !(*this == other); }
+
+ private:
+     /**
+      * @brief Build the lookup tables from the masks
+      */
+     void compile();
+
+     unsigned birth_;     ///< Birth neighbor counts (bit mask)
+     unsigned survival_;  ///< Survival neighbor counts (bit mask)
+     unsigned packed_;    ///< Lookup table packed into bits
+     unsigned char table_[18]; ///< Lookup table, index = neighbors * 2 + alive
+ };
+
+ /**
+  * @brief Pack birth/survival masks the same way as Rule::packedTable()
+  *
+  * Usable in constant expressions, so stepping kernels for common rules can
+  * be specialized at compile time.
+  * @param birthMask Bit n set if a dead cell with n neighbors is born
+  * @param survivalMask Bit n set if a live cell with n neighbors survives
+  * @param n Neighbor count to start at (used for the recursion)
+  * @return The packed table
+  */
+ constexpr unsigned packRuleTable(unsigned birthMask, unsigned survivalMask, unsigned n = 0) {
+     return n > 8 ? 0u
+                  : (((birthMask >> n) & 1u) << (2 * n)) |
+                        (((survivalMask >> n) & 1u) << (2 * n + 1)) |
+                        packRuleTable(birthMask, survivalMask, n + 1);
+ }
+
+ #endif // RULE_H
@@ -0,0 +1,601 @@
+#include "Snapshot.h"
+#include "GameOfLife.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+void putLE16(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+}
+
+void putLE32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+void putBE32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v >> 24);
+    p[1] = static_cast<unsigned char>(v >> 16);
+    p[2] = static_cast<unsigned char>(v >> 8);
+    p[3] = static_cast<unsigned char>(v);
+}
+
+// Write the 14-byte file header and 40-byte info header of a BMP file
+void writeBMPHeaders(std::ofstream& file, int width, int height, int bitsPerPixel,
+                     int paletteEntries, uint32_t rowSize) {
+    uint32_t dataOffset = 54 + 4 * paletteEntries;
+    uint32_t imageSize = rowSize * static_cast<uint32_t>(height);
+
+    unsigned char header[54] = {0};
+    header[0] = 'B';
+    header[1] = 'M';
+    putLE32(header + 2, dataOffset + imageSize);   // File size in bytes
+    putLE32(header + 10, dataOffset);              // Offset to start of pixel data
+    putLE32(header + 14, 40);                      // Info header size
+    putLE32(header + 18, static_cast<uint32_t>(width));
+    putLE32(header + 22, static_cast<uint32_t>(height));
+    putLE16(header + 26, 1);                       // Number of color planes
+    putLE16(header + 28, static_cast<uint32_t>(bitsPerPixel));
+    putLE32(header + 34, imageSize);               // Image size
+    putLE32(header + 46, static_cast<uint32_t>(paletteEntries));
+    file.write(reinterpret_cast<char*>(header), sizeof(header));
+}
+
+// CRC-32 lookup table, built once (thread-safe static initialization)
+struct Crc32Table {
+    uint32_t entries[256];
+
+    Crc32Table() {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size) {
+    static const Crc32Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * Writes one PNG chunk whose payload is streamed in pieces; the length has
+ * to be known in advance.
+ */
+class PngChunk {
+public:
+    PngChunk(std::ofstream& file, const char* type, uint32_t length) : file_(file), crc_(0) {
+        unsigned char head[8];
+        putBE32(head, length);
+        std::memcpy(head + 4, type, 4);
+        file_.write(reinterpret_cast<char*>(head), 8);
+        crc_ = crc32Update(crc_, head + 4, 4);
+    }
+
+    void write(const unsigned char* data, size_t size) {
+        file_.write(reinterpret_cast<const char*>(data), size);
+        crc_ = crc32Update(crc_, data, size);
+    }
+
+    void finish() {
+        unsigned char tail[4];
+        putBE32(tail, crc_);
+        file_.write(reinterpret_cast<char*>(tail), 4);
+    }
+
+private:
+    std::ofstream& file_;
+    uint32_t crc_;
+};
+
+/**
+ * zlib stream made of stored (uncompressed) deflate blocks, which needs no
+ * compression library and has a size that is known before writing.
+ */
+class StoredZlibStream {
+public:
+    static const size_t kBlockSize = 65535;
+
+    static uint32_t encodedSize(size_t rawSize) {
+        size_t blocks = rawSize == 0 ? 1 : (rawSize + kBlockSize - 1) / kBlockSize;
+        return static_cast<uint32_t>(2 + blocks * 5 + rawSize + 4);
+    }
+
+    StoredZlibStream(PngChunk& chunk, size_t rawSize)
+        : chunk_(chunk), remaining_(rawSize), finalWritten_(false), adlerA_(1), adlerB_(0) {
+        const unsigned char header[2] = {0x78, 0x01};
+        chunk_.write(header, 2);
+        block_.reserve(kBlockSize);
+    }
+
+    void write(const unsigned char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            adlerA_ = (adlerA_ + data[i]) % 65521;
+            adlerB_ = (adlerB_ + adlerA_) % 65521;
+        }
+        while (size > 0) {
+            size_t n = std::min(size, kBlockSize - block_.size());
+            block_.insert(block_.end(), data, data + n);
+            data += n;
+            size -= n;
+            if (block_.size() == kBlockSize) flushBlock();
+        }
+    }
+
+    void finish() {
+        // An empty stream still needs one (empty) final block; otherwise the
+        // final block may already have been written by write()
+        if (!block_.empty() || !finalWritten_) flushBlock();
+        unsigned char adler[4];
+        putBE32(adler, (adlerB_ << 16) | adlerA_);
+        chunk_.write(adler, 4);
+    }
+
+private:
+    void flushBlock() {
+        size_t n = block_.size();
+        remaining_ -= n;
+        unsigned char head[5];
+        finalWritten_ = remaining_ == 0;
+        head[0] = finalWritten_ ? 1 : 0; // BFINAL, BTYPE = 00 (stored)
+        putLE16(head + 1, static_cast<uint32_t>(n));
+        putLE16(head + 3, static_cast<uint32_t>(~n & 0xFFFF));
+        chunk_.write(head, 5);
+        chunk_.write(block_.data(), n);
+        block_.clear();
+    }
+
+    PngChunk& chunk_;
+    size_t remaining_;
+    bool finalWritten_;
+    std::vector<unsigned char> block_;
+    uint32_t adlerA_;
+    uint32_t adlerB_;
+};
+
+/**
+ * GIF variable-length LZW encoder for 1-bit pixels, emitting codes LSB first.
+ */
+class GifLzwEncoder {
+public:
+    explicit GifLzwEncoder(std::vector<unsigned char>& out) : out_(out), acc_(0), bits_(0) {}
+
+    void encode(const SnapshotFrame& frame) {
+        const int minCodeSize = 2;
+        const int clearCode = 1 << minCodeSize;
+        int codeSize = minCodeSize + 1;
+        int maxCode = clearCode + 1;
+        std::vector<uint16_t> tree(4096 * 2, 0); // child codes, indexed by code * 2 + pixel
+
+        put(clearCode, codeSize);
+        int cur = -1;
+        const size_t count = frame.pixels.size();
+        for (size_t i = 0; i < count; i++) {
+            int pixel = frame.pixels[i] ? 1 : 0;
+            if (cur < 0) {
+                cur = pixel;
+                continue;
+            }
+            uint16_t next = tree[cur * 2 + pixel];
+            if (next) {
+                cur = next;
+                continue;
+            }
+            put(cur, codeSize);
+            tree[cur * 2 + pixel] = static_cast<uint16_t>(++maxCode);
+            if (maxCode >= (1 << codeSize)) codeSize++;
+            if (maxCode == 4095) {
+                // Dictionary full: start over
+                put(clearCode, codeSize);
+                std::fill(tree.begin(), tree.end(), 0);
+                codeSize = minCodeSize + 1;
+                maxCode = clearCode + 1;
+            }
+            cur = pixel;
+        }
+        if (cur >= 0) {
+            put(cur, codeSize);
+            // The decoder adds one more entry after reading the last code and
+            // widens its codes if that fills the current width
+            if (maxCode + 1 >= (1 << codeSize) && codeSize < 12) codeSize++;
+        }
+        put(clearCode, codeSize);
+        put(clearCode + 1, minCodeSize + 1);
+        if (bits_ > 0) out_.push_back(static_cast<unsigned char>(acc_));
+    }
+
+private:
+    void put(int code, int size) {
+        acc_ |= static_cast<uint32_t>(code) << bits_;
+        bits_ += size;
+        while (bits_ >= 8) {
+            out_.push_back(static_cast<unsigned char>(acc_ & 0xFF));
+            acc_ >>= 8;
+            bits_ -= 8;
+        }
+    }
+
+    std::vector<unsigned char>& out_;
+    uint32_t acc_;
+    int bits_;
+};
+
+} // namespace
+
+SnapshotFrame Snapshot::capture(const GameOfLife& game, const SnapshotOptions& options) {
+    const int gridHeight = game.getHeight();
+    const int gridWidth = game.getWidth();
+
+    // Pick the scale so the image fits into the requested size
+    int scale = options.scale;
+    if (scale <= 0) {
+        scale = 1;
+        if (options.maxWidth > 0) scale = std::max(scale, (gridWidth + options.maxWidth - 1) / options.maxWidth);
+        if (options.maxHeight > 0) scale = std::max(scale, (gridHeight + options.maxHeight - 1) / options.maxHeight);
+    }
+
+    SnapshotFrame frame;
+    frame.width = (gridWidth + scale - 1) / scale;
+    frame.height = (gridHeight + scale - 1) / scale;
+    frame.binary = (scale == 1);
+    frame.generation = game.getGeneration();
+    frame.pixels.assign(static_cast<size_t>(frame.width) * frame.height, 0);
+
+    if (scale == 1) {
+        for (int r = 0; r < gridHeight; r++) {
+            const unsigned char* src = game.rowData(r);
+            unsigned char* dst = &frame.pixels[static_cast<size_t>(r) * frame.width];
+            for (int c = 0; c < gridWidth; c++) {
+                dst[c] = static_cast<unsigned char>(src[c] * 255);
+            }
+        }
+        return frame;
+    }
+
+    // Density rendering: each pixel shows the share of live cells in its block
+    std::vector<unsigned> sums(frame.width);
+    for (int py = 0; py < frame.height; py++) {
+        std::fill(sums.begin(), sums.end(), 0u);
+        int rowBegin = py * scale;
+        int rowEnd = std::min(rowBegin + scale, gridHeight);
+        for (int r = rowBegin; r < rowEnd; r++) {
+            const unsigned char* src = game.rowData(r);
+            for (int px = 0, c = 0; px < frame.width; px++) {
+                int colEnd = std::min(c + scale, gridWidth);
+                unsigned sum = 0;
+                for (; c < colEnd; c++) sum += src[c];
+                sums[px] += sum;
+            }
+        }
+        unsigned char* dst = &frame.pixels[static_cast<size_t>(py) * frame.width];
+        for (int px = 0; px < frame.width; px++) {
+            unsigned cells = static_cast<unsigned>(rowEnd - rowBegin) *
+                             static_cast<unsigned>(std::min(px * scale + scale, gridWidth) - px * scale);
+            unsigned value = (sums[px] * 255 + cells / 2) / cells;
+            // Keep blocks with any live cell visible in 1-bit output
+            if (sums[px] > 0 && value == 0) value = 1;
+            dst[px] = static_cast<unsigned char>(value);
+        }
+    }
+    return frame;
+}
+
+bool Snapshot::save(const std::string& filename, const GameOfLife& game,
+                    const SnapshotOptions& options) {
+    return write(filename, capture(game, options), options.format);
+}
+
+bool Snapshot::write(const std::string& filename, const SnapshotFrame& frame,
+                     SnapshotFormat format) {
+    if (format == SnapshotFormat::GIF) {
+        return false; // Only used for animations, see GifWriter
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    bool ok = false;
+    switch (format) {
+        case SnapshotFormat::BMP24: ok = writeBMP24(file, frame); break;
+        case SnapshotFormat::BMP1:  ok = writeBMP1(file, frame); break;
+        case SnapshotFormat::PNG:   ok = writePNG(file, frame); break;
+        case SnapshotFormat::GIF:   break;
+    }
+    file.close();
+    return ok && !file.fail();
+}
+
+const char* Snapshot::extension(SnapshotFormat format) {
+    switch (format) {
+        case SnapshotFormat::PNG: return ".png";
+        case SnapshotFormat::GIF: return ".gif";
+        default:                  return ".bmp";
+    }
+}
+
+bool Snapshot::parseFormat(const std::string& name, SnapshotFormat& format) {
+    if (name == "bmp24" || name == "bmp") format = SnapshotFormat::BMP24;
+    else if (name == "bmp1") format = SnapshotFormat::BMP1;
+    else if (name == "png") format = SnapshotFormat::PNG;
+    else if (name == "gif") format = SnapshotFormat::GIF;
+    else return false;
+    return true;
+}
+
+bool Snapshot::writeBMP24(std::ofstream& file, const SnapshotFrame& frame) {
+    uint32_t rowSize = ((static_cast<uint32_t>(frame.width) * 24 + 31) / 32) * 4;
+    writeBMPHeaders(file, frame.width, frame.height, 24, 0, rowSize);
+
+    // Build each row (BGR, padded to 4 bytes) in one buffer and write it at once
+    std::vector<unsigned char> row(rowSize, 0);
+    // BMP stores images bottom-up
+    for (int y = frame.height - 1; y >= 0; y--) {
+        const unsigned char* src = &frame.pixels[static_cast<size_t>(y) * frame.width];
+        for (int x = 0; x < frame.width; x++) {
+            row[3 * x + 1] = src[x]; // Green; blue and red stay 0
+        }
+        file.write(reinterpret_cast<char*>(row.data()), rowSize);
+    }
+    return true;
+}
+
+bool Snapshot::writeBMP1(std::ofstream& file, const SnapshotFrame& frame) {
+    uint32_t rowSize = ((static_cast<uint32_t>(frame.width) + 31) / 32) * 4;
+    writeBMPHeaders(file, frame.width, frame.height, 1, 2, rowSize);
+
+    // Palette (BGRA): 0 = dead (black), 1 = alive (green)
+    const unsigned char palette[8] = {0, 0, 0, 0, 0, 255, 0, 0};
+    file.write(reinterpret_cast<const char*>(palette), sizeof(palette));
+
+    std::vector<unsigned char> row(rowSize);
+    for (int y = frame.height - 1; y >= 0; y--) {
+        const unsigned char* src = &frame.pixels[static_cast<size_t>(y) * frame.width];
+        std::fill(row.begin(), row.end(), 0);
+        for (int x = 0; x < frame.width; x++) {
+            if (src[x]) row[x >> 3] |= static_cast<unsigned char>(0x80 >> (x & 7));
+        }
+        file.write(reinterpret_cast<char*>(row.data()), rowSize);
+    }
+    return true;
+}
+
+bool Snapshot::writePNG(std::ofstream& file, const SnapshotFrame& frame) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), 8);
+
+    // 1-bit palette for one cell per pixel, 8-bit green ramp for densities
+    const int bitDepth = frame.binary ? 1 : 8;
+    unsigned char ihdr[13] = {0};
+    putBE32(ihdr, static_cast<uint32_t>(frame.width));
+    putBE32(ihdr + 4, static_cast<uint32_t>(frame.height));
+    ihdr[8] = static_cast<unsigned char>(bitDepth);
+    ihdr[9] = 3; // Color type: palette
+    PngChunk header(file, "IHDR", sizeof(ihdr));
+    header.write(ihdr, sizeof(ihdr));
+    header.finish();
+
+    std::vector<unsigned char> palette;
+    if (frame.binary) {
+        const unsigned char twoColors[6] = {0, 0, 0, 0, 255, 0};
+        palette.assign(twoColors, twoColors + 6);
+    } else {
+        palette.resize(256 * 3, 0);
+        for (int i = 0; i < 256; i++) palette[3 * i + 1] = static_cast<unsigned char>(i);
+    }
+    PngChunk plte(file, "PLTE", static_cast<uint32_t>(palette.size()));
+    plte.write(palette.data(), palette.size());
+    plte.finish();
+
+    // Scanlines: filter type byte (0 = none) followed by the packed pixels
+    size_t lineBytes = frame.binary ? (static_cast<size_t>(frame.width) + 7) / 8
+                                    : static_cast<size_t>(frame.width);
+    size_t rawSize = (lineBytes + 1) * static_cast<size_t>(frame.height);
+    PngChunk idat(file, "IDAT", StoredZlibStream::encodedSize(rawSize));
+    StoredZlibStream zlib(idat, rawSize);
+    std::vector<unsigned char> line(lineBytes + 1);
+    for (int y = 0; y < frame.height; y++) {
+        const unsigned char* src = &frame.pixels[static_cast<size_t>(y) * frame.width];
+        line[0] = 0;
+        if (frame.binary) {
+            std::fill(line.begin() + 1, line.end(), 0);
+            for (int x = 0; x < frame.width; x++) {
+                if (src[x]) line[1 + (x >> 3)] |= static_cast<unsigned char>(0x80 >> (x & 7));
+            }
+        } else {
+            std::memcpy(&line[1], src, lineBytes);
+        }
+        zlib.write(line.data(), line.size());
+    }
+    zlib.finish();
+    idat.finish();
+
+    PngChunk end(file, "IEND", 0);
+    end.finish();
+    return true;
+}
+
+GifWriter::GifWriter() : width_(0), height_(0) {}
+
+bool GifWriter::open(const std::string& filename, int width, int height) {
+    file_.open(filename, std::ios::binary);
+    if (!file_) {
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+
+    unsigned char header[13] = {'G', 'I', 'F', '8', '9', 'a'};
+    putLE16(header + 6, static_cast<uint32_t>(width));
+    putLE16(header + 8, static_cast<uint32_t>(height));
+    header[10] = 0xF0; // Global color table with 2 entries
+    file_.write(reinterpret_cast<char*>(header), sizeof(header));
+
+    const unsigned char colors[6] = {0, 0, 0, 0, 255, 0};
+    file_.write(reinterpret_cast<const char*>(colors), sizeof(colors));
+
+    // Loop forever
+    const unsigned char loop[19] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+                                    '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+    file_.write(reinterpret_cast<const char*>(loop), sizeof(loop));
+    return !file_.fail();
+}
+
+bool GifWriter::addFrame(const SnapshotFrame& frame, int delayCs) {
+    if (!file_.is_open() || frame.width != width_ || frame.height != height_) {
+        return false;
+    }
+
+    unsigned char control[8] = {0x21, 0xF9, 0x04, 0x00};
+    putLE16(control + 4, static_cast<uint32_t>(delayCs));
+    file_.write(reinterpret_cast<char*>(control), sizeof(control));
+
+    unsigned char descriptor[10] = {0x2C};
+    putLE16(descriptor + 5, static_cast<uint32_t>(width_));
+    putLE16(descriptor + 7, static_cast<uint32_t>(height_));
+    file_.write(reinterpret_cast<char*>(descriptor), sizeof(descriptor));
+
+    std::vector<unsigned char> data;
+    data.reserve(frame.pixels.size() / 8);
+    GifLzwEncoder encoder(data);
+    encoder.encode(frame);
+
+    // LZW minimum code size, then the data in sub-blocks of at most 255 bytes
+    std::vector<unsigned char> blocks;
+    blocks.reserve(data.size() + data.size() / 255 + 3);
+    blocks.push_back(2);
+    for (size_t i = 0; i < data.size(); i += 255) {
+        size_t n = std::min<size_t>(255, data.size() - i);
+        blocks.push_back(static_cast<unsigned char>(n));
+        blocks.insert(blocks.end(), data.begin() + i, data.begin() + i + n);
+    }
+    blocks.push_back(0);
+    file_.write(reinterpret_cast<char*>(blocks.data()), blocks.size());
+    return !file_.fail();
+}
+
+void GifWriter::close() {
+    if (file_.is_open()) {
+        file_.put(0x3B);
+        file_.close();
+    }
+}
+
+TimeLapseRecorder::TimeLapseRecorder(const TimeLapseOptions& options)
+    : options_(options), running_(false), written_(0), dropped_(0), gifOpen_(false) {
+    if (options_.every < 1) options_.every = 1;
+    if (options_.maxQueued < 1) options_.maxQueued = 1;
+}
+
+TimeLapseRecorder::~TimeLapseRecorder() {
+    stop();
+}
+
+bool TimeLapseRecorder::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+    running_ = true;
+    writer_ = std::thread(&TimeLapseRecorder::writerLoop, this);
+    return true;
+}
+
+void TimeLapseRecorder::capture(const GameOfLife& game) {
+    if (game.getGeneration() % options_.every != 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        // Never wait for the writer: drop the frame if it is too far behind
+        if (queue_.size() >= options_.maxQueued) {
+            dropped_++;
+            return;
+        }
+    }
+
+    SnapshotFrame frame = Snapshot::capture(game, options_.snapshot);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(frame));
+    }
+    wake_.notify_one();
+}
+
+void TimeLapseRecorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_one();
+    writer_.join();
+    if (gifOpen_) {
+        gif_.close();
+        gifOpen_ = false;
+    }
+}
+
+unsigned long TimeLapseRecorder::framesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+unsigned long TimeLapseRecorder::framesDropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void TimeLapseRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return !queue_.empty() || !running_; });
+        if (queue_.empty()) {
+            break; // Stopped and everything is written
+        }
+        SnapshotFrame frame = std::move(queue_.front());
+        queue_.pop_front();
+
+        // Encode and write without holding the lock
+        lock.unlock();
+        writeFrame(frame);
+        lock.lock();
+        written_++;
+    }
+}
+
+void TimeLapseRecorder::writeFrame(const SnapshotFrame& frame) {
+    if (options_.snapshot.format == SnapshotFormat::GIF) {
+        if (!gifOpen_) {
+            gifOpen_ = gif_.open(options_.prefix + ".gif", frame.width, frame.height);
+        }
+        if (gifOpen_) {
+            gif_.addFrame(frame, options_.frameDelayCs);
+        }
+        return;
+    }
+
+    char number[32];
+    std::snprintf(number, sizeof(number), "_%06lld", frame.generation);
+    Snapshot::write(options_.prefix + number + Snapshot::extension(options_.snapshot.format),
+                    frame, options_.snapshot.format);
+}
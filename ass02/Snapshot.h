@@ -0,0 +1,243 @@
+/**
+ * @file Snapshot.h
+ * @brief Image export of the game grid and background time-lapse recording
+ * @author Your Name
+ * @date March 2025
+ */
+
+ #ifndef SNAPSHOT_H
+ #define SNAPSHOT_H
+
+ #include <condition_variable>
+ #include <deque>
+ #include <fstream>
+ #include <mutex>
+ #include <string>
+ #include <thread>
+ #include <vector>
+
+ class GameOfLife;
+
+ /**
+  * @brief Image formats supported by the snapshot subsystem
+  */
+ enum class SnapshotFormat {
+     BMP24, ///< 24-bit BMP, live cells green
+     BMP1,  ///< 1-bit paletted BMP, 24 times smaller than BMP24
+     PNG,   ///< Paletted PNG (1-bit, or 8-bit when cells are averaged)
+     GIF    ///< Animated GIF (time-lapse only)
+ };
+
+ /**
+  * @struct SnapshotOptions
+  * @brief How a grid is turned into an image
+  */
+ struct SnapshotOptions {
+     SnapshotFormat format; ///< Output format
+     int scale;             ///< Cells per pixel along each axis, 0 = derive from maxWidth/maxHeight
+     int maxWidth;          ///< Maximum image width when scale is 0 (0 = unlimited)
+     int maxHeight;         ///< Maximum image height when scale is 0 (0 = unlimited)
+
+     SnapshotOptions() : format(SnapshotFormat::BMP24), scale(1), maxWidth(0), maxHeight(0) {}
+ };
+
+ /**
+  * @struct SnapshotFrame
+  * @brief A grid rendered to pixels
+  *
+  * Each pixel holds the fraction of live cells in its block, from 0 (all
+  * dead) to 255 (all alive). With one cell per pixel the values are 0 or 255.
+  */
+ struct SnapshotFrame {
+     int width;  ///< Image width in pixels
+     int height; ///< Image height in pixels
+     bool binary; ///< All pixels are 0 or 255
+     long long generation; ///< Generation the frame was captured at
+     std::vector<unsigned char> pixels; ///< Row-major density values
+
+     SnapshotFrame() : width(0), height(0), binary(true), generation(0) {}
+ };
+
+ /**
+  * @class Snapshot
+  * @brief Renders the grid to images and writes them in one pass per row
+  */
+ class Snapshot {
+ public:
+     /**
+      * @brief Render the grid into a frame
+      * @param game The game to capture
+      * @param options Scale settings
+      * @return The rendered frame
+      */
+     static SnapshotFrame capture(const GameOfLife& game, const SnapshotOptions& options);
+
+     /**
+      * @brief Capture the grid and write it to a file
+      * @param filename The file to write
+      * @param game The game to capture
+      * @param options Format and scale settings
+      * @return true if the file was written, false otherwise
+      */
+     static bool save(const std::string& filename, const GameOfLife& game,
+                      const SnapshotOptions& options);
+
+     /**
+      * @brief Write a frame as a still image
+      * @param filename The file to write
+      * @param frame The frame to write
+      * @param format BMP24, BMP1 or PNG
+      * @return true if the file was written, false otherwise
+      */
+     static bool write(const std::string& filename, const SnapshotFrame& frame,
+                       SnapshotFormat format);
+
+     /**
+      * @brief Get the usual file extension of a format
+      * @param format The format
+      * @return The extension including the dot
+      */
+     static const char* extension(SnapshotFormat format);
+
+     /**
+      * @brief Parse a format name ("bmp24", "bmp1", "png", "gif")
+      * @param name The name to parse
+      * @param format Receives the format
+      * @return true if the name is known
+      */
+     static bool parseFormat(const std::string& name, SnapshotFormat& format);
+
+ private:
+     static bool writeBMP24(std::ofstream& file, const SnapshotFrame& frame);
+     static bool writeBMP1(std::ofstream& file, const SnapshotFrame& frame);
+     static bool writePNG(std::ofstream& file, const SnapshotFrame& frame);
+ };
+
+ /**
+  * @class GifWriter
+  * @brief Minimal animated GIF encoder with a two-color palette
+  */
+ class GifWriter {
+ public:
+     GifWriter();
+
+     /**
+      * @brief Create the file and write the GIF header
+      * @param filename The file to write
+      * @param width Image width in pixels
+      * @param height Image height in pixels
+      * @return true if the file could be created
+      */
+     bool open(const std::string& filename, int width, int height);
+
+     /**
+      * @brief Append a frame; pixels with a value above 0 are drawn alive
+      * @param frame The frame, must have the size given to open()
+      * @param delayCs Display time of the frame in 1/100 s
+      * @return true if the frame was written
+      */
+     bool addFrame(const SnapshotFrame& frame, int delayCs);
+
+     /**
+      * @brief Write the trailer and close the file
+      */
+     void close();
+
+ private:
+     std::ofstream file_;
+     int width_;
+     int height_;
+ };
+
+ /**
+  * @struct TimeLapseOptions
+  * @brief Settings of a time-lapse recording
+  */
+ struct TimeLapseOptions {
+     std::string prefix;       ///< Output prefix ("<prefix>_000042.bmp", or "<prefix>.gif")
+     SnapshotOptions snapshot; ///< Format and scale of the captured frames
+     int every;                ///< Capture every Nth generation
+     int frameDelayCs;         ///< Frame time of animated output in 1/100 s
+     size_t maxQueued;         ///< Frames waiting for the writer before new ones are dropped
+
+     TimeLapseOptions() : prefix("timelapse"), every(10), frameDelayCs(10), maxQueued(64) {}
+ };
+
+ /**
+  * @class TimeLapseRecorder
+  * @brief Captures every Nth generation and writes it from a background thread
+  *
+  * capture() only renders the grid into a frame and queues it; all encoding
+  * and file I/O happen on the writer thread. If the writer falls behind by
+  * more than maxQueued frames, new frames are dropped instead of blocking the
+  * simulation.
+  */
+ class TimeLapseRecorder {
+ public:
+     /**
+      * @brief Create a recorder; call start() to begin recording
+      * @param options Recording settings
+      */
+     explicit TimeLapseRecorder(const TimeLapseOptions& options);
+
+     /**
+      * @brief Stop recording and wait for queued frames to be written
+      */
+     ~TimeLapseRecorder();
+
+     /**
+      * @brief Start the writer thread
+      * @return true if recording started
+      */
+     bool start();
+
+     /**
+      * @brief Offer the current generation to the recorder
+      *
+      * Does nothing unless the generation is a multiple of the capture interval.
+      * @param game The game to capture
+      */
+     void capture(const GameOfLife& game);
+
+     /**
+      * @brief Flush the queue and stop the writer thread
+      */
+     void stop();
+
+     /**
+      * @brief Get the number of frames written so far
+      * @return Frames written
+      */
+     unsigned long framesWritten() const;
+
+     /**
+      * @brief Get the number of frames dropped because the writer was behind
+      * @return Frames dropped
+      */
+     unsigned long framesDropped() const;
+
+ private:
+     /**
+      * @brief Body of the writer thread
+      */
+     void writerLoop();
+
+     /**
+      * @brief Write one frame to its destination
+      * @param frame The frame to write
+      */
+     void writeFrame(const SnapshotFrame& frame);
+
+     TimeLapseOptions options_;
+     std::thread writer_;
+     mutable std::mutex mutex_;
+     std::condition_variable wake_;
+     std::deque<SnapshotFrame> queue_;
+     bool running_;
+     unsigned long written_;
+     unsigned long dropped_;
+     GifWriter gif_;
+     bool gifOpen_;
+ };
+
+ #endif // SNAPSHOT_H
@@ -0,0 +1,166 @@
+#include "TerminalRenderer.h"
+#include "GameOfLife.h"
+#include <ncurses.h>
+#include <clocale>
+#include <cstring>
+#include <langinfo.h>
+
+namespace {
+
+// Glyphs indexed by state: bit 0 = top cell alive, bit 1 = bottom cell alive
+const char* const kHalfBlockGlyphs[4] = {" ", "\xE2\x96\x80", "\xE2\x96\x84", "\xE2\x96\x88"};
+
+// Number of lines below the grid used for status, help and messages
+const int kStatusLines = 4;
+
+} // namespace
+
+TerminalRenderer::TerminalRenderer(int frameIntervalMs)
+    : useColors_(false), halfBlocks_(false), rowsPerChar_(1),
+      viewRows_(0), viewCols_(0), fullRepaint_(true),
+      frameInterval_(std::chrono::milliseconds(frameIntervalMs)),
+      nextFrame_(Clock::now()), lastFrame_(Clock::now()),
+      droppedFrames_(0), displayFps_(0.0) {
+    // Half blocks need a UTF-8 locale, otherwise fall back to one row per cell
+    std::setlocale(LC_ALL, "");
+    halfBlocks_ = std::strcmp(nl_langinfo(CODESET), "UTF-8") == 0;
+    rowsPerChar_ = halfBlocks_ ? 2 : 1;
+
+    // Initialize ncurses
+    initscr();
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    curs_set(0);  // Hide cursor
+    timeout(0);   // Never block in getch(), the game loop does its own pacing
+
+    // Query color support once instead of once per cell
+    useColors_ = has_colors();
+    if (useColors_) {
+        start_color();
+        init_pair(1, COLOR_GREEN, COLOR_BLACK); // Live cells (glyph foreground)
+        init_pair(2, COLOR_BLACK, COLOR_BLACK); // Dead cells
+    }
+}
+
+TerminalRenderer::~TerminalRenderer() {
+    // End ncurses mode
+    endwin();
+}
+
+bool TerminalRenderer::frameDue() const {
+    return Clock::now() >= nextFrame_;
+}
+
+void TerminalRenderer::skipFrame() {
+    droppedFrames_++;
+}
+
+void TerminalRenderer::showMessage(const std::string& message) {
+    message_ = message;
+    if (viewRows_ > 0) {
+        move(viewRows_ + 3, 0);
+        clrtoeol();
+        mvaddnstr(viewRows_ + 3, 0, message_.c_str(), COLS);
+    }
+}
+
+void TerminalRenderer::invalidate() {
+    fullRepaint_ = true;
+}
+
+unsigned char TerminalRenderer::cellState(const GameOfLife& game, int termRow, int col) const {
+    int row = termRow * rowsPerChar_;
+    unsigned char state = game.isAlive(row, col) ? 1 : 0;
+    if (rowsPerChar_ == 2 && row + 1 < game.getHeight() && game.isAlive(row + 1, col)) {
+        state |= 2;
+    }
+    return state;
+}
+
+void TerminalRenderer::putCell(int termRow, int col, unsigned char state) {
+    if (halfBlocks_) {
+        if (useColors_) {
+            attron(COLOR_PAIR(1));
+            mvaddstr(termRow, col, kHalfBlockGlyphs[state]);
+            attroff(COLOR_PAIR(1));
+        } else {
+            mvaddstr(termRow, col, kHalfBlockGlyphs[state]);
+        }
+    } else if (useColors_) {
+        // One cell per character: paint the background like the original view
+        attron(COLOR_PAIR(state ? 1 : 2) | (state ? A_REVERSE : 0));
+        mvaddch(termRow, col, ' ');
+        attroff(COLOR_PAIR(state ? 1 : 2) | (state ? A_REVERSE : 0));
+    } else {
+        mvaddch(termRow, col, state ? '#' : '.');
+    }
+}
+
+void TerminalRenderer::present(const GameOfLife& game) {
+    Clock::time_point start = Clock::now();
+
+    // Clip the view to the terminal, leaving room for the status lines
+    int rows = (game.getHeight() + rowsPerChar_ - 1) / rowsPerChar_;
+    int maxRows = LINES - kStatusLines;
+    if (rows > maxRows) rows = maxRows > 0 ? maxRows : 0;
+    int cols = game.getWidth() < COLS ? game.getWidth() : COLS;
+
+    if (rows != viewRows_ || cols != viewCols_) {
+        viewRows_ = rows;
+        viewCols_ = cols;
+        fullRepaint_ = true;
+    }
+
+    if (fullRepaint_) {
+        erase();
+        shown_.assign(static_cast<size_t>(viewRows_) * viewCols_, 0);
+        for (int r = 0; r < viewRows_; r++) {
+            for (int c = 0; c < viewCols_; c++) {
+                unsigned char state = cellState(game, r, c);
+                shown_[static_cast<size_t>(r) * viewCols_ + c] = state;
+                putCell(r, c, state);
+            }
+        }
+        if (!message_.empty()) {
+            mvaddnstr(viewRows_ + 3, 0, message_.c_str(), COLS);
+        }
+        fullRepaint_ = false;
+    } else {
+        // Only emit cells whose glyph changed since the last presented frame
+        for (int r = 0; r < viewRows_; r++) {
+            unsigned char* shownRow = &shown_[static_cast<size_t>(r) * viewCols_];
+            for (int c = 0; c < viewCols_; c++) {
+                unsigned char state = cellState(game, r, c);
+                if (state != shownRow[c]) {
+                    shownRow[c] = state;
+                    putCell(r, c, state);
+                }
+            }
+        }
+    }
+
+    // Smoothed display rate, so it is visible how many frames are dropped
+    double elapsed = std::chrono::duration<double>(start - lastFrame_).count();
+    if (elapsed > 0.0) {
+        double fps = 1.0 / elapsed;
+        displayFps_ = displayFps_ == 0.0 ? fps : 0.9 * displayFps_ + 0.1 * fps;
+    }
+    lastFrame_ = start;
+
+    // Display generation count
+    move(viewRows_ + 1, 0);
+    clrtoeol();
+    mvprintw(viewRows_ + 1, 0, "Generation: %lld  Rule: %s  (display %.0f fps, %lu generations not shown)",
+             game.getGeneration(), game.getRule().toString().c_str(), displayFps_, droppedFrames_);
+    mvprintw(viewRows_ + 2, 0, "Press 'q' to quit, 's' to save image, 'c' to checkpoint, 'r' to randomize, '+'/'-' to change speed");
+
+    // Update the screen
+    refresh();
+
+    // Schedule the next frame after the time the terminal needed for this one,
+    // so a slow link lowers the display rate instead of the simulation rate
+    Clock::time_point done = Clock::now();
+    Clock::duration cost = done - start;
+    nextFrame_ = done + (cost > frameInterval_ ? cost : frameInterval_);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file TerminalRenderer.h
+ * @brief Incremental ncurses renderer for the Game of Life grid
+ * @author Your Name
+ * @date March 2025
+ */
+
+ #ifndef TERMINAL_RENDERER_H
+ #define TERMINAL_RENDERER_H
+
+ #include <chrono>
+ #include <string>
+ #include <vector>
+
+ class GameOfLife;
+
+ /**
+  * @class TerminalRenderer
+  * @brief Draws the grid to the terminal, emitting only cells that changed
+  *
+  * The renderer keeps a shadow copy of what is currently on screen and only
+  * touches terminal cells whose glyph differs from the previous frame. On
+  * UTF-8 terminals two cell rows share one terminal row using the half-block
+  * characters, so a board fits in half the height. Frames are presented at
+  * most once per frame interval; generations computed in between are simply
+  * not shown, which keeps the simulation speed independent of the terminal.
+  */
+ class TerminalRenderer {
+ public:
+     /**
+      * @brief Initialize ncurses and the renderer state
+      * @param frameIntervalMs Minimum time between two presented frames
+      */
+     explicit TerminalRenderer(int frameIntervalMs = 33);
+
+     /**
+      * @brief Restore the terminal
+      */
+     ~TerminalRenderer();
+
+     /**
+      * @brief Check whether enough time has passed to present a new frame
+      * @return true if the next call to present() should be made
+      */
+     bool frameDue() const;
+
+     /**
+      * @brief Present the current generation, redrawing only changed cells
+      * @param game The game whose grid should be shown
+      */
+     void present(const GameOfLife& game);
+
+     /**
+      * @brief Record that a generation was computed but not presented
+      */
+     void skipFrame();
+
+     /**
+      * @brief Show a message on the line below the status line
+      * @param message The text to show
+      */
+     void showMessage(const std::string& message);
+
+     /**
+      * @brief Force a full repaint on the next frame (e.g. after a resize)
+      */
+     void invalidate();
+
+ private:
+     /**
+      * @brief Compute the glyph state of a terminal cell
+      * @param game The game to read from
+      * @param termRow Terminal row
+      * @param col Grid column
+      * @return Bit 0 set if the top cell is alive, bit 1 if the bottom one is
+      */
+     unsigned char cellState(const GameOfLife& game, int termRow, int col) const;
+
+     /**
+      * @brief Emit the glyph for a glyph state at a terminal position
+      * @param termRow Terminal row
+      * @param col Terminal column
+      * @param state Glyph state as returned by cellState()
+      */
+     void putCell(int termRow, int col, unsigned char state);
+
+     typedef std::chrono::steady_clock Clock;
+
+     bool useColors_;    ///< Terminal supports colors (queried once)
+     bool halfBlocks_;   ///< Pack two cell rows per terminal row
+     int rowsPerChar_;   ///< Cell rows per terminal row (1 or 2)
+     int viewRows_;      ///< Terminal rows used by the grid view
+     int viewCols_;      ///< Terminal columns used by the grid view
+     std::vector<unsigned char> shown_; ///< Glyph states currently on screen
+     bool fullRepaint_;  ///< Next frame must redraw every cell
+     std::string message_; ///< Pending message line
+     Clock::duration frameInterval_; ///< Minimum time between frames
+     Clock::time_point nextFrame_;   ///< Earliest time of the next frame
+     Clock::time_point lastFrame_;   ///< Time the last frame was shown
+     unsigned long droppedFrames_;   ///< Generations not shown so far
+     double displayFps_;             ///< Smoothed presented frame rate
+ };
+
+ #endif // TERMINAL_RENDERER_H
@@ -5,8 +5,15 @@
  * @date March 2025
  */
 
+ #include "Checkpoint.h"
  #include "GameOfLife.h"
+ #include "PatternLoader.h"
+ #include "Snapshot.h"
+ #include <chrono>
+ #include <cstdlib>
  #include <iostream>
+ #include <memory>
+ #include <string>
  #include <vector>
  
  /**
@@ -100,6 +107,7 @@
      std::cout << "2. Glider pattern\n";
      std::cout << "3. Blinker pattern\n";
      std::cout << "4. Gosper glider gun pattern\n";
+     std::cout << "5. Load pattern file (RLE, Life 1.06, macrocell)\n";
      std::cout << "0. Exit\n";
      std::cout << "Enter your choice: ";
      
@@ -108,21 +116,179 @@
      return choice;
  }
  
+ /**
+  * @brief Display the rule menu and get the chosen rule
+  * @param rule Receives the chosen rule
+  * @return true if a rule was chosen, false if the custom rule was invalid
+  */
+ bool chooseRule(Rule& rule) {
+     std::cout << "\nRule\n";
+     std::cout << "====\n";
+     std::cout << "1. Conway's Life (B3/S23)\n";
+     std::cout << "2. HighLife (B36/S23)\n";
+     std::cout << "3. Day & Night (B3678/S34678)\n";
+     std::cout << "4. Seeds (B2/S)\n";
+     std::cout << "5. Custom rule (B.../S...)\n";
+     std::cout << "Enter your choice: ";
+     
+     int choice;
+     std::cin >> choice;
+     
+     const char* names[] = {"B3/S23", "B36/S23", "B3678/S34678", "B2/S"};
+     std::string text;
+     if (choice >= 1 && choice <= 4) {
+         text = names[choice - 1];
+     } else if (choice == 5) {
+         std::cout << "Rule: ";
+         std::cin >> text;
+     } else {
+         text = names[0];
+     }
+     
+     std::string error;
+     if (!Rule::parse(text, rule, error)) {
+         std::cerr << error << "\n";
+         return false;
+     }
+     return true;
+ }
+ 
+ /**
+  * @brief Print command line usage
+  * @param program The name of the executable
+  */
+ void printUsage(const char* program) {
+     std::cout << "Usage: " << program << " [options] [pattern-file]\n\n"
+               << "Options:\n"
+               << "  --height N    Grid height (default 30)\n"
+               << "  --width N     Grid width (default 80)\n"
+               << "  --rule R      Rule in B/S notation, e.g. B36/S23 (default: file rule or menu)\n"
+               << "  --headless    Run without a terminal and print statistics\n"
+               << "  --generations N  Generations to run with --headless (default 1000)\n"
+               << "  --snapshot-format F   Format of images saved with 's': bmp24, bmp1, png\n"
+               << "  --snapshot-scale N    Cells per pixel of saved images (default 1)\n"
+               << "  --timelapse PREFIX    Record a time-lapse to PREFIX_<generation>.<ext> or PREFIX.gif\n"
+               << "  --timelapse-every N   Capture every Nth generation (default 10)\n"
+               << "  --timelapse-format F  bmp24, bmp1, png or gif (default gif)\n"
+               << "  --checkpoint FILE     Save checkpoints to FILE ('c' key, on exit, and periodically)\n"
+               << "  --checkpoint-every N  Checkpoint every Nth generation in the background\n"
+               << "  --restore FILE        Continue a run from a checkpoint\n"
+               << "  --help        Display this help message\n\n"
+               << "Without a pattern file or checkpoint an interactive menu is shown.\n";
+ }
+ 
  /**
   * @brief Main function
+  * @param argc Number of command line arguments
+  * @param argv Command line arguments
   * @return Exit status
   */
- int main() {
-     int choice = displayMenu();
+ int main(int argc, char* argv[]) {
+     // Default grid size, can be changed with --height and --width
+     int height = 30;
+     int width = 80;
+     std::string patternFile;
+     SnapshotOptions snapshotOptions;
+     TimeLapseOptions timeLapseOptions;
+     timeLapseOptions.snapshot.format = SnapshotFormat::GIF;
+     bool recordTimeLapse = false;
+     std::string ruleText;
+     bool headless = false;
+     int generations = 1000;
+     CheckpointOptions checkpointOptions;
+     bool writeCheckpoints = false;
+     std::string restoreFile;
+     
+     for (int i = 1; i < argc; i++) {
+         std::string arg = argv[i];
+         if (arg == "--height" && i + 1 < argc) {
+             height = std::atoi(argv[++i]);
+         } else if (arg == "--width" && i + 1 < argc) {
+             width = std::atoi(argv[++i]);
+         } else if (arg == "--rule" && i + 1 < argc) {
+             ruleText = argv[++i];
+         } else if (arg == "--headless") {
+             headless = true;
+         } else if (arg == "--generations" && i + 1 < argc) {
+             generations = std::atoi(argv[++i]);
+         } else if (arg == "--snapshot-format" && i + 1 < argc) {
+             if (!Snapshot::parseFormat(argv[++i], snapshotOptions.format) ||
+                 snapshotOptions.format == SnapshotFormat::GIF) {
+                 std::cerr << "Unknown snapshot format: " << argv[i] << "\n";
+                 return 1;
+             }
+         } else if (arg == "--snapshot-scale" && i + 1 < argc) {
+             snapshotOptions.scale = std::atoi(argv[++i]);
+         } else if (arg == "--timelapse" && i + 1 < argc) {
+             timeLapseOptions.prefix = argv[++i];
+             recordTimeLapse = true;
+         } else if (arg == "--timelapse-every" && i + 1 < argc) {
+             timeLapseOptions.every = std::atoi(argv[++i]);
+         } else if (arg == "--timelapse-format" && i + 1 < argc) {
+             if (!Snapshot::parseFormat(argv[++i], timeLapseOptions.snapshot.format)) {
+                 std::cerr << "Unknown time-lapse format: " << argv[i] << "\n";
+                 return 1;
+             }
+         } else if (arg == "--checkpoint" && i + 1 < argc) {
+             checkpointOptions.filename = argv[++i];
+             writeCheckpoints = true;
+         } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+             checkpointOptions.every = std::atoi(argv[++i]);
+         } else if (arg == "--restore" && i + 1 < argc) {
+             restoreFile = argv[++i];
+         } else if (arg == "--help") {
+             printUsage(argv[0]);
+             return 0;
+         } else {
+             patternFile = arg;
+         }
+     }
+     
+     // A checkpoint decides the grid size
+     CheckpointInfo checkpointInfo;
+     if (!restoreFile.empty()) {
+         std::string error;
+         if (!Checkpoint::readInfo(restoreFile, checkpointInfo, error)) {
+             std::cerr << "Failed to read checkpoint: " << error << "\n";
+             return 1;
+         }
+         height = checkpointInfo.height;
+         width = checkpointInfo.width;
+     }
+     
+     if (height <= 0 || width <= 0) {
+         std::cerr << "Grid size must be positive\n";
+         return 1;
+     }
+     
+     // A rule given on the command line overrides the menu and the pattern file
+     Rule rule;
+     if (!ruleText.empty()) {
+         std::string error;
+         if (!Rule::parse(ruleText, rule, error)) {
+             std::cerr << error << "\n";
+             return 1;
+         }
+     }
+     
+     int choice = 6;
+     if (restoreFile.empty()) {
+         choice = patternFile.empty() ? (headless ? 1 : displayMenu()) : 5;
+     }
      
      if (choice == 0) {
          return 0;
      }
      
+     if (choice == 5 && patternFile.empty()) {
+         std::cout << "Pattern file: ";
+         std::cin >> patternFile;
+     }
+     
      // Create game with appropriate size
-     int height = 30;
-     int width = 80;
      GameOfLife game(height, width);
+     game.setSnapshotOptions(snapshotOptions);
+     game.setRule(rule);
      
      // Initialize based on user choice
      switch (choice) {
@@ -138,14 +304,108 @@
          case 4:
              game.initializePattern(createGosperGliderGun());
              break;
+         case 5:
+             {
+                 PatternInfo info;
+                 std::string error;
+                 if (!PatternLoader::load(patternFile, game, info, error)) {
+                     std::cerr << "Failed to load pattern: " << error << "\n";
+                     return 1;
+                 }
+                 std::cout << "Loaded " << info.format << " pattern " << info.width << "x"
+                           << info.height << ", " << info.liveCells << " live cells on the grid\n";
+                 
+                 // Use the rule stored in the file unless one was given
+                 if (ruleText.empty() && !info.rule.empty()) {
+                     Rule fileRule;
+                     if (Rule::parse(info.rule, fileRule, error)) {
+                         game.setRule(fileRule);
+                     } else {
+                         std::cerr << "Ignoring pattern rule: " << error << "\n";
+                     }
+                 }
+             }
+             break;
+         case 6:
+             {
+                 std::string error;
+                 auto start = std::chrono::steady_clock::now();
+                 if (!Checkpoint::restore(restoreFile, game, checkpointInfo, error)) {
+                     std::cerr << "Failed to restore checkpoint: " << error << "\n";
+                     return 1;
+                 }
+                 double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                 std::cout << "Restored generation " << checkpointInfo.generation << " (" << height << "x"
+                           << width << ", rule " << game.getRule().toString() << ") in " << seconds << " s\n";
+                 
+                 // The rule saved in the checkpoint applies unless one was given
+                 if (!ruleText.empty()) {
+                     game.setRule(rule);
+                 }
+             }
+             break;
          default:
              game.initializeRandom();
              break;
      }
      
+     // Built-in patterns ask for the rule unless one was given
+     if (choice != 5 && choice != 6 && ruleText.empty() && !headless) {
+         if (!chooseRule(rule)) {
+             return 1;
+         }
+         game.setRule(rule);
+     }
+     
+     // Record a time-lapse from a background thread while the game runs
+     TimeLapseRecorder recorder(timeLapseOptions);
+     if (recordTimeLapse) {
+         recorder.start();
+         game.setTimeLapse(&recorder);
+     }
+     
+     // Write checkpoints from a background thread while the game runs
+     std::unique_ptr<CheckpointWriter> checkpointWriter;
+     if (writeCheckpoints) {
+         checkpointWriter.reset(new CheckpointWriter(checkpointOptions));
+         game.setCheckpointWriter(checkpointWriter.get());
+     }
+     
      // Run the game
-     game.run();
+     if (headless) {
+         std::cout << "Rule " << game.getRule().toString()
+                   << (game.hasSpecializedKernel() ? " (specialized kernel)" : " (generic kernel)")
+                   << ", population " << game.getPopulation() << "\n";
+         
+         auto start = std::chrono::steady_clock::now();
+         game.runHeadless(generations);
+         double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+         
+         std::cout << "Generation " << game.getGeneration() << ", population " << game.getPopulation()
+                   << "\n" << generations << " generations in " << seconds << " s ("
+                   << (seconds > 0 ? generations / seconds : 0.0) << " generations/s, "
+                   << (seconds > 0 ? generations * static_cast<double>(height) * width / seconds / 1e6 : 0.0)
+                   << " Mcells/s)\n";
+     } else {
+         game.run();
+     }
+     
+     // Save the final state so the run can be continued with --restore
+     if (checkpointWriter) {
+         if (checkpointWriter->writeNow(game)) {
+             std::cout << "Checkpoint of generation " << game.getGeneration() << " saved to "
+                       << checkpointOptions.filename << " (" << checkpointWriter->written() << " written, "
+                       << checkpointWriter->skipped() << " skipped)\n";
+         } else {
+             std::cerr << "Failed to save checkpoint: " << checkpointWriter->lastError() << "\n";
+         }
+     }
+     
+     if (recordTimeLapse) {
+         recorder.stop();
+         std::cout << "Time-lapse: " << recorder.framesWritten() << " frames written, "
+                   << recorder.framesDropped() << " dropped\n";
+     }
      
      return 0;
  }
- 
\ No newline at end of file
@@ -0,0 +1,307 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief Decodes the PNG and GIF files written by the snapshot subsystem
+ *
+ * Frames of several sizes are written with Snapshot::write() and GifWriter,
+ * read back, and checked byte by byte: PNG chunk lengths and CRCs, the stored
+ * deflate blocks and Adler-32 of the zlib stream, and a strict GIF LZW decode
+ * that rejects codes not yet in the dictionary. Run with "make check".
+ */
+
+#include "Snapshot.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* kTempFile = "test_snapshot.tmp";
+
+std::vector<unsigned char> readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                      std::istreambuf_iterator<char>());
+}
+
+uint32_t getBE32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint32_t getLE16(const unsigned char* p) {
+    return p[0] | (static_cast<uint32_t>(p[1]) << 8);
+}
+
+uint32_t crc32(const unsigned char* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * Random frame; binary frames hold 0/255 with about density/256 of the pixels
+ * alive, others any density value
+ */
+SnapshotFrame makeFrame(int width, int height, bool binary, unsigned seed, unsigned density = 96) {
+    std::mt19937 rng(seed);
+    SnapshotFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.binary = binary;
+    frame.pixels.resize(static_cast<size_t>(width) * height);
+    for (unsigned char& p : frame.pixels) {
+        unsigned v = rng() & 0xFF;
+        p = static_cast<unsigned char>(binary ? (v < density ? 255 : 0) : v);
+    }
+    return frame;
+}
+
+/**
+ * Scanlines the PNG writer is expected to produce (filter byte + packed pixels)
+ */
+std::vector<unsigned char> expectedScanlines(const SnapshotFrame& frame) {
+    size_t lineBytes = frame.binary ? (static_cast<size_t>(frame.width) + 7) / 8
+                                    : static_cast<size_t>(frame.width);
+    std::vector<unsigned char> raw;
+    for (int y = 0; y < frame.height; y++) {
+        raw.push_back(0);
+        size_t start = raw.size();
+        raw.resize(start + lineBytes, 0);
+        for (int x = 0; x < frame.width; x++) {
+            unsigned char p = frame.pixels[static_cast<size_t>(y) * frame.width + x];
+            if (!frame.binary) {
+                raw[start + x] = p;
+            } else if (p) {
+                raw[start + (x >> 3)] |= static_cast<unsigned char>(0x80 >> (x & 7));
+            }
+        }
+    }
+    return raw;
+}
+
+/**
+ * Check every chunk of a PNG file and unpack its stored zlib stream
+ * @return Empty string on success, otherwise the problem found
+ */
+std::string checkPNG(const std::vector<unsigned char>& png, std::vector<unsigned char>& raw) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size() < 8 || !std::equal(signature, signature + 8, png.begin())) return "bad signature";
+
+    std::vector<unsigned char> zlib;
+    size_t pos = 8;
+    bool sawEnd = false;
+    while (pos < png.size()) {
+        if (png.size() - pos < 12) return "truncated chunk";
+        uint32_t length = getBE32(&png[pos]);
+        if (png.size() - pos - 12 < length) return "chunk length past end of file";
+        std::string type(png.begin() + pos + 4, png.begin() + pos + 8);
+        if (crc32(&png[pos + 4], length + 4) != getBE32(&png[pos + 8 + length])) return "bad CRC in " + type;
+        if (type == "IDAT") zlib.insert(zlib.end(), png.begin() + pos + 8, png.begin() + pos + 8 + length);
+        pos += 12 + length;
+        if (type == "IEND") {
+            sawEnd = true;
+            break;
+        }
+    }
+    if (!sawEnd || pos != png.size()) return "missing IEND or data after it";
+
+    // zlib header, stored blocks, Adler-32
+    if (zlib.size() < 6 || zlib[0] != 0x78 || (zlib[0] * 256 + zlib[1]) % 31 != 0) return "bad zlib header";
+    raw.clear();
+    pos = 2;
+    for (bool final = false; !final;) {
+        if (zlib.size() - pos < 5) return "truncated deflate block";
+        if ((zlib[pos] & 0x06) != 0) return "not a stored block";
+        final = zlib[pos] & 1;
+        uint32_t len = getLE16(&zlib[pos + 1]);
+        if ((len ^ getLE16(&zlib[pos + 3])) != 0xFFFF) return "bad NLEN";
+        pos += 5;
+        if (zlib.size() - pos < len) return "stored block past end of stream";
+        raw.insert(raw.end(), zlib.begin() + pos, zlib.begin() + pos + len);
+        pos += len;
+    }
+    if (zlib.size() - pos != 4) return "data after the final deflate block";
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : raw) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    if (getBE32(&zlib[pos]) != ((b << 16) | a)) return "bad Adler-32";
+    return "";
+}
+
+/**
+ * Strict GIF LZW decoder: a code is only accepted if it is already in the
+ * dictionary or is the next one to be added
+ */
+std::string decodeLZW(const std::vector<unsigned char>& data, int minCodeSize, size_t pixelCount,
+                      std::vector<unsigned char>& pixels) {
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    std::vector<std::vector<unsigned char>> table;
+    int codeSize = 0;
+    int prev = -1;
+    size_t bitPos = 0;
+    pixels.clear();
+
+    auto reset = [&]() {
+        table.assign(clearCode + 2, std::vector<unsigned char>());
+        for (int i = 0; i < clearCode; i++) table[i].assign(1, static_cast<unsigned char>(i));
+        codeSize = minCodeSize + 1;
+        prev = -1;
+    };
+    reset();
+
+    for (;;) {
+        if (bitPos + codeSize > data.size() * 8) return "stream ends without end code";
+        int code = 0;
+        for (int i = 0; i < codeSize; i++, bitPos++) {
+            code |= ((data[bitPos >> 3] >> (bitPos & 7)) & 1) << i;
+        }
+        if (code == clearCode) {
+            reset();
+            continue;
+        }
+        if (code == endCode) break;
+
+        int next = static_cast<int>(table.size());
+        std::vector<unsigned char> entry;
+        if (code < next) {
+            entry = table[code];
+        } else if (code == next && prev >= 0) {
+            entry = table[prev];
+            entry.push_back(table[prev][0]);
+        } else {
+            return "bad code " + std::to_string(code) + " table " + std::to_string(next);
+        }
+        pixels.insert(pixels.end(), entry.begin(), entry.end());
+        if (prev >= 0 && next < 4096) {
+            table.push_back(table[prev]);
+            table.back().push_back(entry[0]);
+            if (static_cast<int>(table.size()) == (1 << codeSize) && codeSize < 12) codeSize++;
+        }
+        prev = code;
+    }
+    if (pixels.size() != pixelCount) return "decoded " + std::to_string(pixels.size()) + " pixels";
+    return "";
+}
+
+/**
+ * Walk a GIF file with one frame and decode its image data
+ */
+std::string checkGIF(const std::vector<unsigned char>& gif, const SnapshotFrame& frame) {
+    // Header + 2-entry color table + NETSCAPE loop extension + graphic control
+    size_t pos = 13 + 6 + 19 + 8;
+    if (gif.size() < pos + 11 || gif[pos] != 0x2C) return "missing image descriptor";
+    if (static_cast<int>(getLE16(&gif[pos + 5])) != frame.width ||
+        static_cast<int>(getLE16(&gif[pos + 7])) != frame.height) return "wrong image size";
+    pos += 10;
+    int minCodeSize = gif[pos++];
+
+    std::vector<unsigned char> data;
+    for (;;) {
+        if (pos >= gif.size()) return "truncated sub-blocks";
+        size_t n = gif[pos++];
+        if (n == 0) break;
+        if (gif.size() - pos < n) return "sub-block past end of file";
+        data.insert(data.end(), gif.begin() + pos, gif.begin() + pos + n);
+        pos += n;
+    }
+    if (pos + 1 != gif.size() || gif[pos] != 0x3B) return "missing trailer";
+
+    std::vector<unsigned char> pixels;
+    std::string error = decodeLZW(data, minCodeSize, frame.pixels.size(), pixels);
+    if (!error.empty()) return error;
+    for (size_t i = 0; i < pixels.size(); i++) {
+        if (pixels[i] != (frame.pixels[i] ? 1 : 0)) return "pixel " + std::to_string(i) + " differs";
+    }
+    return "";
+}
+
+int failures = 0;
+
+void report(const std::string& what, const std::string& error) {
+    std::cout << (error.empty() ? "  ok    " : "  FAIL  ") << what;
+    if (!error.empty()) std::cout << ": " << error;
+    std::cout << std::endl;
+    if (!error.empty()) failures++;
+}
+
+void testPNG(int width, int height, bool binary) {
+    SnapshotFrame frame = makeFrame(width, height, binary, static_cast<unsigned>(width * 31 + height));
+    std::string what = "PNG " + std::to_string(width) + "x" + std::to_string(height) +
+                       (binary ? " 1-bit" : " 8-bit");
+    std::vector<unsigned char> expected = expectedScanlines(frame);
+    what += " (" + std::to_string(expected.size()) + " raw bytes)";
+
+    if (!Snapshot::write(kTempFile, frame, SnapshotFormat::PNG)) {
+        report(what, "write failed");
+        return;
+    }
+    std::vector<unsigned char> raw;
+    std::string error = checkPNG(readFile(kTempFile), raw);
+    if (error.empty() && raw != expected) error = "scanlines differ";
+    report(what, error);
+}
+
+void testGIF(int width, int height) {
+    // All dead, all alive and random frames of several densities and seeds, so
+    // the last code falls on both sides of a code width change
+    const unsigned densities[] = {0, 256, 8, 32, 96, 128, 200};
+    std::string what = "GIF " + std::to_string(width) + "x" + std::to_string(height);
+    int frames = 0;
+    for (unsigned density : densities) {
+        for (unsigned seed = 0; seed < 8; seed++) {
+            SnapshotFrame frame = makeFrame(width, height, true, seed * 7919 + width * 17 + height, density);
+            GifWriter writer;
+            if (!writer.open(kTempFile, width, height) || !writer.addFrame(frame, 10)) {
+                report(what, "write failed");
+                return;
+            }
+            writer.close();
+            std::string error = checkGIF(readFile(kTempFile), frame);
+            if (!error.empty()) {
+                report(what + ", density " + std::to_string(density) + "/256, seed " + std::to_string(seed), error);
+                return;
+            }
+            frames++;
+        }
+    }
+    report(what + " (" + std::to_string(frames) + " frames)", "");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "PNG: chunk CRCs, stored deflate blocks and Adler-32" << std::endl;
+    // 2032 pixels per 1-bit row = 255 bytes per scanline: 257 rows are exactly
+    // one 65535-byte stored block, 514 rows exactly two
+    testPNG(2032, 257, true);
+    testPNG(2032, 514, true);
+    testPNG(65534, 1, false);
+    testPNG(2032, 256, true);
+    testPNG(2032, 258, true);
+    testPNG(1, 1, true);
+    testPNG(100, 37, false);
+
+    std::cout << "GIF: strict LZW round trip" << std::endl;
+    const int sizes[][2] = {{1, 1}, {10, 10}, {7, 13}, {30, 80}, {64, 64}, {100, 100}, {200, 300}};
+    for (const auto& size : sizes) {
+        testGIF(size[0], size[1]);
+    }
+
+    std::remove(kTempFile);
+    std::cout << (failures == 0 ? "All snapshot tests passed" : "Snapshot tests failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+#ifndef CHEBYSHEV_HPP
+#define CHEBYSHEV_HPP
+
+#include "Function.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Chebyshev.hpp
+// 计算代价高的Function<T>（多层复合、GMP等）在固定区间上的分段Chebyshev近似
+//
+// 在每一段[a, b]上取Chebyshev点 x_j = (a+b)/2 + (b-a)/2 cos(πj/n) 采样，
+// 由采样值算出Chebyshev级数 sum c_k T_k(t) 的系数；次数从16开始加倍
+// （加倍后原来的点仍是节点，只需对新增的点求值），直到级数尾部小于误差目标。
+// 到最大次数仍不收敛时把区间对半分开，分别拟合。
+// 求值先二分查找所在的段，再用Clenshaw递推，代价只与该段的次数有关。
+// 拟合是逐轮进行的：每一轮所有待拟合的段分给多个线程（段数少于线程数时每段的采样也分给多个线程），
+// 不收敛的段对半分开留到下一轮，所以结果与线程数无关。f的operator()/evaluate必须可以被多个线程同时调用。
+// T为实浮点类型（float、double、long double）
+
+constexpr std::size_t kChebyshevMinDegree = 16;
+
+template <typename T>
+class ChebyshevApproximation : public Function<T> {
+public:
+    struct Options {
+        double tolerance;      // 误差目标：tolerance * max(1, max|f|)
+        std::size_t maxDegree; // 每段的最大次数，超过时对半分段
+        std::size_t maxPieces; // 最大段数，达到后不再分段（hasConverged()为false）
+        unsigned threads;      // 线程数，0表示使用硬件线程数
+
+        Options() : tolerance(1e-13), maxDegree(128), maxPieces(1024), threads(0) {}
+    };
+
+    // 一段[a, b]上的Chebyshev级数
+    struct Piece {
+        T a, b;
+        std::vector<T> coefficients; // c_0, c_1, ..., c_n
+
+        Piece() : a(), b() {}
+    };
+
+    // 在[a, b]上拟合f
+    ChebyshevApproximation(const Function<T>& f, T a, T b, const Options& options = Options())
+        : converged_(true) {
+        if (!(a < b)) {
+            throw std::invalid_argument("ChebyshevApproximation: interval must satisfy a < b");
+        }
+        fit(f, a, b, options);
+        updateBreakpoints();
+    }
+
+    // 计算近似值；区间外的点用最近一段的级数外推
+    T operator()(T x) const override {
+        std::size_t k = std::upper_bound(breakpoints_.begin(), breakpoints_.end(), x) - breakpoints_.begin();
+        const Piece& piece = pieces_[std::min(k, pieces_.size() - 1)];
+        return clenshaw(piece, x);
+    }
+
+    void evaluate(const T* xs, T* out, std::size_t n) const override {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = ChebyshevApproximation::operator()(xs[i]);
+        }
+    }
+
+    // 保存为文本，之后用load读回，可以跳过拟合
+    void save(std::ostream& os) const {
+        std::streamsize precision = os.precision(std::numeric_limits<T>::max_digits10);
+        os << "chebyshev " << pieces_.size() << ' ' << (converged_ ? 1 : 0) << '\n';
+        for (const Piece& piece : pieces_) {
+            os << piece.a << ' ' << piece.b << ' ' << piece.coefficients.size();
+            for (const T& c : piece.coefficients) {
+                os << ' ' << c;
+            }
+            os << '\n';
+        }
+        os.precision(precision);
+    }
+
+    // 读取save的输出，格式不正确时抛出std::runtime_error
+    static ChebyshevApproximation load(std::istream& is) {
+        std::string tag;
+        std::size_t count = 0;
+        int converged = 0;
+        if (!(is >> tag >> count >> converged) || tag != "chebyshev" || count == 0) {
+            throw std::runtime_error("ChebyshevApproximation::load: bad header");
+        }
+        std::vector<Piece> pieces(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t size = 0;
+            if (!(is >> pieces[i].a >> pieces[i].b >> size) || size == 0 || !(pieces[i].a < pieces[i].b) ||
+                (i > 0 && pieces[i].a != pieces[i - 1].b)) {
+                throw std::runtime_error("ChebyshevApproximation::load: bad piece");
+            }
+            pieces[i].coefficients.resize(size);
+            for (T& c : pieces[i].coefficients) {
+                if (!(is >> c)) {
+                    throw std::runtime_error("ChebyshevApproximation::load: truncated coefficients");
+                }
+            }
+        }
+        return ChebyshevApproximation(std::move(pieces), converged != 0);
+    }
+
+    // 获取各段（按区间从左到右）
+    const std::vector<Piece>& getPieces() const {
+        return pieces_;
+    }
+
+    // 各段次数的最大值
+    std::size_t getDegree() const {
+        std::size_t degree = 0;
+        for (const Piece& piece : pieces_) {
+            degree = std::max(degree, piece.coefficients.size() - 1);
+        }
+        return degree;
+    }
+
+    // 所有段是否都达到了误差目标
+    bool hasConverged() const {
+        return converged_;
+    }
+
+private:
+    std::vector<Piece> pieces_;
+    std::vector<T> breakpoints_; // 各段的右端点（不含最后一段）
+    bool converged_;
+
+    ChebyshevApproximation(std::vector<Piece> pieces, bool converged)
+        : pieces_(std::move(pieces)), converged_(converged) {
+        updateBreakpoints();
+    }
+
+    void updateBreakpoints() {
+        breakpoints_.clear();
+        for (std::size_t i = 0; i + 1 < pieces_.size(); ++i) {
+            breakpoints_.push_back(pieces_[i].b);
+        }
+    }
+
+    // b_k = c_k + 2t b_{k+1} - b_{k+2}，结果为 c_0 + t b_1 - b_2
+    static T clenshaw(const Piece& piece, T x) {
+        const std::vector<T>& c = piece.coefficients;
+        T t = (x + x - piece.a - piece.b) / (piece.b - piece.a);
+        T t2 = t + t;
+        T b1 = T(), b2 = T();
+        for (std::size_t k = c.size(); k-- > 1;) {
+            T b0 = c[k] + t2 * b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+        return c[0] + t * b1 - b2;
+    }
+
+    // 逐轮拟合：每轮并行拟合所有待拟合的段，不收敛的段对半分开进入下一轮
+    void fit(const Function<T>& f, T a, T b, const Options& options) {
+        std::vector<Piece> done;
+        std::vector<Piece> pending(1);
+        pending[0].a = a;
+        pending[0].b = b;
+        while (!pending.empty()) {
+            std::vector<char> ok(pending.size(), 0);
+            fitAll(f, pending, ok, options);
+
+            // 剩余的段数加上已完成的段数不能超过maxPieces
+            std::size_t failed = std::count(ok.begin(), ok.end(), 0);
+            bool canSplit = done.size() + pending.size() + failed <= options.maxPieces;
+            std::vector<Piece> next;
+            for (std::size_t i = 0; i < pending.size(); ++i) {
+                T mid = (pending[i].a + pending[i].b) / T(2);
+                bool splittable = pending[i].a < mid && mid < pending[i].b;
+                if (ok[i] || !canSplit || !splittable) {
+                    converged_ = converged_ && ok[i];
+                    done.push_back(std::move(pending[i]));
+                } else {
+                    Piece left, right;
+                    left.a = pending[i].a;
+                    left.b = right.a = mid;
+                    right.b = pending[i].b;
+                    next.push_back(left);
+                    next.push_back(right);
+                }
+            }
+            pending.swap(next);
+        }
+        std::sort(done.begin(), done.end(), [](const Piece& x, const Piece& y) { return x.a < y.a; });
+        pieces_.swap(done);
+    }
+
+    // 段数不少于线程数时每个线程拟合若干段；段数较少时（例如第一轮只有一段）
+    // 每段的采样再分给threads / 段数个线程
+    static void fitAll(const Function<T>& f, std::vector<Piece>& pieces, std::vector<char>& ok, const Options& options) {
+        unsigned threads = options.threads;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        unsigned sampleThreads = static_cast<unsigned>(std::max<std::size_t>(1, threads / pieces.size()));
+        parallelFor(pieces.size(), threads, [&](std::size_t i) {
+            ok[i] = fitPiece(f, pieces[i], options, sampleThreads);
+        });
+    }
+
+    // 把 body(0), ..., body(n - 1) 按连续的块分给最多threads个线程
+    template <typename Body>
+    static void parallelFor(std::size_t n, unsigned threads, const Body& body) {
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, n));
+        if (threads <= 1) {
+            for (std::size_t i = 0; i < n; ++i) {
+                body(i);
+            }
+            return;
+        }
+        std::vector<std::thread> workers;
+        std::size_t chunk = (n + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; ++t) {
+            std::size_t begin = std::min(n, t * chunk);
+            std::size_t end = std::min(n, begin + chunk);
+            workers.emplace_back([&body, begin, end] {
+                for (std::size_t i = begin; i < end; ++i) {
+                    body(i);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // 在piece的区间上拟合，成功时截掉可以忽略的尾部系数；
+    // 不成功时piece中保留最大次数的系数（不再分段时使用）
+    static bool fitPiece(const Function<T>& f, Piece& piece, const Options& options, unsigned threads) {
+        using std::abs;
+        using std::cos;
+        const T mid = (piece.a + piece.b) / T(2);
+        const T half = (piece.b - piece.a) / T(2);
+        const long double pi = 3.141592653589793238462643383279502884L;
+        const std::size_t maxDegree = std::max(options.maxDegree, kChebyshevMinDegree);
+
+        std::vector<T> values, xs;
+        std::size_t n = kChebyshevMinDegree;
+        for (;; n *= 2) {
+            // 次数加倍时原来的节点是新节点中的偶数号节点，只对奇数号节点求值
+            std::vector<T> next(n + 1);
+            std::size_t first = values.empty() ? 0 : 1;
+            std::size_t step = values.empty() ? 1 : 2;
+            xs.clear();
+            for (std::size_t j = first; j <= n; j += step) {
+                xs.push_back(mid + half * static_cast<T>(cos(pi * static_cast<long double>(j) / n)));
+            }
+            std::vector<T> fx(xs.size());
+            std::size_t blocks = std::min<std::size_t>(threads, xs.size());
+            std::size_t block = (xs.size() + blocks - 1) / blocks;
+            parallelFor(blocks, threads, [&](std::size_t t) {
+                std::size_t begin = std::min(xs.size(), t * block);
+                std::size_t end = std::min(xs.size(), begin + block);
+                f.evaluate(xs.data() + begin, fx.data() + begin, end - begin);
+            });
+            for (std::size_t j = first, m = 0; j <= n; j += step, ++m) {
+                next[j] = fx[m];
+            }
+            for (std::size_t j = 0; first == 1 && j < values.size(); ++j) {
+                next[2 * j] = values[j];
+            }
+            values.swap(next);
+
+            piece.coefficients = coefficients(values);
+            T scale = T(1);
+            for (const T& v : values) {
+                scale = std::max(scale, static_cast<T>(abs(v)));
+            }
+            T target = static_cast<T>(options.tolerance) * scale;
+
+            // 最后1/8的系数（至少3个）都小于误差目标时认为收敛
+            std::size_t tail = std::max<std::size_t>(3, n / 8);
+            bool converged = true;
+            for (std::size_t k = n + 1 - tail; k <= n; ++k) {
+                converged = converged && abs(piece.coefficients[k]) <= target;
+            }
+            if (converged) {
+                // 截掉尾部，截去部分的绝对值之和不超过误差目标
+                T dropped = T();
+                std::size_t size = piece.coefficients.size();
+                while (size > 1 && dropped + abs(piece.coefficients[size - 1]) <= target) {
+                    dropped += abs(piece.coefficients[--size]);
+                }
+                piece.coefficients.resize(size);
+                return true;
+            }
+            if (n * 2 > maxDegree) {
+                return false;
+            }
+        }
+    }
+
+    // 由n + 1个Chebyshev点上的值求系数（第一类离散余弦变换）：
+    // c_k = (2/n) sum'' f_j cos(πjk/n)，首末两项与c_0、c_n减半
+    static std::vector<T> coefficients(const std::vector<T>& values) {
+        using std::cos;
+        const std::size_t n = values.size() - 1;
+        const long double pi = 3.141592653589793238462643383279502884L;
+        std::vector<T> table(2 * n);
+        for (std::size_t m = 0; m < 2 * n; ++m) {
+            table[m] = static_cast<T>(cos(pi * static_cast<long double>(m) / n));
+        }
+        std::vector<T> c(n + 1);
+        for (std::size_t k = 0; k <= n; ++k) {
+            T sum = (values[0] + (k % 2 ? -values[n] : values[n])) / T(2);
+            for (std::size_t j = 1; j < n; ++j) {
+                sum += values[j] * table[(j * k) % (2 * n)];
+            }
+            c[k] = sum * T(2) / static_cast<T>(n);
+        }
+        c[0] /= T(2);
+        c[n] /= T(2);
+        return c;
+    }
+};
+
+#endif // CHEBYSHEV_HPP
@@ -0,0 +1,224 @@
+#ifndef DUAL_HPP
+#define DUAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+// Dual.hpp
+// 前向自动微分用的对偶数 x + sum_k d_k e_k（e_j e_k = 0）
+//
+// Dual<T, N>带N个切方向，一次求值同时得到函数值和N个方向导数。
+// Function<T>对标量类型是模板，所以LinearFunction<Dual<double>>、
+// Polynomial<Dual<double>>等不需要任何修改就能求导数。
+// 嵌套使用Dual<Dual<T>>可以得到二阶导数（见NewtonSolver.hpp中的Halley方法）
+template <typename T, std::size_t N = 1>
+class Dual {
+private:
+    T value_;       // 函数值
+    T tangent_[N];  // 各方向的导数
+
+public:
+    // 常数（导数为0）；可以从T隐式转换，这样系数、常数可以直接参与运算
+    Dual(const T& value = T()) : value_(value) {
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] = T();
+        }
+    }
+
+    // 自变量：第direction个方向的导数为1
+    static Dual variable(const T& value, std::size_t direction = 0) {
+        Dual x(value);
+        x.tangent_[direction] = T(1);
+        return x;
+    }
+
+    // 获取函数值
+    const T& getValue() const {
+        return value_;
+    }
+
+    // 获取第k个方向的导数
+    const T& getTangent(std::size_t k = 0) const {
+        return tangent_[k];
+    }
+
+    void setTangent(std::size_t k, const T& d) {
+        tangent_[k] = d;
+    }
+
+    Dual operator-() const {
+        Dual r;
+        r.value_ = -value_;
+        for (std::size_t k = 0; k < N; ++k) {
+            r.tangent_[k] = -tangent_[k];
+        }
+        return r;
+    }
+
+    Dual& operator+=(const Dual& o) {
+        value_ += o.value_;
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] += o.tangent_[k];
+        }
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& o) {
+        value_ -= o.value_;
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] -= o.tangent_[k];
+        }
+        return *this;
+    }
+
+    // (a + a'e)(b + b'e) = ab + (a'b + ab')e
+    Dual& operator*=(const Dual& o) {
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] = tangent_[k] * o.value_ + value_ * o.tangent_[k];
+        }
+        value_ *= o.value_;
+        return *this;
+    }
+
+    // (a + a'e)/(b + b'e) = a/b + (a' - (a/b) b')/b e
+    Dual& operator/=(const Dual& o) {
+        T inv = T(1) / o.value_;
+        value_ *= inv;
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] = (tangent_[k] - value_ * o.tangent_[k]) * inv;
+        }
+        return *this;
+    }
+
+    // 与标量运算，不需要处理标量的导数
+    Dual& operator+=(const T& s) {
+        value_ += s;
+        return *this;
+    }
+
+    Dual& operator-=(const T& s) {
+        value_ -= s;
+        return *this;
+    }
+
+    Dual& operator*=(const T& s) {
+        value_ *= s;
+        for (std::size_t k = 0; k < N; ++k) {
+            tangent_[k] *= s;
+        }
+        return *this;
+    }
+
+    Dual& operator/=(const T& s) {
+        return *this *= T(1) / s;
+    }
+
+    // 由函数值和导数构造 g(x)，用于实现初等函数：g(a + a'e) = g(a) + g'(a) a' e
+    Dual chain(const T& value, const T& derivative) const {
+        Dual r;
+        r.value_ = value;
+        for (std::size_t k = 0; k < N; ++k) {
+            r.tangent_[k] = derivative * tangent_[k];
+        }
+        return r;
+    }
+};
+
+template <typename T, std::size_t N>
+Dual<T, N> operator+(Dual<T, N> a, const Dual<T, N>& b) { return a += b; }
+template <typename T, std::size_t N>
+Dual<T, N> operator-(Dual<T, N> a, const Dual<T, N>& b) { return a -= b; }
+template <typename T, std::size_t N>
+Dual<T, N> operator*(Dual<T, N> a, const Dual<T, N>& b) { return a *= b; }
+template <typename T, std::size_t N>
+Dual<T, N> operator/(Dual<T, N> a, const Dual<T, N>& b) { return a /= b; }
+
+// 与标量运算：S可以是任何能转换为T的类型（例如Dual<Dual<double>>与double），
+// 这样同一个泛型函数可以用于各层嵌套的Dual
+template <typename S, typename T, std::size_t N>
+using EnableIfScalar = typename std::enable_if<std::is_convertible<S, T>::value &&
+                                               !std::is_same<S, Dual<T, N>>::value, Dual<T, N>>::type;
+
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator+(Dual<T, N> a, const S& s) { return a += T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator+(const S& s, Dual<T, N> a) { return a += T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator-(Dual<T, N> a, const S& s) { return a -= T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator-(const S& s, const Dual<T, N>& a) { return -a + T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator*(Dual<T, N> a, const S& s) { return a *= T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator*(const S& s, Dual<T, N> a) { return a *= T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator/(Dual<T, N> a, const S& s) { return a /= T(s); }
+template <typename T, std::size_t N, typename S>
+EnableIfScalar<S, T, N> operator/(const S& s, const Dual<T, N>& a) { return Dual<T, N>(T(s)) / a; }
+
+// 比较只看函数值
+template <typename T, std::size_t N>
+bool operator==(const Dual<T, N>& a, const Dual<T, N>& b) { return a.getValue() == b.getValue(); }
+template <typename T, std::size_t N>
+bool operator!=(const Dual<T, N>& a, const Dual<T, N>& b) { return a.getValue() != b.getValue(); }
+template <typename T, std::size_t N>
+bool operator<(const Dual<T, N>& a, const Dual<T, N>& b) { return a.getValue() < b.getValue(); }
+template <typename T, std::size_t N>
+bool operator>(const Dual<T, N>& a, const Dual<T, N>& b) { return a.getValue() > b.getValue(); }
+
+// 初等函数，通过ADL找到；对嵌套的Dual会递归地调用内层的同名函数
+template <typename T, std::size_t N>
+Dual<T, N> sqrt(const Dual<T, N>& a) {
+    using std::sqrt;
+    T s = sqrt(a.getValue());
+    return a.chain(s, T(1) / (s + s));
+}
+
+template <typename T, std::size_t N>
+Dual<T, N> exp(const Dual<T, N>& a) {
+    using std::exp;
+    T e = exp(a.getValue());
+    return a.chain(e, e);
+}
+
+template <typename T, std::size_t N>
+Dual<T, N> log(const Dual<T, N>& a) {
+    using std::log;
+    return a.chain(log(a.getValue()), T(1) / a.getValue());
+}
+
+template <typename T, std::size_t N>
+Dual<T, N> sin(const Dual<T, N>& a) {
+    using std::sin;
+    using std::cos;
+    return a.chain(sin(a.getValue()), cos(a.getValue()));
+}
+
+template <typename T, std::size_t N>
+Dual<T, N> cos(const Dual<T, N>& a) {
+    using std::sin;
+    using std::cos;
+    return a.chain(cos(a.getValue()), -sin(a.getValue()));
+}
+
+// a^p，p为实数
+template <typename T, std::size_t N>
+Dual<T, N> pow(const Dual<T, N>& a, double p) {
+    using std::pow;
+    T r = pow(a.getValue(), p);
+    return a.chain(r, T(p) * pow(a.getValue(), p - 1.0));
+}
+
+// 输出为 value + [d_0, d_1, ...]ε
+template <typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& os, const Dual<T, N>& a) {
+    os << a.getValue() << " + [";
+    for (std::size_t k = 0; k < N; ++k) {
+        os << (k ? ", " : "") << a.getTangent(k);
+    }
+    return os << "]ε";
+}
+
+#endif // DUAL_HPP
@@ -0,0 +1,396 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include "Function.hpp"
+#include "LinearFunction.hpp"
+#include "Polynomial.hpp"
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Expression.hpp
+// 基于CRTP的表达式模板：函数之间的 +、-、*、复合在编译期组合成一个类型，
+// 求值时整个表达式被内联，没有虚函数调用。
+// 批量求值按固定大小的块进行：每个节点对整块做一个循环次数固定的循环，
+// 中间结果留在栈上的小数组里（L1缓存），编译器可以把每个循环向量化。
+//
+//   Polynomial<double> p({1.0, 2.0, 3.0});
+//   LinearFunction<double> l(2.0, 1.0);
+//   auto h = makeExpr(p)(makeExpr(l)) * 2.0 + makeLambdaExpr<double>([](double x) { return x * x; });
+//   h(0.5);                          // 单点求值
+//   h.evaluate(xs, out, n);          // 批量求值，内联的循环
+//   ExprFunction<decltype(h), double> f(h);   // 需要Function<double>接口时使用
+
+// 所有表达式的基类，E是派生类，T是值类型
+// 派生类提供：
+//   T eval(T x) const                      单点求值
+//   void evalBlock(const T* x, T* out) const  对kBlock个点求值，x与out不重叠
+template <typename E, typename T>
+class Expr {
+public:
+    static constexpr std::size_t kBlock = 64;
+
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+
+    // 单点求值
+    T operator()(T x) const {
+        return self().eval(x);
+    }
+
+    // 复合：f(g) 得到 x -> f(g(x))
+    template <typename G>
+    auto operator()(const Expr<G, T>& g) const;
+
+    // 批量求值，out可以与xs相同
+    void evaluate(const T* xs, T* out, std::size_t n) const {
+        const E& e = self();
+        T x[kBlock];
+        T y[kBlock];
+        for (std::size_t start = 0; start < n; start += kBlock) {
+            std::size_t m = (n - start < kBlock) ? n - start : kBlock;
+            for (std::size_t j = 0; j < m; ++j) {
+                x[j] = xs[start + j];
+            }
+            // 最后一块不满时用最后一个点补齐，保证补齐的点也在定义域内
+            for (std::size_t j = m; j < kBlock; ++j) {
+                x[j] = x[m - 1];
+            }
+            e.evalBlock(x, y);
+            for (std::size_t j = 0; j < m; ++j) {
+                out[start + j] = y[j];
+            }
+        }
+    }
+};
+
+// 自变量 x
+template <typename T>
+class IdentityExpr : public Expr<IdentityExpr<T>, T> {
+public:
+    T eval(T x) const {
+        return x;
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = x[j];
+        }
+    }
+};
+
+// 常数
+template <typename T>
+class ConstantExpr : public Expr<ConstantExpr<T>, T> {
+private:
+    T value_;
+
+public:
+    explicit ConstantExpr(const T& value) : value_(value) {}
+
+    T eval(T) const {
+        return value_;
+    }
+
+    void evalBlock(const T*, T* out) const {
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = value_;
+        }
+    }
+};
+
+// 线性函数 ax + b
+template <typename T>
+class LinearExpr : public Expr<LinearExpr<T>, T> {
+private:
+    T a_; // 斜率
+    T b_; // 截距
+
+public:
+    LinearExpr(const T& a, const T& b) : a_(a), b_(b) {}
+
+    explicit LinearExpr(const LinearFunction<T>& f) : a_(f.getSlope()), b_(f.getIntercept()) {}
+
+    T eval(T x) const {
+        return a_ * x + b_;
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = a_ * x[j] + b_;
+        }
+    }
+};
+
+// 多项式，用秦九韶算法求值；保存系数的副本，不依赖原对象的生命周期
+template <typename T>
+class PolynomialExpr : public Expr<PolynomialExpr<T>, T> {
+private:
+    std::vector<T> coefficients_; // 系数，从a_0到a_n
+
+public:
+    explicit PolynomialExpr(const std::vector<T>& coefficients) : coefficients_(coefficients) {}
+
+    explicit PolynomialExpr(const Polynomial<T>& p) : coefficients_(p.getCoefficients()) {}
+
+    T eval(T x) const {
+        T result = T();
+        for (std::size_t i = coefficients_.size(); i-- > 0;) {
+            result = result * x + coefficients_[i];
+        }
+        return result;
+    }
+
+    // 块内各点同时做秦九韶迭代
+    void evalBlock(const T* x, T* out) const {
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = T();
+        }
+        for (std::size_t i = coefficients_.size(); i-- > 0;) {
+            const T c = coefficients_[i];
+            for (std::size_t j = 0; j < this->kBlock; ++j) {
+                out[j] = out[j] * x[j] + c;
+            }
+        }
+    }
+};
+
+// 任意可调用对象（lambda、函数对象），直接内联
+template <typename T, typename F>
+class LambdaExpr : public Expr<LambdaExpr<T, F>, T> {
+private:
+    F f_;
+
+public:
+    explicit LambdaExpr(F f) : f_(std::move(f)) {}
+
+    T eval(T x) const {
+        return f_(x);
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = f_(x[j]);
+        }
+    }
+};
+
+// 引用一个已有的Function<T>对象，每个点一次虚函数调用
+// 用来把虚接口的函数接入表达式；被引用的对象必须比表达式活得久
+template <typename T>
+class FunctionRef : public Expr<FunctionRef<T>, T> {
+private:
+    const Function<T>* f_;
+
+public:
+    explicit FunctionRef(const Function<T>& f) : f_(&f) {}
+
+    T eval(T x) const {
+        return (*f_)(x);
+    }
+
+    // 每块一次虚函数调用
+    void evalBlock(const T* x, T* out) const {
+        f_->evaluate(x, out, this->kBlock);
+    }
+};
+
+// 二元运算节点，子表达式按值保存
+template <typename L, typename R, typename T>
+class SumExpr : public Expr<SumExpr<L, R, T>, T> {
+private:
+    L l_;
+    R r_;
+
+public:
+    SumExpr(const L& l, const R& r) : l_(l), r_(r) {}
+
+    T eval(T x) const {
+        return l_.eval(x) + r_.eval(x);
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        T tmp[this->kBlock];
+        l_.evalBlock(x, out);
+        r_.evalBlock(x, tmp);
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = out[j] + tmp[j];
+        }
+    }
+};
+
+template <typename L, typename R, typename T>
+class DifferenceExpr : public Expr<DifferenceExpr<L, R, T>, T> {
+private:
+    L l_;
+    R r_;
+
+public:
+    DifferenceExpr(const L& l, const R& r) : l_(l), r_(r) {}
+
+    T eval(T x) const {
+        return l_.eval(x) - r_.eval(x);
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        T tmp[this->kBlock];
+        l_.evalBlock(x, out);
+        r_.evalBlock(x, tmp);
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = out[j] - tmp[j];
+        }
+    }
+};
+
+template <typename L, typename R, typename T>
+class ProductExpr : public Expr<ProductExpr<L, R, T>, T> {
+private:
+    L l_;
+    R r_;
+
+public:
+    ProductExpr(const L& l, const R& r) : l_(l), r_(r) {}
+
+    T eval(T x) const {
+        return l_.eval(x) * r_.eval(x);
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        T tmp[this->kBlock];
+        l_.evalBlock(x, out);
+        r_.evalBlock(x, tmp);
+        for (std::size_t j = 0; j < this->kBlock; ++j) {
+            out[j] = out[j] * tmp[j];
+        }
+    }
+};
+
+// 复合 outer(inner(x))
+template <typename Outer, typename Inner, typename T>
+class ComposeExpr : public Expr<ComposeExpr<Outer, Inner, T>, T> {
+private:
+    Outer outer_;
+    Inner inner_;
+
+public:
+    ComposeExpr(const Outer& outer, const Inner& inner) : outer_(outer), inner_(inner) {}
+
+    T eval(T x) const {
+        return outer_.eval(inner_.eval(x));
+    }
+
+    void evalBlock(const T* x, T* out) const {
+        T tmp[this->kBlock];
+        inner_.evalBlock(x, tmp);
+        outer_.evalBlock(tmp, out);
+    }
+};
+
+template <typename E, typename T>
+template <typename G>
+auto Expr<E, T>::operator()(const Expr<G, T>& g) const {
+    return ComposeExpr<E, G, T>(self(), g.self());
+}
+
+// 复合的函数写法，与 f(g) 相同
+template <typename F, typename G, typename T>
+ComposeExpr<F, G, T> compose(const Expr<F, T>& f, const Expr<G, T>& g) {
+    return ComposeExpr<F, G, T>(f.self(), g.self());
+}
+
+// 表达式之间的运算符
+template <typename L, typename R, typename T>
+SumExpr<L, R, T> operator+(const Expr<L, T>& l, const Expr<R, T>& r) {
+    return SumExpr<L, R, T>(l.self(), r.self());
+}
+
+template <typename L, typename R, typename T>
+DifferenceExpr<L, R, T> operator-(const Expr<L, T>& l, const Expr<R, T>& r) {
+    return DifferenceExpr<L, R, T>(l.self(), r.self());
+}
+
+template <typename L, typename R, typename T>
+ProductExpr<L, R, T> operator*(const Expr<L, T>& l, const Expr<R, T>& r) {
+    return ProductExpr<L, R, T>(l.self(), r.self());
+}
+
+// 表达式与常数的运算符
+template <typename L, typename T>
+SumExpr<L, ConstantExpr<T>, T> operator+(const Expr<L, T>& l, const T& c) {
+    return SumExpr<L, ConstantExpr<T>, T>(l.self(), ConstantExpr<T>(c));
+}
+
+template <typename R, typename T>
+SumExpr<ConstantExpr<T>, R, T> operator+(const T& c, const Expr<R, T>& r) {
+    return SumExpr<ConstantExpr<T>, R, T>(ConstantExpr<T>(c), r.self());
+}
+
+template <typename L, typename T>
+DifferenceExpr<L, ConstantExpr<T>, T> operator-(const Expr<L, T>& l, const T& c) {
+    return DifferenceExpr<L, ConstantExpr<T>, T>(l.self(), ConstantExpr<T>(c));
+}
+
+template <typename R, typename T>
+DifferenceExpr<ConstantExpr<T>, R, T> operator-(const T& c, const Expr<R, T>& r) {
+    return DifferenceExpr<ConstantExpr<T>, R, T>(ConstantExpr<T>(c), r.self());
+}
+
+template <typename L, typename T>
+ProductExpr<L, ConstantExpr<T>, T> operator*(const Expr<L, T>& l, const T& c) {
+    return ProductExpr<L, ConstantExpr<T>, T>(l.self(), ConstantExpr<T>(c));
+}
+
+template <typename R, typename T>
+ProductExpr<ConstantExpr<T>, R, T> operator*(const T& c, const Expr<R, T>& r) {
+    return ProductExpr<ConstantExpr<T>, R, T>(ConstantExpr<T>(c), r.self());
+}
+
+// 从已有的类构造表达式
+template <typename T>
+LinearExpr<T> makeExpr(const LinearFunction<T>& f) {
+    return LinearExpr<T>(f);
+}
+
+template <typename T>
+PolynomialExpr<T> makeExpr(const Polynomial<T>& p) {
+    return PolynomialExpr<T>(p);
+}
+
+template <typename T, typename F>
+LambdaExpr<T, F> makeLambdaExpr(F f) {
+    return LambdaExpr<T, F>(std::move(f));
+}
+
+template <typename T>
+FunctionRef<T> makeFunctionRef(const Function<T>& f) {
+    return FunctionRef<T>(f);
+}
+
+// 把表达式包装成Function<T>，供只接受虚接口的代码使用
+// 单点调用是一次虚函数调用；evaluate每批只有一次虚函数调用，内部仍是内联的块循环
+template <typename E, typename T>
+class ExprFunction : public Function<T> {
+private:
+    E expr_;
+
+public:
+    explicit ExprFunction(const Expr<E, T>& expr) : expr_(expr.self()) {}
+
+    T operator()(T x) const override {
+        return expr_.eval(x);
+    }
+
+    void evaluate(const T* xs, T* out, std::size_t n) const override {
+        expr_.evaluate(xs, out, n);
+    }
+};
+
+// 类型擦除：返回一个持有表达式的Function<T>对象
+template <typename E, typename T>
+std::unique_ptr<Function<T>> makeFunction(const Expr<E, T>& expr) {
+    return std::unique_ptr<Function<T>>(new ExprFunction<E, T>(expr));
+}
+
+#endif // EXPRESSION_HPP
@@ -0,0 +1,227 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// FFT.hpp
+// 多项式乘法用的快速变换：
+//   - 复数FFT（double精度），用于double和std::complex<double>系数
+//   - 三个素数上的数论变换(NTT)加中国剩余定理，用于整数系数，结果精确
+
+// 不小于n的最小的2的幂
+inline std::size_t nextPowerOfTwo(std::size_t n) {
+    std::size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// 位逆序重排，a.size()必须是2的幂
+template <typename V>
+void bitReversePermute(std::vector<V>& a) {
+    std::size_t n = a.size();
+    for (std::size_t i = 1, j = 0; i < n; ++i) {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+}
+
+// 原地迭代基2复数FFT，a.size()必须是2的幂；inverse为true时计算逆变换（含1/n）
+// 旋转因子直接用cos/sin计算，而不是递推相乘，避免误差随长度累积
+inline void fft(std::vector<std::complex<double>>& a, bool inverse) {
+    std::size_t n = a.size();
+    if (n <= 1) {
+        return;
+    }
+    bitReversePermute(a);
+
+    const double pi = std::acos(-1.0);
+    std::vector<std::complex<double>> roots(n / 2);
+    for (std::size_t k = 0; k < n / 2; ++k) {
+        double angle = 2.0 * pi * static_cast<double>(k) / static_cast<double>(n);
+        roots[k] = std::complex<double>(std::cos(angle), inverse ? std::sin(angle) : -std::sin(angle));
+    }
+
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+        std::size_t half = len / 2;
+        std::size_t step = n / len;
+        for (std::size_t start = 0; start < n; start += len) {
+            for (std::size_t k = 0; k < half; ++k) {
+                std::complex<double> u = a[start + k];
+                std::complex<double> v = a[start + k + half] * roots[k * step];
+                a[start + k] = u + v;
+                a[start + k + half] = u - v;
+            }
+        }
+    }
+
+    if (inverse) {
+        double scale = 1.0 / static_cast<double>(n);
+        for (std::complex<double>& v : a) {
+            v *= scale;
+        }
+    }
+}
+
+// 用FFT计算两个复系数多项式的乘积，结果有n + m - 1项
+inline std::vector<std::complex<double>> fftMultiply(const std::complex<double>* a, std::size_t n,
+                                                     const std::complex<double>* b, std::size_t m) {
+    if (n == 0 || m == 0) {
+        return std::vector<std::complex<double>>();
+    }
+    std::size_t size = nextPowerOfTwo(n + m - 1);
+    std::vector<std::complex<double>> fa(a, a + n), fb(b, b + m);
+    fa.resize(size);
+    fb.resize(size);
+    fft(fa, false);
+    fft(fb, false);
+    for (std::size_t i = 0; i < size; ++i) {
+        fa[i] *= fb[i];
+    }
+    fft(fa, true);
+    fa.resize(n + m - 1);
+    return fa;
+}
+
+// 数论变换使用的素数 p = c * 2^k + 1 及其原根
+struct NTTPrime {
+    std::uint32_t mod;
+    std::uint32_t root;
+    unsigned maxLog; // 支持的最大变换长度 2^maxLog
+};
+
+inline const NTTPrime* nttPrimes() {
+    static const NTTPrime primes[3] = {
+        {998244353u, 3u, 23}, // 119 * 2^23 + 1
+        {167772161u, 3u, 25}, // 5 * 2^25 + 1
+        {469762049u, 3u, 26}  // 7 * 2^26 + 1
+    };
+    return primes;
+}
+
+// NTT支持的最大乘积长度
+constexpr std::size_t kNTTMaxLength = std::size_t(1) << 23;
+
+inline std::uint32_t powMod(std::uint64_t base, std::uint64_t exp, std::uint32_t mod) {
+    std::uint64_t result = 1;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) {
+            result = result * base % mod;
+        }
+        base = base * base % mod;
+        exp >>= 1;
+    }
+    return static_cast<std::uint32_t>(result);
+}
+
+// 原地数论变换，a.size()必须是2的幂且不超过2^prime.maxLog
+inline void ntt(std::vector<std::uint32_t>& a, const NTTPrime& prime, bool inverse) {
+    std::size_t n = a.size();
+    if (n <= 1) {
+        return;
+    }
+    const std::uint32_t mod = prime.mod;
+    bitReversePermute(a);
+
+    std::vector<std::uint32_t> roots(n / 2);
+    std::uint32_t w = powMod(prime.root, (mod - 1) / n, mod);
+    if (inverse) {
+        w = powMod(w, mod - 2, mod);
+    }
+    roots[0] = 1;
+    for (std::size_t k = 1; k < n / 2; ++k) {
+        roots[k] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(roots[k - 1]) * w % mod);
+    }
+
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+        std::size_t half = len / 2;
+        std::size_t step = n / len;
+        for (std::size_t start = 0; start < n; start += len) {
+            for (std::size_t k = 0; k < half; ++k) {
+                std::uint32_t u = a[start + k];
+                std::uint32_t v = static_cast<std::uint32_t>(
+                    static_cast<std::uint64_t>(a[start + k + half]) * roots[k * step] % mod);
+                std::uint32_t sum = u + v;
+                a[start + k] = sum >= mod ? sum - mod : sum;
+                a[start + k + half] = u >= v ? u - v : u + mod - v;
+            }
+        }
+    }
+
+    if (inverse) {
+        std::uint64_t nInv = powMod(n, mod - 2, mod);
+        for (std::uint32_t& v : a) {
+            v = static_cast<std::uint32_t>(v * nInv % mod);
+        }
+    }
+}
+
+// 用三个素数上的NTT和中国剩余定理计算整数多项式的乘积
+// 要求 |a_i|, |b_j| < 2^31 且 n + m - 1 <= kNTTMaxLength，此时每个结果系数
+// 的绝对值小于 2^85，而三个素数之积约为 2^86.0，所以恢复出的结果是精确的。
+// 结果可能超出long long的范围，所以以__int128返回
+inline std::vector<__int128> nttMultiply(const long long* a, std::size_t n,
+                                         const long long* b, std::size_t m) {
+    if (n == 0 || m == 0) {
+        return std::vector<__int128>();
+    }
+    std::size_t size = nextPowerOfTwo(n + m - 1);
+    const NTTPrime* primes = nttPrimes();
+
+    std::vector<std::uint32_t> residues[3];
+    for (int p = 0; p < 3; ++p) {
+        const std::uint32_t mod = primes[p].mod;
+        auto reduce = [mod](long long v) {
+            long long r = v % static_cast<long long>(mod);
+            return static_cast<std::uint32_t>(r < 0 ? r + mod : r);
+        };
+        std::vector<std::uint32_t> fa(size, 0), fb(size, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            fa[i] = reduce(a[i]);
+        }
+        for (std::size_t i = 0; i < m; ++i) {
+            fb[i] = reduce(b[i]);
+        }
+        ntt(fa, primes[p], false);
+        ntt(fb, primes[p], false);
+        for (std::size_t i = 0; i < size; ++i) {
+            fa[i] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(fa[i]) * fb[i] % mod);
+        }
+        ntt(fa, primes[p], true);
+        residues[p].swap(fa);
+    }
+
+    // Garner算法：x = r0 + m0 * (k1 + m1 * k2)，再映射到对称区间
+    const std::uint64_t m0 = primes[0].mod, m1 = primes[1].mod, m2 = primes[2].mod;
+    const std::uint64_t m0InvMod1 = powMod(m0, m1 - 2, static_cast<std::uint32_t>(m1));
+    const std::uint64_t m01InvMod2 = powMod(m0 * m1 % m2, m2 - 2, static_cast<std::uint32_t>(m2));
+    const __int128 modulus = static_cast<__int128>(m0) * m1 * m2;
+
+    std::vector<__int128> result(n + m - 1);
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        std::uint64_t r0 = residues[0][i], r1 = residues[1][i], r2 = residues[2][i];
+        std::uint64_t k1 = (r1 + m1 - r0 % m1) % m1 * m0InvMod1 % m1;
+        std::uint64_t x01 = r0 + m0 * k1; // < m0 * m1 < 2^58
+        std::uint64_t k2 = (r2 + m2 - x01 % m2) % m2 * m01InvMod2 % m2;
+        __int128 x = static_cast<__int128>(x01) + static_cast<__int128>(m0 * m1) * k2;
+        if (x > modulus / 2) {
+            x -= modulus;
+        }
+        result[i] = x;
+    }
+    return result;
+}
+
+#endif // FFT_HPP
@@ -0,0 +1,118 @@
+#ifndef FIXED_POLYNOMIAL_HPP
+#define FIXED_POLYNOMIAL_HPP
+
+#include "Function.hpp"
+#include "Polynomial.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// FixedPolynomial.hpp
+// 次数在编译期确定的多项式
+//
+// 系数存放在std::array中，构造和求值都是constexpr，可以用于常量表达式；
+// 秦九韶算法用折叠表达式在编译期完全展开，没有循环，内联后与手写的乘加相同。
+// Function<T>有虚析构函数，不是字面类型，所以FixedPolynomial本身不继承Function<T>；
+// 需要通过虚接口使用时用FixedPolynomialFunction（或makeFunction）包装
+template <typename T, std::size_t Degree>
+class FixedPolynomial {
+private:
+    std::array<T, Degree + 1> coefficients_; // 系数，从a_0到a_n
+
+public:
+    // 由系数数组构造（从常数项开始）
+    constexpr explicit FixedPolynomial(const std::array<T, Degree + 1>& coefficients)
+        : coefficients_(coefficients) {}
+
+    // 由Degree + 1个系数构造，例如 FixedPolynomial<double, 2>(1.0, 2.0, 3.0) 表示 3x^2 + 2x + 1
+    template <typename... Args,
+              typename = typename std::enable_if<sizeof...(Args) == Degree + 1>::type>
+    constexpr explicit FixedPolynomial(const Args&... coefficients)
+        : coefficients_{{static_cast<T>(coefficients)...}} {}
+
+    // 计算多项式值（展开的秦九韶算法）
+    constexpr T operator()(T x) const {
+        return horner(x, std::make_index_sequence<Degree>());
+    }
+
+    // 导数，次数减1（0次多项式的导数仍为0次的0）
+    constexpr FixedPolynomial<T, (Degree > 0 ? Degree - 1 : 0)> derivative() const {
+        return derivative(std::make_index_sequence<(Degree > 0 ? Degree : 1)>());
+    }
+
+    // 获取多项式的次数
+    static constexpr std::size_t getDegree() {
+        return Degree;
+    }
+
+    // 获取系数数组
+    constexpr const std::array<T, Degree + 1>& getCoefficients() const {
+        return coefficients_;
+    }
+
+    // 转换为运行时的Polynomial<T>
+    Polynomial<T> toPolynomial() const {
+        return Polynomial<T>(std::vector<T>(coefficients_.begin(), coefficients_.end()));
+    }
+
+private:
+    // r = a_n; r = r * x + a_{n-1}; ...; r = r * x + a_0
+    template <std::size_t... I>
+    constexpr T horner(T x, std::index_sequence<I...>) const {
+        T r = coefficients_[Degree];
+        ((r = r * x + coefficients_[Degree - 1 - I]), ...);
+        static_cast<void>(x); // 0次时x不参与运算
+        return r;
+    }
+
+    // (k + 1) a_{k+1}
+    template <std::size_t... I>
+    constexpr FixedPolynomial<T, (Degree > 0 ? Degree - 1 : 0)> derivative(std::index_sequence<I...>) const {
+        if constexpr (Degree == 0) {
+            return FixedPolynomial<T, 0>(T());
+        } else {
+            return FixedPolynomial<T, Degree - 1>(coefficients_[I + 1] * static_cast<T>(I + 1)...);
+        }
+    }
+};
+
+// 由系数推导类型：FixedPolynomial p(1.0, 2.0, 3.0) 为 FixedPolynomial<double, 2>
+template <typename T, typename... Rest>
+FixedPolynomial(const T&, const Rest&...) -> FixedPolynomial<T, sizeof...(Rest)>;
+
+// 通过Function<T>接口使用FixedPolynomial，可以与Polynomial<T>互换
+template <typename T, std::size_t Degree>
+class FixedPolynomialFunction : public Function<T> {
+private:
+    FixedPolynomial<T, Degree> polynomial_;
+
+public:
+    explicit FixedPolynomialFunction(const FixedPolynomial<T, Degree>& p) : polynomial_(p) {}
+
+    T operator()(T x) const override {
+        return polynomial_(x);
+    }
+
+    // 循环体是展开的乘加，编译器可以跨点向量化
+    void evaluate(const T* xs, T* out, std::size_t n) const override {
+        const FixedPolynomial<T, Degree> p = polynomial_;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = p(xs[i]);
+        }
+    }
+
+    const FixedPolynomial<T, Degree>& getPolynomial() const {
+        return polynomial_;
+    }
+};
+
+// 类型擦除：返回一个持有FixedPolynomial的Function<T>对象
+template <typename T, std::size_t Degree>
+std::unique_ptr<Function<T>> makeFunction(const FixedPolynomial<T, Degree>& p) {
+    return std::unique_ptr<Function<T>>(new FixedPolynomialFunction<T, Degree>(p));
+}
+
+#endif // FIXED_POLYNOMIAL_HPP
@@ -1,12 +1,23 @@
 #ifndef FUNCTION_HPP
 #define FUNCTION_HPP
 
+#include <cstddef>
+
 // Function.hpp
 template <typename T>
 class Function {
 public:
   virtual T operator()(T x) const = 0; // 纯虚函数，用来计算函数值
   virtual ~Function() = default; // 虚析构函数，确保派生类能正确析构
+
+  // 批量计算：对连续的n个输入xs求值，结果写入调用方提供的out（可以与xs相同）
+  // 默认实现逐点调用operator()；派生类可以重写为可向量化的循环，
+  // 这样虚函数调用每批只发生一次，而不是每个点一次
+  virtual void evaluate(const T* xs, T* out, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = (*this)(xs[i]);
+    }
+  }
 };
 
 #endif // FUNCTION_HPP
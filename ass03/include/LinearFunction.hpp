@@ -20,6 +20,15 @@ public:
         return a_ * x + b_;
     }
 
+    // 批量计算 f(x) = ax + b，循环体没有函数调用，编译器可以自动向量化
+    void evaluate(const T* xs, T* out, std::size_t n) const override {
+        const T a = a_;
+        const T b = b_;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = a * xs[i] + b;
+        }
+    }
+
     // 获取斜率
     T getSlope() const {
         return a_;
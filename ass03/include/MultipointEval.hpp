@@ -0,0 +1,398 @@
+#ifndef MULTIPOINT_EVAL_HPP
+#define MULTIPOINT_EVAL_HPP
+
+#include "Polynomial.hpp"
+#include "PolynomialArithmetic.hpp"
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// MultipointEval.hpp
+// 基于子乘积树(subproduct tree)的快速多点求值与插值，O(n log^2 n)
+//
+//   - 子乘积树：叶子是一组点的 prod (x - x_i)，内部结点是两个孩子的乘积
+//   - 求值：p mod M_root，再自顶向下对左右孩子取余，到叶子时余式次数很低，
+//     直接用秦九韶算法在叶子的各点求值。取余用Newton迭代求倒序除式的逆，
+//     把除法变成两次乘法，从而用上PolynomialArithmetic.hpp的快速乘法
+//   - 插值：w_i = M'(x_i)（多点求值），再自底向上合并 sum (y_i / w_i) M(x) / (x - x_i)
+//   - 规模小于kMultipointMinSize时直接用Polynomial::evaluate（秦九韶算法）或O(n^2)的Newton插值
+//
+// 数值稳定性：子乘积树的系数随点的分布可能急剧增大。对复数点，建树前按辐角排序并
+// 奇偶交错分组（与FFT的位逆序相同），每棵子树的点都均匀分布在圆周上，单位圆附近的点
+// 即使n很大也很稳定；实数区间上的大量点则本质上是病态的，此时应使用精确类型
+// （int、mpz_class、mpq_class等）。浮点系数时树中系数增长超过kMultipointMaxGrowth，
+// 求值退回秦九韶算法，插值退回Newton插值，都是O(n^2)。插值需要除法，要求系数类型是域
+
+// 叶子上的点数：叶子内直接用O(k^2)的方法
+constexpr std::size_t kMultipointLeafSize = 32;
+// 点数或项数小于这个值时直接用秦九韶算法（由bench测得）
+constexpr std::size_t kMultipointMinSize = 2048;
+// 商的项数小于这个值时取余用普通长除法
+constexpr std::size_t kFastRemainderMinSize = 64;
+// 浮点系数时子乘积树系数绝对值的上限，超过时multipointEvaluate退回秦九韶算法，插值退回Newton插值
+constexpr double kMultipointMaxGrowth = 1e4;
+
+// O(n^2)的Newton插值：先求差商，再从最内层展开为系数，点必须互不相同。
+// 不经过子乘积树，用于规模较小或浮点系数时树中系数增长过大的情况
+template <typename T>
+Polynomial<T> newtonInterpolate(const std::vector<T>& points, const std::vector<T>& values) {
+    if (values.size() != points.size()) {
+        throw std::invalid_argument("interpolate: number of values does not match number of points");
+    }
+    std::size_t n = points.size();
+    if (n == 0) {
+        return Polynomial<T>(std::vector<T>(1, T()));
+    }
+
+    // 差商：diff[k] = f[x_0, ..., x_k]
+    std::vector<T> diff = values;
+    for (std::size_t j = 1; j < n; ++j) {
+        for (std::size_t i = n - 1; i >= j; --i) {
+            T gap = points[i] - points[i - j];
+            if (gap == T()) {
+                throw std::domain_error("interpolate: interpolation points must be distinct");
+            }
+            diff[i] = (diff[i] - diff[i - 1]) / gap;
+        }
+    }
+
+    // f = diff[0] + (x - x_0)(diff[1] + (x - x_1)(...))，从内向外乘开
+    std::vector<T> c(1, diff[n - 1]);
+    for (std::size_t k = n - 1; k-- > 0;) {
+        // c = c * (x - x_k) + diff[k]
+        c.push_back(T());
+        for (std::size_t j = c.size() - 1; j > 0; --j) {
+            c[j] = c[j - 1] - points[k] * c[j];
+        }
+        c[0] = diff[k] - points[k] * c[0];
+    }
+    trimCoefficients(c);
+    return Polynomial<T>(c);
+}
+
+// f的逆 mod x^n（Newton迭代 g <- g (2 - f g)，每轮精度翻倍），要求f[0]可逆
+template <typename T>
+std::vector<T> inverseSeries(const std::vector<T>& f, std::size_t n) {
+    std::vector<T> g(1, T(1) / f[0]);
+    for (std::size_t k = 1; k < n;) {
+        k = std::min(2 * k, n);
+        std::vector<T> head(f.begin(), f.begin() + std::min(k, f.size()));
+        std::vector<T> e = multiplyCoefficients(head, g);
+        e.resize(k);
+        for (T& v : e) {
+            v = -v;
+        }
+        e[0] += T(2);
+        g = multiplyCoefficients(g, e);
+        g.resize(k);
+    }
+    return g;
+}
+
+template <typename T>
+class SubproductTree {
+private:
+    struct Node {
+        std::size_t begin, end;   // 覆盖的点（按树中顺序）
+        std::size_t left, right;  // 孩子下标，叶子为0
+        std::vector<T> product;   // prod (x - x_i)，首项系数为1
+        std::vector<T> inverse;   // 倒序product的逆，长度等于父结点与本结点次数之差（用于取余）
+    };
+
+    std::vector<T> points_;          // 按树中顺序排列的点
+    std::vector<std::size_t> order_; // order_[k]是树中第k个点在输入中的下标
+    std::vector<Node> nodes_;        // nodes_[0]是根
+    double growth_;                  // 所有结点系数绝对值的最大值（只对内置浮点和复数类型计算）
+
+public:
+    // 由求值点建树，points可以有重复（插值时不可以）
+    explicit SubproductTree(const std::vector<T>& points) : growth_(1.0) {
+        order_.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            order_[i] = i;
+        }
+        if constexpr (IsComplex<T>::value) {
+            std::sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+                return std::arg(points[a]) < std::arg(points[b]);
+            });
+            std::vector<std::size_t> spread;
+            spread.reserve(order_.size());
+            interleave(order_, spread);
+            order_.swap(spread);
+        }
+        points_.resize(points.size());
+        for (std::size_t k = 0; k < points.size(); ++k) {
+            points_[k] = points[order_[k]];
+        }
+        if (!points_.empty()) {
+            nodes_.reserve(2 * (points_.size() / kMultipointLeafSize + 1));
+            build(0, points_.size());
+            prepareInverses(0);
+        }
+    }
+
+    // 点数
+    std::size_t size() const {
+        return points_.size();
+    }
+
+    // 树中系数绝对值的最大值：取余时的舍入误差大致按这个倍数放大。
+    // 只对内置浮点和复数类型计算，其他类型返回1
+    double getGrowth() const {
+        return growth_;
+    }
+
+    // 所有点的乘积 M(x) = prod (x - x_i)
+    Polynomial<T> getProduct() const {
+        return Polynomial<T>(nodes_.empty() ? std::vector<T>(1, T(1)) : nodes_[0].product);
+    }
+
+    // 在所有点上求值，结果按输入点的顺序排列
+    std::vector<T> evaluate(const Polynomial<T>& p) const {
+        std::vector<T> values(points_.size());
+        if (points_.empty()) {
+            return values;
+        }
+        std::vector<T> c = p.getCoefficients();
+        trimCoefficients(c);
+        const std::vector<T>& m = nodes_[0].product;
+        std::vector<T> inverse;
+        if (quotientSize(c, m) >= kFastRemainderMinSize) {
+            inverse = inverseSeries(reversed(m), quotientSize(c, m));
+        }
+        std::vector<T> treeOrder(points_.size());
+        descend(0, remainder(c, m, inverse), treeOrder.data());
+        for (std::size_t k = 0; k < points_.size(); ++k) {
+            values[order_[k]] = treeOrder[k];
+        }
+        return values;
+    }
+
+    // 求次数小于size()的多项式f，使f(x_i) = values[i]；点必须互不相同。
+    // 只有精确类型或树中系数增长不超过kMultipointMaxGrowth（如单位圆附近的复数点）时才用子乘积树，
+    // 否则（如实数区间上的大量浮点点）退回O(n^2)的newtonInterpolate
+    Polynomial<T> interpolate(const std::vector<T>& values) const {
+        if (values.size() != points_.size()) {
+            throw std::invalid_argument("interpolate: number of values does not match number of points");
+        }
+        if (points_.empty()) {
+            return Polynomial<T>(std::vector<T>(1, T()));
+        }
+        if (growth_ > kMultipointMaxGrowth) {
+            std::vector<T> treeValues(points_.size());
+            for (std::size_t k = 0; k < points_.size(); ++k) {
+                treeValues[k] = values[order_[k]];
+            }
+            return newtonInterpolate(points_, treeValues);
+        }
+
+        // w_i = M'(x_i)
+        const std::vector<T>& m = nodes_[0].product;
+        std::vector<T> derivative(m.size() - 1);
+        for (std::size_t i = 1; i < m.size(); ++i) {
+            derivative[i - 1] = m[i] * T(static_cast<int>(i));
+        }
+        std::vector<T> weights = evaluate(Polynomial<T>(derivative));
+
+        std::vector<T> scaled(points_.size());
+        for (std::size_t k = 0; k < points_.size(); ++k) {
+            const T& w = weights[order_[k]];
+            if (w == T()) {
+                throw std::domain_error("interpolate: interpolation points must be distinct");
+            }
+            scaled[k] = values[order_[k]] / w;
+        }
+
+        std::vector<T> c = combine(0, scaled);
+        trimCoefficients(c);
+        return Polynomial<T>(c);
+    }
+
+private:
+    template <typename U>
+    struct IsComplex : std::false_type {};
+
+    template <typename U>
+    struct IsComplex<std::complex<U>> : std::true_type {};
+
+    // 奇偶交错分组：偶数位置的点放前半，奇数位置的放后半，递归到单个点，
+    // 与build()的分割方式（前半ceil(n/2)个）一致；叶子内逐个相乘时部分乘积的点也是分散的
+    static void interleave(const std::vector<std::size_t>& in, std::vector<std::size_t>& out) {
+        if (in.size() <= 1) {
+            out.insert(out.end(), in.begin(), in.end());
+            return;
+        }
+        std::vector<std::size_t> even, odd;
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            (i % 2 == 0 ? even : odd).push_back(in[i]);
+        }
+        interleave(even, out);
+        interleave(odd, out);
+    }
+
+    std::size_t build(std::size_t begin, std::size_t end) {
+        std::size_t index = nodes_.size();
+        nodes_.push_back(Node{begin, end, 0, 0, std::vector<T>(), std::vector<T>()});
+        std::vector<T> product;
+        if (end - begin <= kMultipointLeafSize) {
+            product.assign(1, T(1));
+            for (std::size_t k = begin; k < end; ++k) {
+                // product *= (x - x_k)
+                product.push_back(T());
+                for (std::size_t j = product.size() - 1; j > 0; --j) {
+                    product[j] = product[j - 1] - points_[k] * product[j];
+                }
+                product[0] = -points_[k] * product[0];
+            }
+        } else {
+            std::size_t mid = begin + (end - begin + 1) / 2;
+            std::size_t left = build(begin, mid);
+            std::size_t right = build(mid, end);
+            nodes_[index].left = left;
+            nodes_[index].right = right;
+            product = multiplyCoefficients(nodes_[left].product, nodes_[right].product);
+        }
+        if constexpr (std::is_floating_point<T>::value || IsComplex<T>::value) {
+            for (const T& c : product) {
+                growth_ = std::max(growth_, static_cast<double>(std::abs(c)));
+            }
+        }
+        nodes_[index].product.swap(product);
+        return index;
+    }
+
+    // 孩子对父结点余式取余时商的项数至多为两者次数之差，预先算好倒序除式的逆
+    void prepareInverses(std::size_t index) {
+        const Node& node = nodes_[index];
+        if (node.left == 0) {
+            return;
+        }
+        std::size_t parentTerms = node.product.size() - 1;
+        for (std::size_t child : {node.left, node.right}) {
+            std::size_t length = parentTerms - (nodes_[child].product.size() - 1);
+            if (length >= kFastRemainderMinSize) {
+                nodes_[child].inverse = inverseSeries(reversed(nodes_[child].product), length);
+            }
+            prepareInverses(child);
+        }
+    }
+
+    static std::vector<T> reversed(const std::vector<T>& c) {
+        return std::vector<T>(c.rbegin(), c.rend());
+    }
+
+    static std::size_t quotientSize(const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() >= b.size() ? a.size() - b.size() + 1 : 0;
+    }
+
+    // a mod b，b首项系数为1；inverse是倒序b的逆，至少有quotientSize(a, b)项（商较短时可以为空）
+    static std::vector<T> remainder(const std::vector<T>& a, const std::vector<T>& b, const std::vector<T>& inverse) {
+        std::size_t q = quotientSize(a, b);
+        std::size_t m = b.size() - 1;
+        if (q == 0) {
+            return a;
+        }
+
+        if (q < kFastRemainderMinSize || inverse.size() < q) {
+            // 普通长除法
+            std::vector<T> r = a;
+            for (std::size_t k = q; k-- > 0;) {
+                T coeff = r[k + m];
+                for (std::size_t j = 0; j < m; ++j) {
+                    r[k + j] -= coeff * b[j];
+                }
+            }
+            r.resize(m);
+            return r;
+        }
+
+        // rev(商) = rev(a) * rev(b)^{-1} mod x^q
+        std::vector<T> head(a.rbegin(), a.rbegin() + q);
+        std::vector<T> inv(inverse.begin(), inverse.begin() + q);
+        std::vector<T> quotient = multiplyCoefficients(head, inv);
+        quotient.resize(q);
+        std::reverse(quotient.begin(), quotient.end());
+
+        // 余式 = a - 商 * b，只需要低m项
+        std::vector<T> product = multiplyCoefficients(quotient, b);
+        std::vector<T> r(a.begin(), a.begin() + m);
+        for (std::size_t j = 0; j < m; ++j) {
+            r[j] -= product[j];
+        }
+        return r;
+    }
+
+    // r是某结点的余式，求它在该结点各点的值
+    void descend(std::size_t index, const std::vector<T>& r, T* out) const {
+        const Node& node = nodes_[index];
+        if (node.left == 0) {
+            for (std::size_t k = node.begin; k < node.end; ++k) {
+                T value = T();
+                for (std::size_t i = r.size(); i-- > 0;) {
+                    value = value * points_[k] + r[i];
+                }
+                out[k] = value;
+            }
+            return;
+        }
+        for (std::size_t child : {node.left, node.right}) {
+            descend(child, remainder(r, nodes_[child].product, nodes_[child].inverse), out);
+        }
+    }
+
+    // sum_{k in node} scaled[k] * product / (x - x_k)
+    std::vector<T> combine(std::size_t index, const std::vector<T>& scaled) const {
+        const Node& node = nodes_[index];
+        if (node.left == 0) {
+            const std::vector<T>& m = node.product;
+            std::vector<T> result(m.size() - 1, T());
+            for (std::size_t k = node.begin; k < node.end; ++k) {
+                // 综合除法：m / (x - x_k)，从最高次开始
+                T carry = T();
+                for (std::size_t i = m.size() - 1; i > 0; --i) {
+                    carry = carry * points_[k] + m[i];
+                    result[i - 1] += scaled[k] * carry;
+                }
+            }
+            return result;
+        }
+        std::vector<T> a = multiplyCoefficients(combine(node.left, scaled), nodes_[node.right].product);
+        std::vector<T> b = multiplyCoefficients(combine(node.right, scaled), nodes_[node.left].product);
+        if (a.size() < b.size()) {
+            a.swap(b);
+        }
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            a[i] += b[i];
+        }
+        return a;
+    }
+};
+
+// 在多个点上求值；规模较小，或浮点系数时子乘积树的系数增长过大（结果不可靠）时直接用秦九韶算法
+template <typename T>
+std::vector<T> multipointEvaluate(const Polynomial<T>& p, const std::vector<T>& points) {
+    std::vector<T> values(points.size());
+    if (points.size() >= kMultipointMinSize && p.getCoefficients().size() >= kMultipointMinSize) {
+        SubproductTree<T> tree(points);
+        if (tree.getGrowth() <= kMultipointMaxGrowth) {
+            return tree.evaluate(p);
+        }
+    }
+    p.evaluate(points.data(), values.data(), points.size());
+    return values;
+}
+
+// 由n组（点，值）求次数小于n的插值多项式，点必须互不相同。点数小于kMultipointMinSize时直接用Newton插值；
+// 否则建子乘积树，浮点系数时树中系数增长超过kMultipointMaxGrowth的也退回Newton插值（见SubproductTree::interpolate）
+template <typename T>
+Polynomial<T> interpolate(const std::vector<T>& points, const std::vector<T>& values) {
+    if (points.size() < kMultipointMinSize) {
+        return newtonInterpolate(points, values);
+    }
+    return SubproductTree<T>(points).interpolate(values);
+}
+
+#endif // MULTIPOINT_EVAL_HPP
@@ -0,0 +1,177 @@
+#ifndef NEWTON_SOLVER_HPP
+#define NEWTON_SOLVER_HPP
+
+#include "Dual.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// NewtonSolver.hpp
+// 用前向自动微分（Dual.hpp）求导的Newton法和Halley法
+//
+// f可以是任何能以Dual为参数调用的对象：Function<Dual<T>>的派生类
+// （LinearFunction<Dual<double>>、Polynomial<Dual<double>>等）、表达式模板或泛型lambda。
+// 导数是精确的，一次调用同时得到函数值和导数，不需要有限差分的额外求值
+//   - Newton：  x <- x - f / f'，参数类型Dual<T>
+//   - Halley：  x <- x - 2 f f' / (2 f'^2 - f f'')，参数类型Dual<Dual<T>>（三阶收敛）
+//   - 方程组：  N个未知数，Dual<T, N>一次求值得到整个Jacobi矩阵
+template <typename T>
+class NewtonSolver {
+public:
+    struct Options {
+        int maxIterations; // 最大迭代次数
+        double tolerance;  // |步长| <= tolerance * max(1, |x|) 时停止
+
+        Options() : maxIterations(50), tolerance(1e-14) {}
+    };
+
+    template <std::size_t N>
+    using Vector = std::array<T, N>;
+
+    explicit NewtonSolver(const Options& options = Options()) : options_(options), iterations_(0), converged_(false) {}
+
+    // Newton法，f以Dual<T>为参数
+    template <typename F>
+    T solve(const F& f, T x) {
+        using std::abs;
+        converged_ = false;
+        for (iterations_ = 0; iterations_ < options_.maxIterations;) {
+            Dual<T> y = f(Dual<T>::variable(x));
+            ++iterations_;
+            if (y.getValue() == T()) {
+                converged_ = true;
+                break;
+            }
+            T step = y.getValue() / y.getTangent();
+            x -= step;
+            if (isSmallStep(static_cast<double>(abs(step)), static_cast<double>(abs(x)))) {
+                converged_ = true;
+                break;
+            }
+        }
+        return x;
+    }
+
+    // Halley法，f以Dual<Dual<T>>为参数：内层切方向给出f'，外层再求一次导给出f''
+    template <typename F>
+    T solveHalley(const F& f, T x) {
+        using std::abs;
+        converged_ = false;
+        for (iterations_ = 0; iterations_ < options_.maxIterations;) {
+            Dual<Dual<T>> arg(Dual<T>::variable(x));
+            arg.setTangent(0, Dual<T>(T(1)));
+            Dual<Dual<T>> y = f(arg);
+            ++iterations_;
+
+            const T value = y.getValue().getValue();
+            const T d1 = y.getValue().getTangent();
+            const T d2 = y.getTangent().getTangent();
+            if (value == T()) {
+                converged_ = true;
+                break;
+            }
+            T step = T(2) * value * d1 / (T(2) * d1 * d1 - value * d2);
+            x -= step;
+            if (isSmallStep(static_cast<double>(abs(step)), static_cast<double>(abs(x)))) {
+                converged_ = true;
+                break;
+            }
+        }
+        return x;
+    }
+
+    // N元方程组 F(x) = 0 的Newton法，f以std::array<Dual<T, N>, N>为参数并返回同类型
+    template <std::size_t N, typename F>
+    Vector<N> solveSystem(const F& f, Vector<N> x) {
+        using std::abs;
+        converged_ = false;
+        for (iterations_ = 0; iterations_ < options_.maxIterations;) {
+            std::array<Dual<T, N>, N> arg;
+            for (std::size_t i = 0; i < N; ++i) {
+                arg[i] = Dual<T, N>::variable(x[i], i);
+            }
+            std::array<Dual<T, N>, N> y = f(arg);
+            ++iterations_;
+
+            // 解 J step = F
+            std::array<std::array<T, N + 1>, N> a;
+            for (std::size_t i = 0; i < N; ++i) {
+                for (std::size_t j = 0; j < N; ++j) {
+                    a[i][j] = y[i].getTangent(j);
+                }
+                a[i][N] = y[i].getValue();
+            }
+            Vector<N> step;
+            if (!solveLinear(a, step)) {
+                break; // Jacobi矩阵奇异
+            }
+
+            double stepNorm = 0.0, xNorm = 0.0;
+            for (std::size_t i = 0; i < N; ++i) {
+                x[i] -= step[i];
+                stepNorm = std::max(stepNorm, static_cast<double>(abs(step[i])));
+                xNorm = std::max(xNorm, static_cast<double>(abs(x[i])));
+            }
+            if (isSmallStep(stepNorm, xNorm)) {
+                converged_ = true;
+                break;
+            }
+        }
+        return x;
+    }
+
+    // 上一次求解的迭代次数（即f的调用次数）
+    int getIterations() const {
+        return iterations_;
+    }
+
+    // 上一次求解是否满足停止条件
+    bool hasConverged() const {
+        return converged_;
+    }
+
+private:
+    Options options_;
+    int iterations_;
+    bool converged_;
+
+    bool isSmallStep(double step, double x) const {
+        return step <= options_.tolerance * std::max(1.0, x);
+    }
+
+    // 列主元Gauss消去，a是增广矩阵
+    template <std::size_t N>
+    static bool solveLinear(std::array<std::array<T, N + 1>, N>& a, Vector<N>& x) {
+        using std::abs;
+        for (std::size_t col = 0; col < N; ++col) {
+            std::size_t pivot = col;
+            for (std::size_t row = col + 1; row < N; ++row) {
+                if (abs(a[row][col]) > abs(a[pivot][col])) {
+                    pivot = row;
+                }
+            }
+            if (a[pivot][col] == T()) {
+                return false;
+            }
+            std::swap(a[col], a[pivot]);
+            for (std::size_t row = col + 1; row < N; ++row) {
+                T factor = a[row][col] / a[col][col];
+                for (std::size_t j = col; j <= N; ++j) {
+                    a[row][j] -= factor * a[col][j];
+                }
+            }
+        }
+        for (std::size_t i = N; i-- > 0;) {
+            T sum = a[i][N];
+            for (std::size_t j = i + 1; j < N; ++j) {
+                sum -= a[i][j] * x[j];
+            }
+            x[i] = sum / a[i][i];
+        }
+        return true;
+    }
+};
+
+#endif // NEWTON_SOLVER_HPP
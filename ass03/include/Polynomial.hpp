@@ -4,23 +4,43 @@
 #include "Function.hpp"
 #include <vector>
 #include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
 
 // Polynomial.hpp
 // 多项式函数 f(x) = a_n * x^n + a_{n-1} * x^{n-1} + ... + a_1 * x + a_0
+
+// 单点求值的方法
+enum class EvalScheme {
+    Auto,   // 按类型和次数自动选择
+    Horner, // 秦九韶算法：乘加次数最少，但每一步都依赖上一步，延迟随次数线性增长
+    Estrin  // Estrin方法：每8个系数一组树形求值，组内各项互不依赖，依赖链约缩短为1/4
+};
+
 template <typename T>
 class Polynomial : public Function<T> {
 private:
     std::vector<T> coefficients_; // 系数，从a_0到a_n
+    EvalScheme scheme_;           // operator()使用的求值方法
 
 public:
+    // Auto模式下从这个次数起使用Estrin方法（由bench测得）
+    static constexpr std::size_t kEstrinMinDegree = 8;
+
     // 构造函数，接受系数向量（从常数项a_0到最高次项a_n）
-    Polynomial(const std::vector<T>& coefficients) : coefficients_(coefficients) {}
+    Polynomial(const std::vector<T>& coefficients, EvalScheme scheme = EvalScheme::Auto)
+        : coefficients_(coefficients), scheme_(scheme) {}
 
     // 重载操作符()，计算多项式函数值
     T operator()(T x) const override {
+        return usesEstrin() ? estrin(x) : horner(x);
+    }
+
+    // 使用秦九韶算法(Horner's method)计算多项式值
+    T horner(T x) const {
         T result = T(); // 初始化为0
         
-        // 使用秦九韶算法(Horner's method)计算多项式值
         for (int i = coefficients_.size() - 1; i >= 0; --i) {
             result = result * x + coefficients_[i];
         }
@@ -28,6 +48,89 @@ public:
         return result;
     }
 
+    // 使用Estrin方法计算多项式值
+    // p(x) = Q_0(x) + x^8 Q_1(x) + x^16 Q_2(x) + ...，每个Q_j有8个系数，
+    // 按 (c0 + c1 x) + (c2 + c3 x) x^2 + ((c4 + c5 x) + (c6 + c7 x) x^2) x^4 求值；
+    // 各组之间再用以x^8为变量的秦九韶算法合并。不足8个的最高几项直接用秦九韶算法
+    T estrin(T x) const {
+        const std::size_t n = coefficients_.size();
+        const T* c = coefficients_.data();
+        const T x2 = x * x;
+        const T x4 = x2 * x2;
+        const T x8 = x4 * x4;
+
+        const std::size_t full = n / 8 * 8;
+        T result = T();
+        for (std::size_t i = n; i-- > full;) {
+            result = result * x + c[i];
+        }
+        for (std::size_t k = full; k > 0; k -= 8) {
+            const T* d = c + k - 8;
+            T q = ((d[0] + d[1] * x) + (d[2] + d[3] * x) * x2) +
+                  ((d[4] + d[5] * x) + (d[6] + d[7] * x) * x2) * x4;
+            result = result * x8 + q;
+        }
+        return result;
+    }
+
+    // 设置operator()使用的求值方法
+    void setScheme(EvalScheme scheme) {
+        scheme_ = scheme;
+    }
+
+    EvalScheme getScheme() const {
+        return scheme_;
+    }
+
+    // operator()当前是否使用Estrin方法
+    // Auto模式只对内置算术类型和复数使用Estrin：它多做约log(n)次乘法，
+    // 对mpf_class这类每次运算都很昂贵、又没有指令级并行的类型不划算
+    bool usesEstrin() const {
+        if (scheme_ == EvalScheme::Auto) {
+            return hasCheapArithmetic() && getDegree() >= kEstrinMinDegree;
+        }
+        return scheme_ == EvalScheme::Estrin;
+    }
+
+    // 批量计算多项式值
+    // 单点的秦九韶算法是一条长度为次数的依赖链；这里把点分成若干块，
+    // 外层循环遍历系数，内层循环对块内所有点做一步秦九韶迭代，
+    // 块内各点互不依赖，编译器可以把内层循环向量化。
+    // 多个点本身就提供了足够的并行度，所以总是使用秦九韶算法，结果与horner()完全相同
+    void evaluate(const T* xs, T* out, std::size_t n) const override {
+        constexpr std::size_t kBlock = 64;
+        T acc[kBlock];
+        T x[kBlock];
+
+        for (std::size_t start = 0; start < n; start += kBlock) {
+            std::size_t m = (n - start < kBlock) ? n - start : kBlock;
+
+            // 先复制输入，允许out与xs指向同一块内存
+            for (std::size_t j = 0; j < m; ++j) {
+                x[j] = xs[start + j];
+                acc[j] = T();
+            }
+
+            for (std::size_t k = coefficients_.size(); k-- > 0;) {
+                const T c = coefficients_[k];
+                if (m == kBlock) {
+                    // 完整的块：固定的循环次数便于向量化
+                    for (std::size_t j = 0; j < kBlock; ++j) {
+                        acc[j] = acc[j] * x[j] + c;
+                    }
+                } else {
+                    for (std::size_t j = 0; j < m; ++j) {
+                        acc[j] = acc[j] * x[j] + c;
+                    }
+                }
+            }
+
+            for (std::size_t j = 0; j < m; ++j) {
+                out[start + j] = acc[j];
+            }
+        }
+    }
+
     // 获取多项式的次数
     size_t getDegree() const {
         return (coefficients_.empty() ? 0 : coefficients_.size() - 1);
@@ -37,6 +140,22 @@ public:
     const std::vector<T>& getCoefficients() const {
         return coefficients_;
     }
+
+private:
+    template <typename U>
+    struct IsComplex : std::false_type {};
+
+    template <typename U>
+    struct IsComplex<std::complex<U>> : std::true_type {};
+
+    static constexpr bool hasCheapArithmetic() {
+        return std::is_arithmetic<T>::value || IsComplex<T>::value;
+    }
 };
 
+// GMP系数的专门求值路径
+#ifdef USE_GMP
+#include "PolynomialGMP.hpp"
+#endif
+
 #endif // POLYNOMIAL_HPP
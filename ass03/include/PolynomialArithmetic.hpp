@@ -0,0 +1,354 @@
+#ifndef POLYNOMIAL_ARITHMETIC_HPP
+#define POLYNOMIAL_ARITHMETIC_HPP
+
+#include "FFT.hpp"
+#include "Polynomial.hpp"
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// PolynomialArithmetic.hpp
+// Polynomial<T>的加、减、乘、带余除法、平方和复合
+//
+// 乘法按规模选择算法：
+//   - 较短的因子少于kKaratsubaMinSize项：直接相乘 O(nm)
+//   - 中等规模：Karatsuba O(n^1.585)，适用于任何支持 +、-、* 的系数类型（包括GMP类型）
+//   - 较短的因子不少于kFFTMinSize项时，double和std::complex<double>用复数FFT；
+//     不少于kNTTMinSize项时，int等不超过32位的整数类型用三素数NTT（结果精确）；O(n log n)
+
+// 乘法算法，Auto按规模和系数类型选择
+enum class MultiplyAlgorithm {
+    Auto,
+    Schoolbook,
+    Karatsuba,
+    FFT // 对不支持FFT/NTT的类型退化为Karatsuba
+};
+
+// 阈值（由bench测得）
+constexpr std::size_t kKaratsubaMinSize = 64; // 较短因子达到这个项数时使用Karatsuba，也是递归的终止规模
+constexpr std::size_t kFFTMinSize = 1024;     // 较短因子达到这个项数时使用复数FFT
+constexpr std::size_t kNTTMinSize = 4096;     // 较短因子达到这个项数时使用NTT（三次变换比FFT慢）
+
+// 系数类型能使用哪种快速变换
+template <typename T>
+struct FastTransform {
+    static constexpr bool complexFFT = std::is_same<T, double>::value ||
+                                       std::is_same<T, std::complex<double>>::value;
+    static constexpr bool ntt = std::is_integral<T>::value && sizeof(T) <= 4;
+};
+
+// 去掉最高次的0系数，至少保留一项
+template <typename T>
+void trimCoefficients(std::vector<T>& c) {
+    while (c.size() > 1 && c.back() == T()) {
+        c.pop_back();
+    }
+    if (c.empty()) {
+        c.push_back(T());
+    }
+}
+
+// 直接相乘，out有n + m - 1项
+template <typename T>
+void schoolbookMultiply(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    for (std::size_t i = 0; i + 1 < n + m; ++i) {
+        out[i] = T();
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < m; ++j) {
+            out[i + j] += a[i] * b[j];
+        }
+    }
+}
+
+// 等长的Karatsuba乘法：a、b各n项，out有2n - 1项
+// scratch至少需要 karatsubaScratchSize(n) 项，递归过程中不再分配内存
+inline std::size_t karatsubaScratchSize(std::size_t n) {
+    std::size_t size = 0;
+    while (n >= kKaratsubaMinSize) {
+        std::size_t h = n - n / 2;
+        size += 4 * h;
+        n = h;
+    }
+    return size + 1;
+}
+
+template <typename T>
+void karatsubaMultiply(const T* a, const T* b, std::size_t n, T* out, T* scratch) {
+    if (n < kKaratsubaMinSize) {
+        schoolbookMultiply(a, n, b, n, out);
+        return;
+    }
+
+    // a = a0 + x^k a1，低半部分k项，高半部分h >= k项
+    std::size_t k = n / 2;
+    std::size_t h = n - k;
+
+    // z0 = a0 b0 放在out[0, 2k-1)，z2 = a1 b1 放在out[2k, 2k+2h-1)
+    karatsubaMultiply(a, b, k, out, scratch);
+    out[2 * k - 1] = T();
+    karatsubaMultiply(a + k, b + k, h, out + 2 * k, scratch);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    T* sa = scratch;
+    T* sb = scratch + h;
+    T* z1 = scratch + 2 * h;
+    for (std::size_t i = 0; i < h; ++i) {
+        sa[i] = a[k + i];
+        sb[i] = b[k + i];
+        if (i < k) {
+            sa[i] += a[i];
+            sb[i] += b[i];
+        }
+    }
+    karatsubaMultiply(sa, sb, h, z1, scratch + 4 * h);
+    for (std::size_t i = 0; i + 1 < 2 * k; ++i) {
+        z1[i] -= out[i];
+    }
+    for (std::size_t i = 0; i + 1 < 2 * h; ++i) {
+        z1[i] -= out[2 * k + i];
+    }
+
+    for (std::size_t i = 0; i + 1 < 2 * h; ++i) {
+        out[k + i] += z1[i];
+    }
+}
+
+// 任意长度的Karatsuba乘法：把较长的因子切成与较短因子等长的段，逐段相乘后累加
+template <typename T>
+std::vector<T> karatsubaMultiply(const std::vector<T>& a, const std::vector<T>& b) {
+    const std::vector<T>& longer = a.size() >= b.size() ? a : b;
+    const std::vector<T>& shorter = a.size() >= b.size() ? b : a;
+    std::size_t n = longer.size(), m = shorter.size();
+
+    std::vector<T> result(n + m - 1);
+    if (m < kKaratsubaMinSize) {
+        schoolbookMultiply(longer.data(), n, shorter.data(), m, result.data());
+        return result;
+    }
+
+    std::vector<T> scratch(karatsubaScratchSize(m));
+    std::vector<T> segment(m), product(2 * m - 1);
+    for (std::size_t start = 0; start < n; start += m) {
+        std::size_t len = std::min(m, n - start);
+        for (std::size_t i = 0; i < m; ++i) {
+            segment[i] = i < len ? longer[start + i] : T();
+        }
+        karatsubaMultiply(segment.data(), shorter.data(), m, product.data(), scratch.data());
+        std::size_t used = std::min(2 * m - 1, result.size() - start);
+        for (std::size_t i = 0; i < used; ++i) {
+            result[start + i] += product[i];
+        }
+    }
+    return result;
+}
+
+// 用FFT或NTT相乘，只对FastTransform支持的类型调用
+template <typename T>
+std::vector<T> transformMultiply(const std::vector<T>& a, const std::vector<T>& b) {
+    std::vector<T> result(a.size() + b.size() - 1);
+    if constexpr (FastTransform<T>::complexFFT) {
+        std::vector<std::complex<double>> ca(a.begin(), a.end()), cb(b.begin(), b.end());
+        std::vector<std::complex<double>> c = fftMultiply(ca.data(), ca.size(), cb.data(), cb.size());
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            if constexpr (std::is_same<T, double>::value) {
+                result[i] = c[i].real();
+            } else {
+                result[i] = c[i];
+            }
+        }
+    } else if constexpr (FastTransform<T>::ntt) {
+        std::vector<long long> la(a.begin(), a.end()), lb(b.begin(), b.end());
+        std::vector<__int128> c = nttMultiply(la.data(), la.size(), lb.data(), lb.size());
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i] = static_cast<T>(c[i]);
+        }
+    }
+    return result;
+}
+
+// 系数向量相乘，结果有a.size() + b.size() - 1项（不去掉最高次的0）；任一为空时返回空向量
+template <typename T>
+std::vector<T> multiplyCoefficients(const std::vector<T>& a, const std::vector<T>& b,
+                                    MultiplyAlgorithm algorithm = MultiplyAlgorithm::Auto) {
+    if (a.empty() || b.empty()) {
+        return std::vector<T>();
+    }
+
+    constexpr bool hasTransform = FastTransform<T>::complexFFT || FastTransform<T>::ntt;
+    constexpr std::size_t transformMinSize = FastTransform<T>::ntt ? kNTTMinSize : kFFTMinSize;
+    std::size_t shorter = std::min(a.size(), b.size());
+    if (algorithm == MultiplyAlgorithm::Auto) {
+        if (shorter < kKaratsubaMinSize) {
+            algorithm = MultiplyAlgorithm::Schoolbook;
+        } else if (hasTransform && shorter >= transformMinSize) {
+            algorithm = MultiplyAlgorithm::FFT;
+        } else {
+            algorithm = MultiplyAlgorithm::Karatsuba;
+        }
+    }
+    if (algorithm == MultiplyAlgorithm::FFT &&
+        (!hasTransform || (FastTransform<T>::ntt && a.size() + b.size() - 1 > kNTTMaxLength))) {
+        algorithm = MultiplyAlgorithm::Karatsuba;
+    }
+
+    std::vector<T> c;
+    switch (algorithm) {
+        case MultiplyAlgorithm::Schoolbook:
+            c.resize(a.size() + b.size() - 1);
+            schoolbookMultiply(a.data(), a.size(), b.data(), b.size(), c.data());
+            break;
+        case MultiplyAlgorithm::FFT:
+            c = transformMultiply(a, b);
+            break;
+        default:
+            c = karatsubaMultiply(a, b);
+            break;
+    }
+    return c;
+}
+
+// 多项式乘法，可以指定算法
+template <typename T>
+Polynomial<T> multiply(const Polynomial<T>& p, const Polynomial<T>& q,
+                       MultiplyAlgorithm algorithm = MultiplyAlgorithm::Auto) {
+    std::vector<T> c = multiplyCoefficients(p.getCoefficients(), q.getCoefficients(), algorithm);
+    trimCoefficients(c);
+    return Polynomial<T>(c, p.getScheme());
+}
+
+template <typename T>
+Polynomial<T> operator*(const Polynomial<T>& p, const Polynomial<T>& q) {
+    return multiply(p, q);
+}
+
+template <typename T>
+Polynomial<T> square(const Polynomial<T>& p) {
+    return multiply(p, p);
+}
+
+template <typename T>
+Polynomial<T> operator+(const Polynomial<T>& p, const Polynomial<T>& q) {
+    const std::vector<T>& a = p.getCoefficients();
+    const std::vector<T>& b = q.getCoefficients();
+    std::vector<T> c(std::max(a.size(), b.size()));
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        if (i < a.size()) {
+            c[i] += a[i];
+        }
+        if (i < b.size()) {
+            c[i] += b[i];
+        }
+    }
+    trimCoefficients(c);
+    return Polynomial<T>(c, p.getScheme());
+}
+
+template <typename T>
+Polynomial<T> operator-(const Polynomial<T>& p) {
+    std::vector<T> c = p.getCoefficients();
+    for (T& v : c) {
+        v = -v;
+    }
+    return Polynomial<T>(c, p.getScheme());
+}
+
+template <typename T>
+Polynomial<T> operator-(const Polynomial<T>& p, const Polynomial<T>& q) {
+    return p + (-q);
+}
+
+// 带余除法：返回(商, 余数)，满足 p = 商 * q + 余数，且余数的次数小于q的次数
+// 整数类型（int、mpz_class等）要求每一步都能整除（例如q的首项系数为1或-1），否则抛出std::domain_error
+template <typename T>
+std::pair<Polynomial<T>, Polynomial<T>> divmod(const Polynomial<T>& p, const Polynomial<T>& q) {
+    std::vector<T> divisor = q.getCoefficients();
+    trimCoefficients(divisor);
+    const T lead = divisor.back();
+    if (lead == T()) {
+        throw std::domain_error("polynomial division by zero");
+    }
+
+    std::vector<T> remainder = p.getCoefficients();
+    trimCoefficients(remainder);
+    if (remainder.size() < divisor.size()) {
+        return std::make_pair(Polynomial<T>(std::vector<T>(1, T()), p.getScheme()),
+                              Polynomial<T>(remainder, p.getScheme()));
+    }
+
+    std::size_t m = divisor.size();
+    std::vector<T> quotient(remainder.size() - m + 1);
+    for (std::size_t k = quotient.size(); k-- > 0;) {
+        T coeff = remainder[k + m - 1] / lead;
+        if (std::numeric_limits<T>::is_integer && coeff * lead != remainder[k + m - 1]) {
+            throw std::domain_error("polynomial division is not exact over this coefficient type");
+        }
+        quotient[k] = coeff;
+        for (std::size_t j = 0; j < m; ++j) {
+            remainder[k + j] -= coeff * divisor[j];
+        }
+    }
+
+    // 余数的次数小于除式
+    remainder.resize(m - 1);
+    trimCoefficients(remainder);
+    trimCoefficients(quotient);
+    return std::make_pair(Polynomial<T>(quotient, p.getScheme()),
+                          Polynomial<T>(remainder, p.getScheme()));
+}
+
+template <typename T>
+Polynomial<T> operator/(const Polynomial<T>& p, const Polynomial<T>& q) {
+    return divmod(p, q).first;
+}
+
+template <typename T>
+Polynomial<T> operator%(const Polynomial<T>& p, const Polynomial<T>& q) {
+    return divmod(p, q).second;
+}
+
+// 复合 p(q(x))，分治：p = p_low + x^h p_high  =>  p(q) = p_low(q) + q^h p_high(q)
+// 预先算出 q^(2^j)，乘法总是在规模相近的多项式之间进行，可以充分利用快速乘法
+template <typename T>
+Polynomial<T> compose(const Polynomial<T>& p, const Polynomial<T>& q) {
+    std::vector<T> c = p.getCoefficients();
+    trimCoefficients(c);
+
+    std::size_t size = nextPowerOfTwo(c.size());
+    std::vector<Polynomial<T>> powers(1, q); // powers[j] = q^(2^j)
+    while ((std::size_t(1) << powers.size()) < size) {
+        powers.push_back(square(powers.back()));
+    }
+    c.resize(size, T());
+
+    struct Composer {
+        const std::vector<T>& c;
+        const std::vector<Polynomial<T>>& powers;
+        EvalScheme scheme;
+
+        // 计算 sum_{i < 2^level} c[offset + i] q^i
+        Polynomial<T> run(std::size_t offset, std::size_t level) const {
+            if (level == 0) {
+                return Polynomial<T>(std::vector<T>(1, c[offset]), scheme);
+            }
+            std::size_t half = std::size_t(1) << (level - 1);
+            Polynomial<T> low = run(offset, level - 1);
+            Polynomial<T> high = run(offset + half, level - 1);
+            return low + high * powers[level - 1];
+        }
+    };
+
+    std::size_t levels = 0;
+    while ((std::size_t(1) << levels) < size) {
+        ++levels;
+    }
+    Composer composer = {c, powers, p.getScheme()};
+    return composer.run(0, levels);
+}
+
+#endif // POLYNOMIAL_ARITHMETIC_HPP
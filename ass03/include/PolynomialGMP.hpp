@@ -0,0 +1,118 @@
+#ifndef POLYNOMIAL_GMP_HPP
+#define POLYNOMIAL_GMP_HPP
+
+#include "Polynomial.hpp"
+#include <gmpxx.h>
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// PolynomialGMP.hpp
+// Polynomial<mpf_class>的专门求值路径（USE_GMP时由Polynomial.hpp自动包含）
+//
+// 通用模板的 result = result * x + c 每一步都要构造、析构mpf_class临时对象，
+// 高精度、高次数时内存分配占了大部分时间。这里改为在每个线程一份的临时变量上
+// 原地调用mpf_mul/mpf_add，求值过程中不分配内存：
+//   - horner(x)：只在构造返回值时分配一次
+//   - evaluate(xs, out, n)：结果直接写入out中已有的对象；out[i]精度不低于计算精度时不分配内存，
+//     否则先把out[i]的精度提高到计算精度（只在第一次使用这样的out时重新分配），结果不会被截断
+//   - evaluateParallel：按块分给多个线程，每个线程使用自己的临时变量
+// 计算精度取x和所有系数精度的最大值，返回值（或out[i]）至少具有这个精度
+
+// 每个线程一份的GMP临时变量，线程结束时释放
+class MpfScratch {
+public:
+    // 当前线程的累加器，精度设为prec（精度不变时不重新分配）
+    static mpf_ptr accumulator(mp_bitcnt_t prec) {
+        thread_local MpfScratch scratch;
+        if (mpf_get_prec(scratch.acc_) != prec) {
+            mpf_set_prec(scratch.acc_, prec);
+        }
+        return scratch.acc_;
+    }
+
+private:
+    mpf_t acc_;
+
+    MpfScratch() {
+        mpf_init(acc_);
+    }
+
+    ~MpfScratch() {
+        mpf_clear(acc_);
+    }
+
+    MpfScratch(const MpfScratch&) = delete;
+    MpfScratch& operator=(const MpfScratch&) = delete;
+};
+
+// 所有系数的最大精度
+inline mp_bitcnt_t coefficientPrecision(const std::vector<mpf_class>& c) {
+    mp_bitcnt_t prec = 0;
+    for (const mpf_class& v : c) {
+        prec = std::max(prec, v.get_prec());
+    }
+    return prec;
+}
+
+// 在acc中用秦九韶算法计算多项式的值
+inline void hornerInPlace(mpf_ptr acc, const std::vector<mpf_class>& c, mpf_srcptr x) {
+    if (c.empty()) {
+        mpf_set_ui(acc, 0);
+        return;
+    }
+    mpf_set(acc, c.back().get_mpf_t());
+    for (std::size_t i = c.size() - 1; i-- > 0;) {
+        mpf_mul(acc, acc, x);
+        mpf_add(acc, acc, c[i].get_mpf_t());
+    }
+}
+
+template <>
+inline mpf_class Polynomial<mpf_class>::horner(mpf_class x) const {
+    mp_bitcnt_t prec = std::max(coefficientPrecision(coefficients_), x.get_prec());
+    mpf_ptr acc = MpfScratch::accumulator(prec);
+    hornerInPlace(acc, coefficients_, x.get_mpf_t());
+    return mpf_class(acc, prec);
+}
+
+template <>
+inline void Polynomial<mpf_class>::evaluate(const mpf_class* xs, mpf_class* out, std::size_t n) const {
+    mp_bitcnt_t coeffPrec = coefficientPrecision(coefficients_);
+    for (std::size_t i = 0; i < n; ++i) {
+        mp_bitcnt_t prec = std::max(coeffPrec, xs[i].get_prec());
+        mpf_ptr acc = MpfScratch::accumulator(prec);
+        hornerInPlace(acc, coefficients_, xs[i].get_mpf_t());
+        // out可以与xs相同：xs[i]此后不再使用
+        if (out[i].get_prec() < prec) {
+            out[i].set_prec(prec);
+        }
+        mpf_set(out[i].get_mpf_t(), acc);
+    }
+}
+
+// 多线程批量求值，threads为0时使用硬件线程数
+inline void evaluateParallel(const Polynomial<mpf_class>& p, const mpf_class* xs, mpf_class* out,
+                             std::size_t n, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, n));
+    if (threads <= 1) {
+        p.evaluate(xs, out, n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    std::size_t chunk = (n + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        std::size_t begin = std::min(n, t * chunk);
+        std::size_t end = std::min(n, begin + chunk);
+        workers.emplace_back([&p, xs, out, begin, end] { p.evaluate(xs + begin, out + begin, end - begin); });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif // POLYNOMIAL_GMP_HPP
@@ -0,0 +1,85 @@
+#ifndef POLYNOMIAL_PACK_HPP
+#define POLYNOMIAL_PACK_HPP
+
+#include "Polynomial.hpp"
+#include <cstddef>
+#include <vector>
+
+// PolynomialPack.hpp
+// 在同一个点上同时计算多个多项式
+// 系数按"结构数组"(SoA)方式存放：第k次系数的所有多项式连续存放，
+// 秦九韶算法的每一步对所有多项式做同一个乘加，内层循环可以向量化。
+// 次数较低的多项式在高次位置补0
+template <typename T>
+class PolynomialPack {
+private:
+    static constexpr std::size_t kLanes = 8; // 一次同时计算的多项式个数
+
+    std::size_t count_;          // 多项式个数
+    std::size_t terms_;          // 最大次数 + 1
+    std::vector<T> coefficients_; // coefficients_[k * count_ + p] 是第p个多项式的第k次系数
+
+public:
+    // 构造函数，接受若干个多项式
+    explicit PolynomialPack(const std::vector<Polynomial<T>>& polynomials)
+        : count_(polynomials.size()), terms_(0) {
+        for (const Polynomial<T>& p : polynomials) {
+            if (p.getCoefficients().size() > terms_) {
+                terms_ = p.getCoefficients().size();
+            }
+        }
+        coefficients_.assign(terms_ * count_, T());
+        for (std::size_t p = 0; p < count_; ++p) {
+            const std::vector<T>& c = polynomials[p].getCoefficients();
+            for (std::size_t k = 0; k < c.size(); ++k) {
+                coefficients_[k * count_ + p] = c[k];
+            }
+        }
+    }
+
+    // 在点x上计算所有多项式，out[p]为第p个多项式的值。
+    // 每次处理kLanes个多项式，累加器放在局部数组中（在寄存器里），最后才写回out：
+    // 若直接在out上累加，编译器无法排除out与coefficients_重叠，每一步都要读写内存
+    void evaluate(T x, T* out) const {
+        std::size_t p0 = 0;
+        for (; p0 + kLanes <= count_; p0 += kLanes) {
+            T acc[kLanes] = {};
+            for (std::size_t k = terms_; k-- > 0;) {
+                const T* c = &coefficients_[k * count_ + p0];
+                for (std::size_t l = 0; l < kLanes; ++l) {
+                    acc[l] = acc[l] * x + c[l];
+                }
+            }
+            for (std::size_t l = 0; l < kLanes; ++l) {
+                out[p0 + l] = acc[l];
+            }
+        }
+        // 剩余不足kLanes个的多项式逐个计算
+        for (std::size_t p = p0; p < count_; ++p) {
+            T acc = T();
+            for (std::size_t k = terms_; k-- > 0;) {
+                acc = acc * x + coefficients_[k * count_ + p];
+            }
+            out[p] = acc;
+        }
+    }
+
+    // 在n个点上计算所有多项式，out[i * size() + p]为第p个多项式在xs[i]处的值
+    void evaluate(const T* xs, T* out, std::size_t n) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            evaluate(xs[i], out + i * count_);
+        }
+    }
+
+    // 多项式个数
+    std::size_t size() const {
+        return count_;
+    }
+
+    // 最大次数
+    std::size_t getDegree() const {
+        return terms_ == 0 ? 0 : terms_ - 1;
+    }
+};
+
+#endif // POLYNOMIAL_PACK_HPP
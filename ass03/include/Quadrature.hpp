@@ -0,0 +1,234 @@
+#ifndef QUADRATURE_HPP
+#define QUADRATURE_HPP
+
+#include "Function.hpp"
+#include "Polynomial.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Quadrature.hpp
+// 基于Function<T>的自适应Gauss-Kronrod积分
+//
+// 每个子区间用7点Gauss和15点Kronrod公式（共用7个节点）计算，两者之差给出误差估计
+// （按QUADPACK的方式修正）。所有子区间按误差放在一个全局的堆中，每轮按误差从大到小
+// 取出区间（最多batch个，剩下的误差已满足目标时不再多取）对半分开：每个被细分的区间
+// 是线程池中的一个任务，它的两个子区间共30个节点用一次f.evaluate批量求值。每轮取出的区间只取决于误差，所以结果与线程数无关。
+// f是Polynomial<T>时直接用原函数精确计算，不需要求值。
+// T为实浮点类型；f的operator()/evaluate必须可以被多个线程同时调用
+template <typename T>
+class AdaptiveQuadrature {
+public:
+    struct Options {
+        double tolerance;         // 绝对误差目标
+        double relativeTolerance; // 相对误差目标，估计误差 <= max(tolerance, relativeTolerance * |积分|) 时停止
+        std::size_t maxIntervals; // 最大子区间数
+        std::size_t batch;        // 每轮细分的区间数
+        unsigned threads;         // 线程数，0表示使用硬件线程数，1表示不使用线程池
+
+        Options() : tolerance(1e-12), relativeTolerance(1e-12), maxIntervals(10000), batch(16), threads(0) {}
+    };
+
+    // pool不为空时使用调用方的线程池（忽略options.threads），否则按需要创建自己的线程池
+    explicit AdaptiveQuadrature(const Options& options = Options(), ThreadPool* pool = nullptr)
+        : options_(options), pool_(pool), error_(), intervals_(0), converged_(false) {
+        if (pool_ == nullptr && options_.threads != 1) {
+            ownPool_.reset(new ThreadPool(options_.threads));
+            pool_ = ownPool_.get();
+        }
+    }
+
+    // 计算f在[a, b]上的积分（a > b时为负）
+    T integrate(const Function<T>& f, T a, T b) {
+        if (const Polynomial<T>* p = dynamic_cast<const Polynomial<T>*>(&f)) {
+            error_ = T();
+            intervals_ = 0;
+            converged_ = true;
+            return exactIntegral(*p, a, b);
+        }
+        if (a == b) {
+            error_ = T();
+            intervals_ = 0;
+            converged_ = true;
+            return T();
+        }
+
+        std::vector<Interval> heap(1);
+        T xs[15], fx[15];
+        nodes(a, b, xs);
+        f.evaluate(xs, fx, 15);
+        kronrod(a, b, fx, heap[0]);
+
+        const std::size_t batch = std::max<std::size_t>(1, options_.batch);
+        std::vector<Interval> parents, children;
+        T value = heap[0].value;
+        error_ = heap[0].error;
+        while (!(converged_ = isAccurate(value, error_)) && heap.size() < options_.maxIntervals) {
+            // 取出误差最大的区间，直到剩下的误差之和已经满足目标（最多batch个）
+            std::size_t limit = std::min(batch, options_.maxIntervals - heap.size());
+            T remaining = error_;
+            parents.clear();
+            while (parents.size() < limit && !heap.empty() && (parents.empty() || !isAccurate(value, remaining))) {
+                std::pop_heap(heap.begin(), heap.end(), byError);
+                parents.push_back(heap.back());
+                heap.pop_back();
+                remaining -= parents.back().error;
+            }
+            std::size_t count = parents.size();
+
+            // 并行细分，每个区间的两个子区间一次批量求值
+            children.resize(2 * count);
+            auto refine = [&](std::size_t k) {
+                T m = (parents[k].a + parents[k].b) / T(2);
+                T xs2[30], fx2[30];
+                nodes(parents[k].a, m, xs2);
+                nodes(m, parents[k].b, xs2 + 15);
+                f.evaluate(xs2, fx2, 30);
+                kronrod(parents[k].a, m, fx2, children[2 * k]);
+                kronrod(m, parents[k].b, fx2 + 15, children[2 * k + 1]);
+            };
+            if (pool_ != nullptr && count > 1) {
+                pool_->parallelFor(count, refine);
+            } else {
+                for (std::size_t k = 0; k < count; ++k) {
+                    refine(k);
+                }
+            }
+            for (const Interval& child : children) {
+                heap.push_back(child);
+                std::push_heap(heap.begin(), heap.end(), byError);
+            }
+
+            // 重新求和，避免增量更新的舍入误差累积
+            value = T();
+            error_ = T();
+            for (const Interval& interval : heap) {
+                value += interval.value;
+                error_ += interval.error;
+            }
+        }
+        intervals_ = heap.size();
+        return value;
+    }
+
+    // 多项式的精确积分：F(x) = sum c_i x^(i+1) / (i+1)，结果为 F(b) - F(a)
+    static T exactIntegral(const Polynomial<T>& p, T a, T b) {
+        const std::vector<T>& c = p.getCoefficients();
+        auto antiderivative = [&c](T x) {
+            T r = T();
+            for (std::size_t i = c.size(); i-- > 0;) {
+                r = r * x + c[i] / static_cast<T>(i + 1);
+            }
+            return r * x;
+        };
+        return antiderivative(b) - antiderivative(a);
+    }
+
+    // 上一次积分的误差估计
+    T getError() const {
+        return error_;
+    }
+
+    // 上一次积分最终的子区间数（精确积分时为0）
+    std::size_t getIntervals() const {
+        return intervals_;
+    }
+
+    // 上一次积分是否达到误差目标
+    bool hasConverged() const {
+        return converged_;
+    }
+
+private:
+    struct Interval {
+        T a, b;
+        T value; // 15点Kronrod公式的值
+        T error; // 误差估计
+    };
+
+    Options options_;
+    std::unique_ptr<ThreadPool> ownPool_;
+    ThreadPool* pool_;
+    T error_;
+    std::size_t intervals_;
+    bool converged_;
+
+    static bool byError(const Interval& x, const Interval& y) {
+        return x.error < y.error;
+    }
+
+    bool isAccurate(T value, T error) const {
+        using std::abs;
+        return error <= std::max(static_cast<T>(options_.tolerance), static_cast<T>(options_.relativeTolerance) * abs(value));
+    }
+
+    // Kronrod节点（正半轴，从大到小，最后一个是0），奇数号同时是Gauss节点
+    static const long double* kronrodNodes() {
+        static const long double x[8] = {
+            0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+            0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+            0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+            0.207784955007898467600689403773245L, 0.000000000000000000000000000000000L};
+        return x;
+    }
+
+    // [a, b]上的15个节点：中点、然后是 m ∓ h x_k（k = 0..6）
+    static void nodes(T a, T b, T* xs) {
+        const long double* x = kronrodNodes();
+        T m = (a + b) / T(2);
+        T h = (b - a) / T(2);
+        xs[0] = m;
+        for (int k = 0; k < 7; ++k) {
+            T d = h * static_cast<T>(x[k]);
+            xs[1 + 2 * k] = m - d;
+            xs[2 + 2 * k] = m + d;
+        }
+    }
+
+    // 由nodes给出的15个节点上的值计算Kronrod值和误差估计（QUADPACK qk15）
+    static void kronrod(T a, T b, const T* fx, Interval& out) {
+        using std::abs;
+        using std::pow;
+        static const long double wk[8] = {
+            0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+            0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+            0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+            0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L};
+        static const long double wg[4] = {
+            0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+            0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L};
+
+        T h = (b - a) / T(2);
+        T center = fx[0];
+        T resultK = center * static_cast<T>(wk[7]);
+        T resultG = center * static_cast<T>(wg[3]);
+        for (int k = 0; k < 7; ++k) {
+            T sum = fx[1 + 2 * k] + fx[2 + 2 * k];
+            resultK += static_cast<T>(wk[k]) * sum;
+            if (k % 2 == 1) {
+                resultG += static_cast<T>(wg[k / 2]) * sum;
+            }
+        }
+        // resasc估计f减去均值后的积分，用来把|K - G|换算为更接近实际的误差
+        T mean = resultK / T(2);
+        T resasc = static_cast<T>(wk[7]) * abs(center - mean);
+        for (int k = 0; k < 7; ++k) {
+            resasc += static_cast<T>(wk[k]) * (abs(fx[1 + 2 * k] - mean) + abs(fx[2 + 2 * k] - mean));
+        }
+        T absH = abs(h);
+        resasc *= absH;
+        T error = abs((resultK - resultG) * h);
+        if (resasc != T() && error != T()) {
+            error = resasc * std::min(T(1), static_cast<T>(pow(200.0 * static_cast<double>(error / resasc), 1.5)));
+        }
+        out.a = a;
+        out.b = b;
+        out.value = resultK * h;
+        out.error = error;
+    }
+};
+
+#endif // QUADRATURE_HPP
@@ -0,0 +1,295 @@
+#ifndef ROOT_FINDER_HPP
+#define ROOT_FINDER_HPP
+
+#include "Polynomial.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// RootFinder.hpp
+// 用Aberth–Ehrlich迭代同时求多项式的全部复根
+//
+//   - 初值：由Newton多边形（点(i, log|a_i|)的上凸包）估计各组根的模，
+//     每组根均匀放在对应半径的圆上
+//   - 迭代：w_k = N_k / (1 - N_k * sum_{j != k} 1/(z_k - z_j))，N_k = p(z_k)/p'(z_k)。
+//     使用Jacobi方式（一轮内只用上一轮的近似值），各根的修正互不依赖，可以分给多个线程。
+//     线程池在每次求根时只建一次（或使用调用方的线程池），每轮迭代用parallelFor分发
+//   - |z| > 1 时用倒序多项式计算N_k，避免 z^n 溢出
+//   - 停止条件：|p(z_k)| 不超过求值本身的舍入误差界时，该根不再更新；
+//     所有根都满足时停止
+
+class RootFinder {
+public:
+    struct Options {
+        int maxIterations;   // 最大迭代轮数
+        unsigned threads;    // 线程数，0表示使用硬件线程数
+
+        Options() : maxIterations(200), threads(0) {}
+    };
+
+    // pool不为空时使用调用方的线程池（忽略options.threads），否则需要多线程时每次求根创建一个线程池
+    explicit RootFinder(const Options& options = Options(), ThreadPool* pool = nullptr)
+        : options_(options), pool_(pool), iterations_(0), converged_(false) {}
+
+    // 求复系数多项式的全部根（按重数计，共getDegree()个）
+    std::vector<std::complex<double>> findRoots(const Polynomial<std::complex<double>>& p) {
+        iterations_ = 0;
+        converged_ = true;
+
+        std::vector<std::complex<double>> c = p.getCoefficients();
+        while (!c.empty() && c.back() == std::complex<double>()) {
+            c.pop_back();
+        }
+
+        // 常数项为0时先提出零根
+        std::vector<std::complex<double>> roots;
+        std::size_t zeros = 0;
+        while (zeros + 1 < c.size() && c[zeros] == std::complex<double>()) {
+            ++zeros;
+        }
+        roots.assign(zeros, std::complex<double>());
+        c.erase(c.begin(), c.begin() + zeros);
+        if (c.size() <= 1) {
+            return roots;
+        }
+
+        std::vector<std::complex<double>> found = aberth(c);
+        roots.insert(roots.end(), found.begin(), found.end());
+        return roots;
+    }
+
+    // 实系数或其他可以转换为std::complex<double>的系数
+    template <typename T>
+    std::vector<std::complex<double>> findRoots(const Polynomial<T>& p) {
+        const std::vector<T>& c = p.getCoefficients();
+        std::vector<std::complex<double>> cc(c.size());
+        for (std::size_t i = 0; i < c.size(); ++i) {
+            cc[i] = std::complex<double>(c[i]);
+        }
+        return findRoots(Polynomial<std::complex<double>>(cc));
+    }
+
+    // 上一次求根用的迭代轮数
+    int getIterations() const {
+        return iterations_;
+    }
+
+    // 上一次求根是否所有根都满足停止条件
+    bool hasConverged() const {
+        return converged_;
+    }
+
+private:
+    Options options_;
+    ThreadPool* pool_;
+    int iterations_;
+    bool converged_;
+
+    // 计算 N = p(z)/p'(z)，以及 |p(z)| 和它的舍入误差界是否已相当（即z已是数值根）
+    // c是系数（从常数项开始），absWeights[i] = |c_i| * (4i + 1) 用于误差界
+    static std::complex<double> newtonRatio(const std::vector<std::complex<double>>& c,
+                                            const std::vector<double>& absWeights,
+                                            const std::vector<double>& absWeightsReversed,
+                                            std::complex<double> z, bool& isRoot) {
+        const std::size_t n = c.size() - 1;
+        const double eps = std::numeric_limits<double>::epsilon();
+        double r = std::abs(z);
+
+        if (r <= 1.0) {
+            std::complex<double> value = c[n], derivative = 0.0;
+            double bound = absWeights[n];
+            for (std::size_t i = n; i-- > 0;) {
+                derivative = derivative * z + value;
+                value = value * z + c[i];
+                bound = bound * r + absWeights[i];
+            }
+            isRoot = std::abs(value) <= eps * bound;
+            return value / derivative;
+        }
+
+        // 倒序多项式 q(y) = y^n p(1/y)，y = 1/z，p/p' = z / (n - y q'(y)/q(y))
+        std::complex<double> y = 1.0 / z;
+        double ry = 1.0 / r;
+        std::complex<double> value = c[0], derivative = 0.0;
+        double bound = absWeightsReversed[0];
+        for (std::size_t i = 1; i <= n; ++i) {
+            derivative = derivative * y + value;
+            value = value * y + c[i];
+            bound = bound * ry + absWeightsReversed[i];
+        }
+        isRoot = std::abs(value) <= eps * bound;
+        return z / (static_cast<double>(n) - y * derivative / value);
+    }
+
+    // 累加 sum_{begin <= j < end} 1/(x - z_j) 的实部和虚部
+    static void reciprocalSum(const double* re, const double* im, std::size_t begin, std::size_t end,
+                              double xr, double xi, double& sumRe, double& sumIm) {
+        // 4路独立累加器：打断加法的依赖链，也让编译器可以把4路合成向量运算
+        double sr[4] = {0.0, 0.0, 0.0, 0.0}, si[4] = {0.0, 0.0, 0.0, 0.0};
+        std::size_t j = begin;
+        for (; j + 4 <= end; j += 4) {
+            for (int l = 0; l < 4; ++l) {
+                double dr = xr - re[j + l];
+                double di = xi - im[j + l];
+                double inv = 1.0 / (dr * dr + di * di);
+                sr[l] += dr * inv;
+                si[l] -= di * inv;
+            }
+        }
+        for (; j < end; ++j) {
+            double dr = xr - re[j];
+            double di = xi - im[j];
+            double inv = 1.0 / (dr * dr + di * di);
+            sr[0] += dr * inv;
+            si[0] -= di * inv;
+        }
+        sumRe += (sr[0] + sr[1]) + (sr[2] + sr[3]);
+        sumIm += (si[0] + si[1]) + (si[2] + si[3]);
+    }
+
+    // Newton多边形给出的初值
+    static std::vector<std::complex<double>> initialGuesses(const std::vector<std::complex<double>>& c) {
+        const std::size_t n = c.size() - 1;
+        const double pi = std::acos(-1.0);
+
+        // 点(i, log|c_i|)的上凸包，跳过为0的系数
+        std::vector<std::size_t> hull;
+        std::vector<double> logs(n + 1);
+        for (std::size_t i = 0; i <= n; ++i) {
+            double a = std::abs(c[i]);
+            logs[i] = a > 0.0 ? std::log(a) : -std::numeric_limits<double>::infinity();
+            if (a == 0.0) {
+                continue;
+            }
+            while (hull.size() >= 2) {
+                std::size_t i1 = hull[hull.size() - 2], i2 = hull.back();
+                // i2在i1到i的连线下方或线上时去掉
+                double cross = (static_cast<double>(i2 - i1)) * (logs[i] - logs[i1]) -
+                               (static_cast<double>(i - i1)) * (logs[i2] - logs[i1]);
+                if (cross >= 0.0) {
+                    hull.pop_back();
+                } else {
+                    break;
+                }
+            }
+            hull.push_back(i);
+        }
+
+        // 每段凸包上有 j - i 个根，模约为 (|c_i|/|c_j|)^(1/(j-i))
+        std::vector<std::complex<double>> z;
+        z.reserve(n);
+        const double sigma = 0.7; // 打破对称性的角度偏移
+        for (std::size_t h = 0; h + 1 < hull.size(); ++h) {
+            std::size_t i = hull[h], j = hull[h + 1];
+            std::size_t m = j - i;
+            double radius = std::exp((logs[i] - logs[j]) / static_cast<double>(m));
+            for (std::size_t k = 0; k < m; ++k) {
+                double angle = 2.0 * pi * static_cast<double>(k) / static_cast<double>(m) +
+                               2.0 * pi * static_cast<double>(i) / static_cast<double>(n) + sigma;
+                z.push_back(std::polar(radius, angle));
+            }
+        }
+        return z;
+    }
+
+    std::vector<std::complex<double>> aberth(const std::vector<std::complex<double>>& c) {
+        const std::size_t n = c.size() - 1;
+        std::vector<double> absWeights(n + 1), absWeightsReversed(n + 1);
+        for (std::size_t i = 0; i <= n; ++i) {
+            absWeights[i] = std::abs(c[i]) * (4.0 * static_cast<double>(i) + 1.0);
+        }
+        for (std::size_t i = 0; i <= n; ++i) {
+            absWeightsReversed[i] = std::abs(c[n - i]) * (4.0 * static_cast<double>(n - i) + 1.0);
+        }
+
+        // 根的实部和虚部分开存放，求和的内层循环可以向量化
+        std::vector<std::complex<double>> z = initialGuesses(c);
+        std::vector<double> re(n), im(n), nextRe(n), nextIm(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            re[k] = z[k].real();
+            im[k] = z[k].imag();
+        }
+        std::vector<char> done(n, 0);
+
+        unsigned threads = pool_ != nullptr ? pool_->size() : options_.threads;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, n / 64)));
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool* pool = pool_;
+        if (pool == nullptr && threads > 1) {
+            ownPool.reset(new ThreadPool(threads));
+            pool = ownPool.get();
+        }
+
+        // 对[begin, end)中尚未收敛的根做一次Aberth修正，结果写入next
+        auto correct = [&](std::size_t begin, std::size_t end, std::size_t& active) {
+            active = 0;
+            for (std::size_t k = begin; k < end; ++k) {
+                nextRe[k] = re[k];
+                nextIm[k] = im[k];
+                if (done[k]) {
+                    continue;
+                }
+                std::complex<double> zk(re[k], im[k]);
+                bool isRoot = false;
+                std::complex<double> ratio = newtonRatio(c, absWeights, absWeightsReversed, zk, isRoot);
+                if (isRoot) {
+                    done[k] = 1;
+                    continue;
+                }
+                ++active;
+
+                // sum_{j != k} 1/(z_k - z_j) = sum conj(d)/|d|^2，分成j < k和j > k两段以便向量化
+                double sumRe = 0.0, sumIm = 0.0;
+                reciprocalSum(re.data(), im.data(), 0, k, re[k], im[k], sumRe, sumIm);
+                reciprocalSum(re.data(), im.data(), k + 1, n, re[k], im[k], sumRe, sumIm);
+                std::complex<double> w = ratio / (1.0 - ratio * std::complex<double>(sumRe, sumIm));
+                if (!std::isfinite(w.real()) || !std::isfinite(w.imag())) {
+                    // 两个近似值重合等退化情况：退化为Newton步
+                    w = ratio;
+                }
+                zk -= w;
+                nextRe[k] = zk.real();
+                nextIm[k] = zk.imag();
+            }
+        };
+
+        for (iterations_ = 0; iterations_ < options_.maxIterations; ++iterations_) {
+            std::size_t active = 0;
+            if (threads <= 1) {
+                correct(0, n, active);
+            } else {
+                std::vector<std::size_t> counts(threads, 0);
+                std::size_t chunk = (n + threads - 1) / threads;
+                pool->parallelFor(threads, [&](std::size_t t) {
+                    std::size_t begin = std::min(n, t * chunk);
+                    correct(begin, std::min(n, begin + chunk), counts[t]);
+                });
+                for (std::size_t count : counts) {
+                    active += count;
+                }
+            }
+            re.swap(nextRe);
+            im.swap(nextIm);
+            if (active == 0) {
+                break;
+            }
+        }
+        converged_ = std::find(done.begin(), done.end(), 0) == done.end();
+
+        for (std::size_t k = 0; k < n; ++k) {
+            z[k] = std::complex<double>(re[k], im[k]);
+        }
+        return z;
+    }
+};
+
+#endif // ROOT_FINDER_HPP
@@ -0,0 +1,224 @@
+#ifndef SPARSE_POLYNOMIAL_HPP
+#define SPARSE_POLYNOMIAL_HPP
+
+#include "Function.hpp"
+#include "Polynomial.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// SparsePolynomial.hpp
+// 稀疏多项式：只存非零项的(次数, 系数)对，按次数升序排列
+//
+// 例如 x^1000000 + 3x^7 + 1 只存3项。求值用稀疏的秦九韶算法：
+//   r = c_t;  r = r * x^(e_t - e_{t-1}) + c_{t-1};  ...;  r = r * x^(e_0)
+// 构造时把所有不同的差（连同最低次数e_0）排序去重；求值时先按从小到大的顺序算出它们的幂，
+// 每个幂由上一个乘以 x^(两者之差) 得到，所以每个不同的差只算一次（如间隔3,5,3,5只算x^3和x^5），
+// 代价是 O(t + d log(最大间隔))，d为不同的差的个数，而不是 O(次数)
+
+// 非零项占比低于这个值时makePolynomialFunction选用稀疏表示（由bench测得）
+constexpr double kSparseMaxFill = 0.05;
+
+// 快速幂 x^e
+template <typename T>
+T powerBySquaring(T x, std::size_t e) {
+    T result = T(1);
+    while (e > 0) {
+        if (e & 1) {
+            result = result * x;
+        }
+        e >>= 1;
+        if (e > 0) {
+            x = x * x;
+        }
+    }
+    return result;
+}
+
+template <typename T>
+class SparsePolynomial : public Function<T> {
+public:
+    typedef std::pair<std::size_t, T> Term; // (次数, 系数)
+
+private:
+    std::vector<Term> terms_;         // 按次数升序，次数互不相同，系数非零
+    std::vector<std::size_t> gaps_;     // 所有不同的 e_k - e_{k-1}（e_{-1}取0），升序
+    std::vector<std::size_t> gapIndex_; // gapIndex_[k]为 e_k - e_{k-1} 在gaps_中的位置（e_0为0时不用）
+
+    static constexpr std::size_t kInlinePowers = 4; // 不同的差不超过这么多时幂放在栈上
+
+public:
+    // 零多项式
+    SparsePolynomial() {}
+
+    // 由任意顺序的项构造，相同次数的项合并，系数为0的项去掉
+    explicit SparsePolynomial(std::vector<Term> terms) : terms_(std::move(terms)) {
+        normalize();
+        buildGaps();
+    }
+
+    // 由稠密多项式转换
+    explicit SparsePolynomial(const Polynomial<T>& p) {
+        const std::vector<T>& c = p.getCoefficients();
+        for (std::size_t i = 0; i < c.size(); ++i) {
+            if (c[i] != T()) {
+                terms_.push_back(Term(i, c[i]));
+            }
+        }
+        buildGaps();
+    }
+
+    // 计算多项式值（稀疏秦九韶算法）
+    T operator()(T x) const override {
+        if (terms_.empty()) {
+            return T();
+        }
+        // 各个不同的差的幂，从小到大，每个由上一个乘以差值的幂得到
+        T inlinePowers[kInlinePowers];
+        std::vector<T> heapPowers;
+        T* powers = inlinePowers;
+        if (gaps_.size() > kInlinePowers) {
+            heapPowers.resize(gaps_.size());
+            powers = heapPowers.data();
+        }
+        for (std::size_t i = 0; i < gaps_.size(); ++i) {
+            powers[i] = i == 0 ? powerBySquaring(x, gaps_[0])
+                               : powers[i - 1] * powerBySquaring(x, gaps_[i] - gaps_[i - 1]);
+        }
+
+        T result = terms_.back().second;
+        for (std::size_t k = terms_.size() - 1; k > 0; --k) {
+            result = result * powers[gapIndex_[k]] + terms_[k - 1].second;
+        }
+        if (terms_.front().first > 0) {
+            result = result * powers[gapIndex_[0]];
+        }
+        return result;
+    }
+
+    // 转换为稠密多项式
+    Polynomial<T> toPolynomial() const {
+        std::vector<T> c(terms_.empty() ? 1 : terms_.back().first + 1, T());
+        for (const Term& t : terms_) {
+            c[t.first] = t.second;
+        }
+        return Polynomial<T>(c);
+    }
+
+    // 获取非零项（按次数升序）
+    const std::vector<Term>& getTerms() const {
+        return terms_;
+    }
+
+    // 获取多项式的次数
+    std::size_t getDegree() const {
+        return terms_.empty() ? 0 : terms_.back().first;
+    }
+
+    // 非零项个数
+    std::size_t size() const {
+        return terms_.size();
+    }
+
+    // 非零项占稠密表示项数的比例
+    double fillRatio() const {
+        return static_cast<double>(terms_.size()) / static_cast<double>(getDegree() + 1);
+    }
+
+private:
+    void normalize() {
+        std::sort(terms_.begin(), terms_.end(),
+                  [](const Term& a, const Term& b) { return a.first < b.first; });
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < terms_.size();) {
+            Term merged = terms_[i];
+            for (++i; i < terms_.size() && terms_[i].first == merged.first; ++i) {
+                merged.second += terms_[i].second;
+            }
+            if (merged.second != T()) {
+                terms_[out++] = merged;
+            }
+        }
+        terms_.resize(out);
+    }
+
+    // 由terms_求出gaps_和gapIndex_
+    void buildGaps() {
+        gapIndex_.assign(terms_.size(), 0);
+        gaps_.clear();
+        for (std::size_t k = 0; k < terms_.size(); ++k) {
+            std::size_t gap = terms_[k].first - (k == 0 ? 0 : terms_[k - 1].first);
+            if (gap > 0) {
+                gaps_.push_back(gap);
+            }
+        }
+        std::sort(gaps_.begin(), gaps_.end());
+        gaps_.erase(std::unique(gaps_.begin(), gaps_.end()), gaps_.end());
+        for (std::size_t k = 0; k < terms_.size(); ++k) {
+            std::size_t gap = terms_[k].first - (k == 0 ? 0 : terms_[k - 1].first);
+            if (gap > 0) {
+                gapIndex_[k] = std::lower_bound(gaps_.begin(), gaps_.end(), gap) - gaps_.begin();
+            }
+        }
+    }
+};
+
+template <typename T>
+SparsePolynomial<T> operator+(const SparsePolynomial<T>& p, const SparsePolynomial<T>& q) {
+    typedef typename SparsePolynomial<T>::Term Term;
+    const std::vector<Term>& a = p.getTerms();
+    const std::vector<Term>& b = q.getTerms();
+    std::vector<Term> c;
+    c.reserve(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(c),
+               [](const Term& x, const Term& y) { return x.first < y.first; });
+    return SparsePolynomial<T>(std::move(c));
+}
+
+template <typename T>
+SparsePolynomial<T> operator-(const SparsePolynomial<T>& p) {
+    typedef typename SparsePolynomial<T>::Term Term;
+    std::vector<Term> c = p.getTerms();
+    for (Term& t : c) {
+        t.second = -t.second;
+    }
+    return SparsePolynomial<T>(std::move(c));
+}
+
+template <typename T>
+SparsePolynomial<T> operator-(const SparsePolynomial<T>& p, const SparsePolynomial<T>& q) {
+    return p + (-q);
+}
+
+// 乘法：每项两两相乘再按次数合并，O(t1 t2 log(t1 t2))
+template <typename T>
+SparsePolynomial<T> operator*(const SparsePolynomial<T>& p, const SparsePolynomial<T>& q) {
+    typedef typename SparsePolynomial<T>::Term Term;
+    std::vector<Term> c;
+    c.reserve(p.size() * q.size());
+    for (const Term& a : p.getTerms()) {
+        for (const Term& b : q.getTerms()) {
+            c.push_back(Term(a.first + b.first, a.second * b.second));
+        }
+    }
+    return SparsePolynomial<T>(std::move(c));
+}
+
+// 按填充率自动选择表示：非零项占比低于kSparseMaxFill时返回SparsePolynomial，否则返回Polynomial
+template <typename T>
+std::unique_ptr<Function<T>> makePolynomialFunction(const SparsePolynomial<T>& p) {
+    if (p.fillRatio() < kSparseMaxFill) {
+        return std::unique_ptr<Function<T>>(new SparsePolynomial<T>(p));
+    }
+    return std::unique_ptr<Function<T>>(new Polynomial<T>(p.toPolynomial()));
+}
+
+template <typename T>
+std::unique_ptr<Function<T>> makePolynomialFunction(const Polynomial<T>& p) {
+    return makePolynomialFunction(SparsePolynomial<T>(p));
+}
+
+#endif // SPARSE_POLYNOMIAL_HPP
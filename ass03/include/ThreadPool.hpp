@@ -0,0 +1,195 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ThreadPool.hpp
+// 工作窃取线程池
+//
+// 每个工作线程有自己的任务队列：在工作线程中提交的任务放进自己的队列尾部，
+// 从自己的队列尾部取任务（刚提交的任务数据还在缓存中），自己的队列空了再从
+// 其他队列头部窃取。在线程池外提交的任务轮流放进各个队列。
+// parallelFor等待时当前线程也执行任务，所以可以在任务中嵌套调用而不会死锁
+class ThreadPool {
+public:
+    // threads为0时使用硬件线程数
+    explicit ThreadPool(unsigned threads = 0) : pending_(0), next_(0), stop_(false) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            queues_.emplace_back(new Queue());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交一个任务，返回它的结果
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F f) {
+        typedef std::invoke_result_t<F> R;
+        std::shared_ptr<std::packaged_task<R()>> task(new std::packaged_task<R()>(std::move(f)));
+        std::future<R> result = task->get_future();
+        push([task] { (*task)(); });
+        return result;
+    }
+
+    // 并行执行 body(0), ..., body(n - 1)，返回时全部完成；每个下标是一个任务
+    template <typename Body>
+    void parallelFor(std::size_t n, const Body& body) {
+        if (n == 0) {
+            return;
+        }
+        std::atomic<std::size_t> remaining(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            push([&body, &remaining, i] {
+                body(i);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        // 等待的同时执行任务（可能是别的调用提交的）
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // 工作线程数（队列在启动线程前全部建好，所以用队列数）
+    unsigned size() const {
+        return static_cast<unsigned>(queues_.size());
+    }
+
+private:
+    typedef std::function<void()> Task;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::size_t pending_;         // 已提交、尚未取走的任务数（由sleepMutex_保护）
+    std::atomic<unsigned> next_;  // 线程池外提交时轮流选择队列
+    bool stop_;
+
+    // 当前线程在哪个线程池中是第几个工作线程
+    struct WorkerInfo {
+        const ThreadPool* pool;
+        unsigned index;
+    };
+
+    static WorkerInfo& currentWorker() {
+        thread_local WorkerInfo info = {nullptr, 0};
+        return info;
+    }
+
+    // 当前线程是本线程池的工作线程时返回它的下标，否则返回size()
+    unsigned selfIndex() const {
+        const WorkerInfo& info = currentWorker();
+        return info.pool == this ? info.index : size();
+    }
+
+    void push(Task task) {
+        unsigned self = selfIndex();
+        unsigned target = self < size() ? self : next_.fetch_add(1, std::memory_order_relaxed) % size();
+        // 先计数再入队，这样取走任务时的减1不会早于加1
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            ++pending_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    // 先取自己队列尾部的任务，再从其他队列头部窃取
+    bool tryPop(unsigned self, Task& task) {
+        unsigned n = size();
+        if (self < n) {
+            Queue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        unsigned start = self < n ? self + 1 : next_.load(std::memory_order_relaxed);
+        for (unsigned k = 0; k < n; ++k) {
+            unsigned victim = (start + k) % n;
+            if (victim == self) {
+                continue;
+            }
+            Queue& other = *queues_[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty()) {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool runOne() {
+        Task task;
+        if (!tryPop(selfIndex(), task)) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            --pending_;
+        }
+        task();
+        return true;
+    }
+
+    void workerLoop(unsigned index) {
+        currentWorker() = WorkerInfo{this, index};
+        for (;;) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+            if (stop_ && pending_ == 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
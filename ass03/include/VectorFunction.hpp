@@ -0,0 +1,208 @@
+#ifndef VECTOR_FUNCTION_HPP
+#define VECTOR_FUNCTION_HPP
+
+#include "Function.hpp"
+#include "LinearFunction.hpp"
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// VectorFunction.hpp
+// 向量值函数：输入是只读视图，结果写入调用方提供的输出缓冲区
+//
+// Function<T>::operator()(T x)按值传参、按值返回，T为std::vector<double>时每次调用
+// 都要复制一次输入、分配一次结果。VectorFunction<T>::evaluate(x, out)不分配内存，
+// 调用方可以在循环中反复使用同一个输出缓冲区；out可以与x是同一块内存（原地计算）
+
+// 连续内存的只读视图，可以由std::vector、std::array或指针和长度构造
+template <typename T>
+class VectorView {
+private:
+    const T* data_;
+    std::size_t size_;
+
+public:
+    VectorView(const T* data, std::size_t size) : data_(data), size_(size) {}
+    VectorView(const std::vector<T>& v) : data_(v.data()), size_(v.size()) {}
+    template <std::size_t N>
+    VectorView(const std::array<T, N>& v) : data_(v.data()), size_(N) {}
+
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+};
+
+// 连续内存的可写视图
+template <typename T>
+class MutableVectorView {
+private:
+    T* data_;
+    std::size_t size_;
+
+public:
+    MutableVectorView(T* data, std::size_t size) : data_(data), size_(size) {}
+    MutableVectorView(std::vector<T>& v) : data_(v.data()), size_(v.size()) {}
+    template <std::size_t N>
+    MutableVectorView(std::array<T, N>& v) : data_(v.data()), size_(N) {}
+
+    T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    T& operator[](std::size_t i) const { return data_[i]; }
+};
+
+template <typename T>
+class VectorFunction {
+public:
+    virtual ~VectorFunction() = default;
+
+    // 对x求值，结果写入out（out.size()必须等于getOutputSize(x.size())，可以与x相同）
+    virtual void evaluate(VectorView<T> x, MutableVectorView<T> out) const = 0;
+
+    // 输入为n维时输出的维数，默认与输入相同
+    virtual std::size_t getOutputSize(std::size_t n) const {
+        return n;
+    }
+
+    // 方便使用的版本：分配并返回结果
+    std::vector<T> operator()(VectorView<T> x) const {
+        std::vector<T> out(getOutputSize(x.size()));
+        evaluate(x, out);
+        return out;
+    }
+};
+
+// out[i] = a * x[i] + b[i]。x、b、out互不重叠时用restrict版本，编译器不需要运行时检查
+// 重叠就能向量化；out与x相同时用原地版本。
+// -O2下GCC只向量化不需要剩余部分的循环，所以按kAxpyBlock个一组写，组内循环次数固定
+constexpr std::size_t kAxpyBlock = 4;
+
+inline void axpy(double a, const double* __restrict x, const double* __restrict b, double* __restrict out,
+                 std::size_t n) {
+    std::size_t i = 0;
+    for (; i + kAxpyBlock <= n; i += kAxpyBlock) {
+        for (std::size_t k = 0; k < kAxpyBlock; ++k) {
+            out[i + k] = a * x[i + k] + b[i + k];
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = a * x[i] + b[i];
+    }
+}
+
+inline void axpyInPlace(double a, double* __restrict x, const double* __restrict b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + kAxpyBlock <= n; i += kAxpyBlock) {
+        for (std::size_t k = 0; k < kAxpyBlock; ++k) {
+            x[i + k] = a * x[i + k] + b[i + k];
+        }
+    }
+    for (; i < n; ++i) {
+        x[i] = a * x[i] + b[i];
+    }
+}
+
+// 检查重叠后选择axpy或axpyInPlace；部分重叠时退回不带restrict的循环
+inline void affine(double a, const double* x, const double* b, double* out, std::size_t n) {
+    if (out == x) {
+        axpyInPlace(a, out, b, n);
+    } else if (out + n <= x || x + n <= out) {
+        axpy(a, x, b, out, n);
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = a * x[i] + b[i];
+        }
+    }
+}
+
+// 向量的仿射映射 f(x) = ax + b，a为标量，b为向量
+template <>
+class LinearFunction<std::vector<double>> : public Function<std::vector<double>>, public VectorFunction<double> {
+private:
+    double a_;              // 斜率
+    std::vector<double> b_; // 截距
+
+public:
+    LinearFunction(double a, const std::vector<double>& b) : a_(a), b_(b) {}
+
+    // Function接口：按值传参并分配结果，与其他Function<T>一起使用时的兼容写法
+    std::vector<double> operator()(std::vector<double> x) const override {
+        evaluate(x, x);
+        return x;
+    }
+
+    using VectorFunction<double>::operator();
+
+    // 不分配内存：结果写入out
+    void evaluate(VectorView<double> x, MutableVectorView<double> out) const override {
+        if (x.size() != b_.size() || out.size() != b_.size()) {
+            throw std::invalid_argument("LinearFunction: dimension mismatch");
+        }
+        affine(a_, x.data(), b_.data(), out.data(), b_.size());
+    }
+
+    // 批量计算n个向量
+    void evaluate(const std::vector<double>* xs, std::vector<double>* out, std::size_t n) const override {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i].resize(b_.size());
+            evaluate(xs[i], out[i]);
+        }
+    }
+
+    // 获取斜率
+    double getSlope() const {
+        return a_;
+    }
+
+    // 获取截距
+    const std::vector<double>& getIntercept() const {
+        return b_;
+    }
+};
+
+// 定长向量的仿射映射：std::array按值传递不分配内存，维数在编译期确定，循环可以完全展开
+template <std::size_t N>
+class LinearFunction<std::array<double, N>> : public Function<std::array<double, N>>, public VectorFunction<double> {
+private:
+    double a_;                 // 斜率
+    std::array<double, N> b_;  // 截距
+
+public:
+    LinearFunction(double a, const std::array<double, N>& b) : a_(a), b_(b) {}
+
+    std::array<double, N> operator()(std::array<double, N> x) const override {
+        axpyInPlace(a_, x.data(), b_.data(), N);
+        return x;
+    }
+
+    using VectorFunction<double>::operator();
+
+    void evaluate(VectorView<double> x, MutableVectorView<double> out) const override {
+        if (x.size() != N || out.size() != N) {
+            throw std::invalid_argument("LinearFunction: dimension mismatch");
+        }
+        affine(a_, x.data(), b_.data(), out.data(), N);
+    }
+
+    void evaluate(const std::array<double, N>* xs, std::array<double, N>* out, std::size_t n) const override {
+        for (std::size_t i = 0; i < n; ++i) {
+            affine(a_, xs[i].data(), b_.data(), out[i].data(), N);
+        }
+    }
+
+    std::size_t getOutputSize(std::size_t) const override {
+        return N;
+    }
+
+    // 获取斜率
+    double getSlope() const {
+        return a_;
+    }
+
+    // 获取截距
+    const std::array<double, N>& getIntercept() const {
+        return b_;
+    }
+};
+
+#endif // VECTOR_FUNCTION_HPP
@@ -0,0 +1,836 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/Function.hpp"
+#include "../include/LinearFunction.hpp"
+#include "../include/VectorFunction.hpp"
+#include "../include/Polynomial.hpp"
+#include "../include/Expression.hpp"
+#include "../include/PolynomialPack.hpp"
+#include "../include/PolynomialArithmetic.hpp"
+#include "../include/RootFinder.hpp"
+#include "../include/MultipointEval.hpp"
+#include "../include/Dual.hpp"
+#include "../include/NewtonSolver.hpp"
+#include "../include/FixedPolynomial.hpp"
+#include "../include/SparsePolynomial.hpp"
+#include "../include/Chebyshev.hpp"
+#include "../include/Quadrature.hpp"
+
+#ifdef USE_GMP
+#include <gmpxx.h>
+#endif
+
+// 性能测试：逐点虚函数调用与批量evaluate的对比
+
+// 防止编译器把没有用到的结果优化掉
+volatile double g_sink;
+
+// 运行fn若干次，返回单次的最短耗时（秒）
+template <typename Fn>
+double timeIt(Fn fn, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+// 比较一个函数的两种调用方式；f通过基类引用传入，和实际使用时一样走虚函数
+void compare(const std::string& name, const Function<double>& f,
+             const std::vector<double>& xs, int repeats) {
+    std::size_t n = xs.size();
+    std::vector<double> scalarOut(n), batchOut(n);
+
+    double scalarTime = timeIt([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            scalarOut[i] = f(xs[i]);
+        }
+        g_sink = scalarOut[n / 2];
+    }, repeats);
+
+    double batchTime = timeIt([&] {
+        f.evaluate(xs.data(), batchOut.data(), n);
+        g_sink = batchOut[n / 2];
+    }, repeats);
+
+    double maxDiff = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        maxDiff = std::max(maxDiff, std::abs(scalarOut[i] - batchOut[i]));
+    }
+
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2) << scalarTime * 1e9 / n << " ns"
+              << std::setw(10) << batchTime * 1e9 / n << " ns"
+              << std::setw(9) << scalarTime / batchTime << "x"
+              << std::setw(12) << std::scientific << std::setprecision(1) << maxDiff
+              << std::endl;
+}
+
+// 用虚函数层层组合的写法，作为表达式模板的对照
+class VirtualCompose : public Function<double> {
+private:
+    const Function<double>& outer_;
+    const Function<double>& inner_;
+
+public:
+    VirtualCompose(const Function<double>& outer, const Function<double>& inner)
+        : outer_(outer), inner_(inner) {}
+
+    double operator()(double x) const override {
+        return outer_(inner_(x));
+    }
+};
+
+class VirtualScaledSum : public Function<double> {
+private:
+    double scale_;
+    const Function<double>& l_;
+    const Function<double>& r_;
+
+public:
+    VirtualScaledSum(double scale, const Function<double>& l, const Function<double>& r)
+        : scale_(scale), l_(l), r_(r) {}
+
+    double operator()(double x) const override {
+        return scale_ * l_(x) + r_(x);
+    }
+};
+
+class Square : public Function<double> {
+public:
+    double operator()(double x) const override {
+        return x * x;
+    }
+};
+
+// 计时一种组合方式并打印每个点的耗时
+template <typename Fn>
+void reportPipeline(const std::string& name, Fn fn, const std::vector<double>& out,
+                    const std::vector<double>& reference, int repeats) {
+    double t = timeIt(fn, repeats);
+    double maxDiff = 0.0;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(out[i] - reference[i]));
+    }
+    std::cout << std::left << std::setw(36) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2) << t * 1e9 / out.size() << " ns"
+              << std::setw(12) << std::scientific << std::setprecision(1) << maxDiff << std::endl;
+}
+
+// 组合函数 h(x) = 2 * p(l(x)) + x^2 的几种写法
+void benchPipeline(const std::vector<double>& xs, int repeats) {
+    std::size_t n = xs.size();
+    LinearFunction<double> l(0.5, 0.25);
+    Polynomial<double> p({1.0, -2.0, 0.5, 3.0, -1.5});
+    Square sq;
+
+    // 手写循环作为参照
+    std::vector<double> reference(n), out(n);
+    const std::vector<double>& c = p.getCoefficients();
+    auto handWritten = [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            double x = xs[i];
+            double u = 0.5 * x + 0.25;
+            double v = (((c[4] * u + c[3]) * u + c[2]) * u + c[1]) * u + c[0];
+            reference[i] = 2.0 * v + x * x;
+        }
+        g_sink = reference[n / 2];
+    };
+
+    VirtualCompose pl(p, l);
+    VirtualScaledSum virtualPipeline(2.0, pl, sq);
+
+    auto exprPipeline = 2.0 * makeExpr(p)(makeExpr(l)) +
+                        makeLambdaExpr<double>([](double x) { return x * x; });
+    std::unique_ptr<Function<double>> erased = makeFunction(exprPipeline);
+
+    std::cout << std::endl << "Pipeline h(x) = 2 * p(l(x)) + x^2" << std::endl;
+    std::cout << std::left << std::setw(36) << "Implementation" << std::right
+              << std::setw(13) << "time/pt" << std::setw(12) << "max diff" << std::endl;
+
+    reportPipeline("hand-written loop", handWritten, reference, reference, repeats);
+    reportPipeline("virtual Function stack", [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = virtualPipeline(xs[i]);
+        }
+        g_sink = out[n / 2];
+    }, out, reference, repeats);
+    reportPipeline("expression template evaluate", [&] {
+        exprPipeline.evaluate(xs.data(), out.data(), n);
+        g_sink = out[n / 2];
+    }, out, reference, repeats);
+    reportPipeline("ExprFunction via Function<double>", [&] {
+        erased->evaluate(xs.data(), out.data(), n);
+        g_sink = out[n / 2];
+    }, out, reference, repeats);
+}
+
+// 相对误差，参照值用long double的秦九韶算法计算
+double relativeError(double value, long double reference) {
+    long double scale = std::fabs(reference) > 1e-300L ? std::fabs(reference) : 1.0L;
+    return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / scale);
+}
+
+// 比较秦九韶算法与Estrin方法的单点求值
+// latency：下一个点依赖上一个结果，测量依赖链长度；throughput：各点互相独立
+void benchSchemes(const std::vector<double>& xs, int repeats) {
+    std::size_t n = xs.size();
+
+    std::cout << std::endl << "Single-point schemes (ns per call)" << std::endl;
+    std::cout << std::setw(8) << "degree"
+              << std::setw(12) << "Horner lat" << std::setw(12) << "Estrin lat"
+              << std::setw(12) << "Horner thr" << std::setw(12) << "Estrin thr"
+              << std::setw(13) << "Horner err" << std::setw(13) << "Estrin err"
+              << std::setw(8) << "Auto" << std::endl;
+
+    int degrees[] = {4, 8, 12, 16, 24, 32, 64, 256};
+    for (int degree : degrees) {
+        std::vector<double> coeffs(degree + 1);
+        std::vector<long double> exact(degree + 1);
+        for (int k = 0; k <= degree; ++k) {
+            coeffs[k] = (k % 2 ? -1.0 : 1.0) / (k + 1);
+            exact[k] = coeffs[k];
+        }
+        Polynomial<double> p(coeffs);
+
+        auto latency = [&](bool estrin) {
+            return timeIt([&] {
+                double acc = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    // acc * 0.0 不能被优化掉，使下一次求值依赖上一次的结果
+                    double x = xs[i] + acc * 0.0;
+                    acc = estrin ? p.estrin(x) : p.horner(x);
+                }
+                g_sink = acc;
+            }, repeats);
+        };
+        auto throughput = [&](bool estrin) {
+            return timeIt([&] {
+                double sum = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += estrin ? p.estrin(xs[i]) : p.horner(xs[i]);
+                }
+                g_sink = sum;
+            }, repeats);
+        };
+
+        double hornerErr = 0.0, estrinErr = 0.0;
+        for (std::size_t i = 0; i < n; i += 97) {
+            long double ref = 0.0L;
+            for (int k = degree; k >= 0; --k) {
+                ref = ref * xs[i] + exact[k];
+            }
+            hornerErr = std::max(hornerErr, relativeError(p.horner(xs[i]), ref));
+            estrinErr = std::max(estrinErr, relativeError(p.estrin(xs[i]), ref));
+        }
+
+        std::cout << std::setw(8) << degree << std::fixed << std::setprecision(2)
+                  << std::setw(12) << latency(false) * 1e9 / n
+                  << std::setw(12) << latency(true) * 1e9 / n
+                  << std::setw(12) << throughput(false) * 1e9 / n
+                  << std::setw(12) << throughput(true) * 1e9 / n
+                  << std::scientific << std::setprecision(1)
+                  << std::setw(13) << hornerErr << std::setw(13) << estrinErr
+                  << std::setw(8) << (p.usesEstrin() ? "Estrin" : "Horner") << std::endl;
+    }
+}
+
+// 同一点上计算多个多项式：逐个计算与PolynomialPack的对比
+void benchPack(const std::vector<double>& xs, int repeats) {
+    const std::size_t count = 16;
+    const int degree = 12;
+    std::vector<Polynomial<double>> polys;
+    for (std::size_t p = 0; p < count; ++p) {
+        std::vector<double> coeffs(degree + 1);
+        for (int k = 0; k <= degree; ++k) {
+            coeffs[k] = std::sin(1.0 + p + 0.37 * k);
+        }
+        polys.push_back(Polynomial<double>(coeffs, EvalScheme::Horner));
+    }
+    PolynomialPack<double> pack(polys);
+
+    std::size_t n = xs.size() / count;
+    std::vector<double> separate(n * count), packed(n * count);
+
+    double separateTime = timeIt([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t p = 0; p < count; ++p) {
+                separate[i * count + p] = polys[p].horner(xs[i]);
+            }
+        }
+        g_sink = separate[n / 2];
+    }, repeats);
+
+    double packTime = timeIt([&] {
+        pack.evaluate(xs.data(), packed.data(), n);
+        g_sink = packed[n / 2];
+    }, repeats);
+
+    double maxDiff = 0.0;
+    for (std::size_t i = 0; i < separate.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(separate[i] - packed[i]));
+    }
+
+    std::cout << std::endl << count << " polynomials of degree " << degree << " at " << n
+              << " points (ns per polynomial value)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "  separate Horner calls " << separateTime * 1e9 / (n * count) << " ns" << std::endl
+              << "  PolynomialPack        " << packTime * 1e9 / (n * count) << " ns ("
+              << separateTime / packTime << "x), max diff "
+              << std::scientific << std::setprecision(1) << maxDiff << std::endl;
+}
+
+// 某种乘法算法的单次耗时（毫秒），太慢的组合跳过并返回负数
+template <typename T>
+double timeMultiply(const Polynomial<T>& a, const Polynomial<T>& b, MultiplyAlgorithm algorithm,
+                    std::size_t maxSchoolbook) {
+    std::size_t n = a.getCoefficients().size();
+    if ((algorithm == MultiplyAlgorithm::Schoolbook && n > maxSchoolbook) ||
+        (algorithm == MultiplyAlgorithm::Karatsuba && n > 65536)) {
+        return -1.0;
+    }
+    int repeats = n <= 1024 ? 5 : 1;
+    return timeIt([&] {
+        Polynomial<T> c = multiply(a, b, algorithm);
+        g_sink = static_cast<double>(c.getDegree());
+    }, repeats) * 1e3;
+}
+
+// 比较各乘法算法，Auto列是实际选用的算法的耗时
+template <typename T>
+void benchMultiplyType(const std::string& name, std::size_t maxSize) {
+    std::cout << std::endl << "Polynomial multiplication, " << name << " coefficients (ms, '-' = skipped)" << std::endl;
+    std::cout << std::setw(10) << "terms" << std::setw(13) << "schoolbook" << std::setw(13) << "Karatsuba"
+              << std::setw(13) << "FFT/NTT" << std::setw(13) << "Auto" << std::setw(13) << "FFT err" << std::endl;
+
+    for (std::size_t n = 16; n <= maxSize; n *= 4) {
+        std::vector<T> ca(n), cb(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ca[i] = static_cast<T>(static_cast<int>((i * 7919) % 2001) - 1000);
+            cb[i] = static_cast<T>(static_cast<int>((i * 104729) % 2001) - 1000);
+        }
+        Polynomial<T> a(ca), b(cb);
+
+        double times[4] = {
+            timeMultiply(a, b, MultiplyAlgorithm::Schoolbook, 16384),
+            timeMultiply(a, b, MultiplyAlgorithm::Karatsuba, 0),
+            timeMultiply(a, b, MultiplyAlgorithm::FFT, 0),
+            timeMultiply(a, b, MultiplyAlgorithm::Auto, 0)
+        };
+
+        // FFT结果与精确的Karatsuba结果的最大差值（整数NTT应为0）
+        double err = -1.0;
+        if (n <= 65536) {
+            err = 0.0;
+            std::vector<T> exact = multiply(a, b, MultiplyAlgorithm::Karatsuba).getCoefficients();
+            std::vector<T> approx = multiply(a, b, MultiplyAlgorithm::FFT).getCoefficients();
+            for (std::size_t i = 0; i < exact.size(); ++i) {
+                err = std::max(err, static_cast<double>(std::abs(exact[i] - approx[i])));
+            }
+        }
+
+        std::cout << std::setw(10) << n << std::fixed << std::setprecision(3);
+        for (double t : times) {
+            if (t >= 0) {
+                std::cout << std::setw(13) << t;
+            } else {
+                std::cout << std::setw(13) << "-";
+            }
+        }
+        if (err >= 0) {
+            std::cout << std::scientific << std::setprecision(1) << std::setw(13) << err << std::endl;
+        } else {
+            std::cout << std::setw(13) << "-" << std::endl;
+        }
+    }
+}
+
+// Aberth–Ehrlich求根：随机复系数多项式，单线程与多线程的耗时
+void benchRootFinder(std::size_t maxDegree) {
+    std::cout << std::endl << "Aberth-Ehrlich root finding, random complex coefficients" << std::endl;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::setw(10) << "degree" << std::setw(12) << "iterations"
+              << std::setw(14) << "1 thread (s)" << std::setw(16) << "threads (s)" << std::endl;
+
+    for (std::size_t degree = 100; degree <= maxDegree; degree *= 10) {
+        std::vector<std::complex<double>> coeffs(degree + 1);
+        for (std::size_t i = 0; i <= degree; ++i) {
+            coeffs[i] = std::complex<double>(std::cos(1.0 + 3.0 * i), std::sin(2.0 * i * i));
+        }
+        Polynomial<std::complex<double>> p(coeffs);
+
+        RootFinder::Options options;
+        options.threads = 1;
+        RootFinder serial(options);
+        double serialTime = timeIt([&] { g_sink = serial.findRoots(p)[0].real(); }, 1);
+
+        options.threads = hardware;
+        RootFinder parallel(options);
+        double parallelTime = timeIt([&] { g_sink = parallel.findRoots(p)[0].real(); }, 1);
+
+        std::cout << std::setw(10) << degree << std::setw(12) << serial.getIterations()
+                  << std::fixed << std::setprecision(3) << std::setw(14) << serialTime
+                  << std::setw(10) << parallelTime << " (" << std::setw(2) << hardware << ")" << std::endl;
+    }
+}
+
+// 多点求值与插值：n次多项式在单位圆附近的n个点上，子乘积树与逐点秦九韶算法的对比
+void benchMultipoint(std::size_t maxSize) {
+    typedef std::complex<double> C;
+    std::cout << std::endl << "Multipoint evaluation / interpolation, n points near the unit circle (ms)" << std::endl;
+    std::cout << std::setw(10) << "n" << std::setw(12) << "Horner" << std::setw(12) << "tree build"
+              << std::setw(12) << "tree eval" << std::setw(12) << "interp" << std::setw(12) << "eval err"
+              << std::setw(12) << "interp err" << std::endl;
+
+    const double pi = std::acos(-1.0);
+    for (std::size_t n = 256; n <= maxSize; n *= 4) {
+        std::vector<C> coeffs(n), points(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            coeffs[i] = C(std::cos(1.0 + 3.0 * i), std::sin(2.0 * i * i));
+            // 等分点加上不超过间距0.3倍的扰动
+            double jitter = 0.3 * std::sin(7.0 * i * i + 1.0);
+            points[i] = std::polar(1.0, 2.0 * pi * (i + jitter) / n);
+        }
+        Polynomial<C> p(coeffs);
+
+        std::vector<C> horner(n);
+        double hornerTime = n <= 16384 ? timeIt([&] { p.evaluate(points.data(), horner.data(), n); }, 1) : -1.0;
+
+        auto start = std::chrono::steady_clock::now();
+        SubproductTree<C> tree(points);
+        double buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::vector<C> fast;
+        double evalTime = timeIt([&] { fast = tree.evaluate(p); }, 1);
+        Polynomial<C> q(std::vector<C>(1));
+        double interpTime = timeIt([&] { q = tree.interpolate(fast); }, 1);
+
+        double evalErr = -1.0, interpErr = 0.0;
+        if (hornerTime >= 0) {
+            evalErr = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                evalErr = std::max(evalErr, std::abs(fast[i] - horner[i]) / std::abs(horner[i]));
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            interpErr = std::max(interpErr, std::abs(q.getCoefficients()[i] - coeffs[i]));
+        }
+
+        std::cout << std::setw(10) << n << std::fixed << std::setprecision(3);
+        if (hornerTime >= 0) {
+            std::cout << std::setw(12) << hornerTime * 1e3;
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::setw(12) << buildTime * 1e3 << std::setw(12) << evalTime * 1e3
+                  << std::setw(12) << interpTime * 1e3 << std::scientific << std::setprecision(1);
+        if (evalErr >= 0) {
+            std::cout << std::setw(12) << evalErr;
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::setw(12) << interpErr << std::endl;
+    }
+}
+
+// 自动微分：函数值加导数的耗时与只求函数值、有限差分的对比
+// 延迟：下一个点依赖上一个结果（如Newton迭代）；吞吐量：各点互不依赖
+void benchDual(const std::vector<double>& xs, int repeats) {
+    typedef Dual<double> D;
+    std::size_t n = xs.size();
+    std::cout << std::endl << "Value + derivative with Horner (ns per point)" << std::endl;
+    std::cout << std::setw(8) << "degree" << std::setw(12) << "value lat" << std::setw(12) << "Dual lat"
+              << std::setw(12) << "diff lat" << std::setw(12) << "value thr" << std::setw(12) << "Dual thr"
+              << std::setw(12) << "diff thr" << std::endl;
+
+    int degrees[] = {4, 16, 64};
+    for (int degree : degrees) {
+        std::vector<double> coeffs(degree + 1);
+        for (int k = 0; k <= degree; ++k) {
+            coeffs[k] = 1.0 / (k + 1);
+        }
+        Polynomial<double> p(coeffs);
+        Polynomial<D> pd(std::vector<D>(coeffs.begin(), coeffs.end()));
+
+        // 每种方法返回 f(x) + f'(x)，有限差分用前向差分（两次求值）
+        const double h = 1e-7;
+        auto value = [&](double x) { return p.horner(x); };
+        auto dual = [&](double x) {
+            D y = pd.horner(D::variable(x));
+            return y.getValue() + y.getTangent();
+        };
+        auto difference = [&](double x) {
+            double y = p.horner(x);
+            return y + (p.horner(x + h) - y) / h;
+        };
+
+        auto latency = [&](auto f) {
+            return timeIt([&] {
+                double acc = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    acc = f(xs[i] + acc * 0.0);
+                }
+                g_sink = acc;
+            }, repeats);
+        };
+        auto throughput = [&](auto f) {
+            return timeIt([&] {
+                double sum = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += f(xs[i]);
+                }
+                g_sink = sum;
+            }, repeats);
+        };
+
+        double scale = 1e9 / static_cast<double>(n);
+        std::cout << std::setw(8) << degree << std::fixed << std::setprecision(2)
+                  << std::setw(12) << latency(value) * scale << std::setw(12) << latency(dual) * scale
+                  << std::setw(12) << latency(difference) * scale << std::setw(12) << throughput(value) * scale
+                  << std::setw(12) << throughput(dual) * scale << std::setw(12) << throughput(difference) * scale
+                  << std::endl;
+    }
+}
+
+// 编译期次数的多项式：与手写乘加、运行时Polynomial的对比（ns/pt）
+void benchFixed(const std::vector<double>& xs, int repeats) {
+    std::size_t n = xs.size();
+    constexpr FixedPolynomial<double, 5> fixed(1.0, 0.5, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720);
+    const std::array<double, 6>& c = fixed.getCoefficients();
+    Polynomial<double> dynamic(std::vector<double>(c.begin(), c.end()));
+    std::unique_ptr<Function<double>> wrapped = makeFunction(fixed);
+    std::vector<double> out(n);
+
+    auto loop = [&](auto f) {
+        return timeIt([&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += f(xs[i]);
+            }
+            g_sink = sum;
+        }, repeats);
+    };
+    double hand = loop([&](double x) {
+        return ((((c[5] * x + c[4]) * x + c[3]) * x + c[2]) * x + c[1]) * x + c[0];
+    });
+    double fixedTime = loop([&](double x) { return fixed(x); });
+    double dynamicTime = loop([&](double x) { return dynamic.horner(x); });
+    double fixedBatch = timeIt([&] { wrapped->evaluate(xs.data(), out.data(), n); }, repeats);
+    double dynamicBatch = timeIt([&] { dynamic.evaluate(xs.data(), out.data(), n); }, repeats);
+
+    double scale = 1e9 / static_cast<double>(n);
+    std::cout << std::endl << "Degree 5, compile-time vs runtime degree (ns/pt)" << std::endl;
+    std::cout << std::setw(14) << "hand-written" << std::setw(16) << "FixedPolynomial" << std::setw(12) << "Polynomial"
+              << std::setw(14) << "Fixed batch" << std::setw(14) << "Poly batch" << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << std::setw(14) << hand * scale << std::setw(16) << fixedTime * scale
+              << std::setw(12) << dynamicTime * scale << std::setw(14) << fixedBatch * scale
+              << std::setw(14) << dynamicBatch * scale << std::endl;
+}
+
+// 稀疏与稠密表示的求值时间（每点纳秒），以及随填充率变化的分界点
+void benchSparse(std::size_t points) {
+    typedef SparsePolynomial<double>::Term Term;
+    std::vector<double> xs(points);
+    for (std::size_t i = 0; i < points; ++i) {
+        xs[i] = -1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(points);
+    }
+    auto perPoint = [&](const Function<double>& f, int repeats) {
+        double t = timeIt([&] {
+            double sum = 0.0;
+            for (double x : xs) {
+                sum += f(x);
+            }
+            g_sink = sum;
+        }, repeats);
+        return t * 1e9 / static_cast<double>(points);
+    };
+
+    SparsePolynomial<double> huge({Term(1000000, 1.0), Term(7, 3.0), Term(0, 1.0)});
+    Polynomial<double> hugeDense = huge.toPolynomial();
+    std::cout << std::endl << "x^1000000 + 3x^7 + 1 (ns/pt)" << std::endl;
+    std::cout << std::setw(12) << "sparse" << std::setw(14) << "dense" << std::setw(12) << "speedup" << std::endl;
+    double sparseTime = perPoint(huge, 5);
+    double denseTime = perPoint(hugeDense, 1);
+    std::cout << std::fixed << std::setprecision(1) << std::setw(12) << sparseTime << std::setw(14) << denseTime
+              << std::setw(11) << denseTime / sparseTime << "x" << std::endl;
+
+    const std::size_t degree = 4096;
+    std::cout << std::endl << "Degree " << degree << ", random exponents (ns/pt, kSparseMaxFill = "
+              << std::setprecision(2) << kSparseMaxFill << ")" << std::endl;
+    std::cout << std::setw(8) << "fill" << std::setw(12) << "sparse" << std::setw(12) << "dense" << std::endl;
+    std::srand(7);
+    double fills[] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2};
+    for (double fill : fills) {
+        std::vector<Term> terms(1, Term(degree, 1.0));
+        for (std::size_t k = 1; k < static_cast<std::size_t>(fill * (degree + 1)); ++k) {
+            terms.push_back(Term(std::rand() % degree, 1.0 / static_cast<double>(k + 1)));
+        }
+        SparsePolynomial<double> sparse(terms);
+        Polynomial<double> dense = sparse.toPolynomial();
+        std::cout << std::setprecision(3) << std::setw(8) << sparse.fillRatio() << std::setprecision(1)
+                  << std::setw(12) << perPoint(sparse, 3) << std::setw(12) << perPoint(dense, 3) << std::endl;
+    }
+}
+
+// 计算代价较高的函数：截断的Fourier级数 sum sin(kx) / k^2，k = 1..32
+class FourierSeries : public Function<double> {
+public:
+    double operator()(double x) const override {
+        double sum = 0.0;
+        for (int k = 1; k <= 32; ++k) {
+            sum += std::sin(k * x) / (k * k);
+        }
+        return sum;
+    }
+};
+
+// Chebyshev近似：拟合耗时（单线程与多线程）、近似与直接求值的每点耗时和误差
+void benchChebyshev(const std::vector<double>& xs, int repeats) {
+    std::size_t n = xs.size();
+    FourierSeries f;
+    std::vector<double> out(n), reference(n);
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    ChebyshevApproximation<double>::Options serial, parallel;
+    serial.threads = 1;
+    parallel.threads = hardware;
+    double fitSerial = timeIt([&] { ChebyshevApproximation<double> a(f, -3.0, 3.0, serial); g_sink = a(0.5); }, repeats);
+    double fitParallel = timeIt([&] { ChebyshevApproximation<double> a(f, -3.0, 3.0, parallel); g_sink = a(0.5); }, repeats);
+    ChebyshevApproximation<double> approx(f, -3.0, 3.0);
+
+    double direct = timeIt([&] { f.evaluate(xs.data(), reference.data(), n); }, repeats);
+    double surrogate = timeIt([&] { approx.evaluate(xs.data(), out.data(), n); }, repeats);
+    double maxDiff = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        maxDiff = std::max(maxDiff, std::abs(out[i] - reference[i]));
+    }
+
+    std::cout << std::endl << "Chebyshev surrogate of sum sin(kx)/k^2 (k <= 32) on [-3, 3]: "
+              << approx.getPieces().size() << " pieces, max degree " << approx.getDegree() << std::endl;
+    std::cout << std::setw(12) << "fit 1 thr" << std::setw(12) << "fit " + std::to_string(hardware) + " thr"
+              << std::setw(12) << "direct" << std::setw(12) << "surrogate" << std::setw(10) << "speedup"
+              << std::setw(12) << "max diff" << std::endl;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(1) << fitSerial * 1e6 << std::setw(12) << fitParallel * 1e6
+              << std::setw(12) << direct * 1e9 / n << std::setw(12) << surrogate * 1e9 / n
+              << std::setw(9) << direct / surrogate << "x" << std::setw(12) << std::scientific << std::setprecision(1)
+              << maxDiff << std::endl;
+    std::cout << std::setw(24) << "(us)" << std::setw(24) << "(ns/pt)" << std::endl;
+}
+
+// 向量值仿射映射 f(x) = ax + b：按值传参返回新向量与写入调用方缓冲区的对比（每个分量纳秒）
+void benchVectorFunction(std::size_t dim, int repeats) {
+    std::vector<double> b(dim), x(dim), out(dim);
+    for (std::size_t i = 0; i < dim; ++i) {
+        b[i] = 1.0 / static_cast<double>(i + 1);
+        x[i] = static_cast<double>(i % 97) * 0.01;
+    }
+    LinearFunction<std::vector<double>> f(0.5, b);
+    const Function<std::vector<double>>& byValue = f;
+    const int calls = 10;
+
+    // Function接口：每次调用复制输入并返回新向量
+    double allocating = timeIt([&] {
+        for (int k = 0; k < calls; ++k) {
+            std::vector<double> y = byValue(x);
+            g_sink = y[dim / 2];
+        }
+    }, repeats);
+    // 手写循环写入已有的缓冲区，作为参照
+    double hand = timeIt([&] {
+        for (int k = 0; k < calls; ++k) {
+            for (std::size_t i = 0; i < dim; ++i) {
+                out[i] = 0.5 * x[i] + b[i];
+            }
+            g_sink = out[dim / 2];
+        }
+    }, repeats);
+    double buffered = timeIt([&] {
+        for (int k = 0; k < calls; ++k) {
+            f.evaluate(x, out);
+            g_sink = out[dim / 2];
+        }
+    }, repeats);
+    double inPlace = timeIt([&] {
+        for (int k = 0; k < calls; ++k) {
+            f.evaluate(out, out);
+            g_sink = out[dim / 2];
+        }
+    }, repeats);
+
+    double scale = 1e9 / (static_cast<double>(dim) * calls);
+    std::cout << std::endl << "Affine map on R^" << dim << " (ns per component)" << std::endl;
+    std::cout << std::setw(14) << "by value" << std::setw(14) << "hand loop" << std::setw(14) << "into buffer"
+              << std::setw(14) << "in place" << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << std::setw(14) << allocating * scale << std::setw(14) << hand * scale
+              << std::setw(14) << buffered * scale << std::setw(14) << inPlace * scale << std::endl;
+}
+
+// 自适应积分：复合梯形公式与Gauss-Kronrod（单线程、线程池）的求值次数和耗时
+void benchQuadrature(int repeats) {
+    FourierSeries f;
+    const double a = 0.0, b = 3.0;
+    // 精确值：sum (1 - cos(3k)) / k^3
+    double exact = 0.0;
+    for (int k = 1; k <= 32; ++k) {
+        exact += (1.0 - std::cos(3.0 * k)) / (static_cast<double>(k) * k * k);
+    }
+
+    std::cout << std::endl << "Integral of sum sin(kx)/k^2 (k <= 32) on [0, 3]" << std::endl;
+    std::cout << std::left << std::setw(28) << "method" << std::right << std::setw(12) << "evals"
+              << std::setw(12) << "time (us)" << std::setw(12) << "error" << std::endl;
+
+    std::size_t points[] = {1000, 100000};
+    for (std::size_t n : points) {
+        double value = 0.0;
+        double t = timeIt([&] {
+            double h = (b - a) / static_cast<double>(n);
+            double sum = (f(a) + f(b)) / 2.0;
+            for (std::size_t i = 1; i < n; ++i) {
+                sum += f(a + h * static_cast<double>(i));
+            }
+            value = sum * h;
+        }, repeats);
+        std::cout << std::left << std::setw(28) << "trapezoid " + std::to_string(n) << std::right << std::setw(12) << n + 1
+                  << std::setw(12) << std::fixed << std::setprecision(1) << t * 1e6
+                  << std::setw(12) << std::scientific << std::setprecision(1) << std::abs(value - exact) << std::endl;
+    }
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    unsigned threads[] = {1, hardware};
+    for (unsigned thr : threads) {
+        AdaptiveQuadrature<double>::Options options;
+        options.threads = thr;
+        AdaptiveQuadrature<double> quadrature(options);
+        double value = 0.0;
+        double t = timeIt([&] { value = quadrature.integrate(f, a, b); }, repeats);
+        // 每个最终子区间15个点，被细分的区间各15个点
+        std::size_t evals = 15 * (2 * quadrature.getIntervals() - 1);
+        std::cout << std::left << std::setw(28) << "Gauss-Kronrod " + std::to_string(thr) + " thread(s)" << std::right
+                  << std::setw(12) << evals << std::setw(12) << std::fixed << std::setprecision(1) << t * 1e6
+                  << std::setw(12) << std::scientific << std::setprecision(1) << std::abs(value - exact) << std::endl;
+    }
+}
+
+#ifdef USE_GMP
+// 与Polynomial<T>::horner的通用模板相同的写法，用来和mpf_class的专门路径比较
+mpf_class genericHorner(const std::vector<mpf_class>& c, const mpf_class& x) {
+    mpf_class result = mpf_class();
+    for (std::size_t i = c.size(); i-- > 0;) {
+        result = result * x + c[i];
+    }
+    return result;
+}
+
+// mpf_class求值：通用模板与原地mpf_mul/mpf_add的对比（每点微秒）
+void benchGmp(std::size_t points) {
+    const mp_bitcnt_t prec = 256;
+    mpf_set_default_prec(prec); // 通用模板的累加器使用默认精度，设为与系数相同
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << std::endl << "mpf_class evaluation at " << prec << " bits, " << points << " points (us/pt)" << std::endl;
+    std::cout << std::setw(8) << "degree" << std::setw(12) << "generic" << std::setw(12) << "in-place"
+              << std::setw(12) << "batch" << std::setw(16) << "parallel" << std::setw(10) << "batch" << std::setw(10) << "parallel" << std::endl;
+    std::cout << std::setw(70) << "speedup vs generic" << std::endl;
+
+    std::vector<mpf_class> xs(points, mpf_class(0, prec)), out(points, mpf_class(0, prec));
+    for (std::size_t i = 0; i < points; ++i) {
+        xs[i] = mpf_class(-1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(points), prec);
+    }
+
+    int degrees[] = {8, 64, 512};
+    for (int degree : degrees) {
+        std::vector<mpf_class> coeffs;
+        for (int k = 0; k <= degree; ++k) {
+            coeffs.push_back(mpf_class(1, prec) / (k + 1));
+        }
+        Polynomial<mpf_class> p(coeffs);
+
+        double generic = timeIt([&] {
+            for (std::size_t i = 0; i < points; ++i) {
+                out[i] = genericHorner(coeffs, xs[i]);
+            }
+        }, 5);
+        double single = timeIt([&] {
+            for (std::size_t i = 0; i < points; ++i) {
+                out[i] = p(xs[i]);
+            }
+        }, 5);
+        double batch = timeIt([&] { p.evaluate(xs.data(), out.data(), points); }, 5);
+        double parallel = timeIt([&] { evaluateParallel(p, xs.data(), out.data(), points, hardware); }, 5);
+
+        // 两条路径的结果应该完全相同
+        bool same = true;
+        for (std::size_t i = 0; i < points; i += points / 16 + 1) {
+            same = same && genericHorner(coeffs, xs[i]) == out[i];
+        }
+
+        double scale = 1e6 / static_cast<double>(points);
+        std::cout << std::setw(8) << degree << std::fixed << std::setprecision(3)
+                  << std::setw(12) << generic * scale << std::setw(12) << single * scale
+                  << std::setw(12) << batch * scale << std::setw(10) << parallel * scale
+                  << " (" << std::setw(2) << hardware << ")" << std::setprecision(2)
+                  << std::setw(9) << generic / batch << "x" << std::setw(9) << generic / parallel << "x"
+                  << (same ? "" : "  MISMATCH") << std::endl;
+    }
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    std::size_t n = 1000000;
+    if (argc > 1) {
+        n = std::strtoul(argv[1], nullptr, 10);
+    }
+    const int repeats = 5;
+
+    std::vector<double> xs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        xs[i] = -1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(n);
+    }
+
+    std::cout << "Evaluating at " << n << " points (best of " << repeats << " runs)" << std::endl;
+    std::cout << std::left << std::setw(24) << "Function" << std::right
+              << std::setw(13) << "scalar/pt" << std::setw(13) << "batch/pt"
+              << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+    LinearFunction<double> line(2.5, -1.25);
+    compare("LinearFunction", line, xs, repeats);
+
+    int degrees[] = {3, 8, 16, 64};
+    for (int degree : degrees) {
+        std::vector<double> coeffs(degree + 1);
+        for (int k = 0; k <= degree; ++k) {
+            coeffs[k] = 1.0 / (k + 1);
+        }
+        Polynomial<double> p(coeffs);
+        compare("Polynomial degree " + std::to_string(degree), p, xs, repeats);
+    }
+
+    benchPipeline(xs, repeats);
+    benchSchemes(xs, repeats);
+    benchPack(xs, repeats);
+    benchMultiplyType<double>("double", std::size_t(1) << 20);
+    benchMultiplyType<int>("int", std::size_t(1) << 20);
+    benchFixed(xs, repeats);
+    benchSparse(2000);
+    benchChebyshev(xs, repeats);
+    benchQuadrature(repeats);
+    benchVectorFunction(1000000, repeats);
+    benchDual(xs, repeats);
+    benchRootFinder(10000);
+    benchMultipoint(std::size_t(1) << 18);
+#ifdef USE_GMP
+    benchGmp(20000);
+#endif
+
+    return 0;
+}
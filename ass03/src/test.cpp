@@ -1,10 +1,24 @@
+#include <algorithm>
 #include <iostream>
 #include <complex>
 #include <vector>
 #include <iomanip>
+#include <sstream>
 #include "../include/Function.hpp"
 #include "../include/LinearFunction.hpp"
+#include "../include/VectorFunction.hpp"
 #include "../include/Polynomial.hpp"
+#include "../include/Expression.hpp"
+#include "../include/PolynomialPack.hpp"
+#include "../include/PolynomialArithmetic.hpp"
+#include "../include/RootFinder.hpp"
+#include "../include/MultipointEval.hpp"
+#include "../include/Dual.hpp"
+#include "../include/NewtonSolver.hpp"
+#include "../include/FixedPolynomial.hpp"
+#include "../include/SparsePolynomial.hpp"
+#include "../include/Chebyshev.hpp"
+#include "../include/Quadrature.hpp"
 
 // 如果需要支持GMP库
 #ifdef USE_GMP
@@ -124,48 +138,11 @@ void testPolynomialFunction(const std::vector<std::complex<double>>& coeffs, con
 
 // 向量类型的线性函数测试
 void testVectorLinearFunction() {
-    // 定义向量类型的线性函数
-    std::vector<double> a = {1.0, 2.0, 3.0};
     std::vector<double> b = {4.0, 5.0, 6.0};
     std::vector<double> x = {7.0, 8.0, 9.0};
     
-    // 实现向量的加法和乘法操作
-    auto vectorAdd = [](const std::vector<double>& v1, const std::vector<double>& v2) {
-        std::vector<double> result(v1.size());
-        for (size_t i = 0; i < v1.size(); ++i) {
-            result[i] = v1[i] + v2[i];
-        }
-        return result;
-    };
-    
-    auto scalarMult = [](const std::vector<double>& v, double scalar) {
-        std::vector<double> result(v.size());
-        for (size_t i = 0; i < v.size(); ++i) {
-            result[i] = v[i] * scalar;
-        }
-        return result;
-    };
-    
-    // 创建一个自定义的向量线性函数
-    class VectorLinearFunction : public Function<std::vector<double>> {
-    private:
-        double a_;
-        std::vector<double> b_;
-        
-    public:
-        VectorLinearFunction(double a, const std::vector<double>& b) : a_(a), b_(b) {}
-        
-        std::vector<double> operator()(std::vector<double> x) const override {
-            std::vector<double> result(x.size());
-            for (size_t i = 0; i < x.size(); ++i) {
-                result[i] = a_ * x[i] + b_[i];
-            }
-            return result;
-        }
-    };
-    
-    // 测试向量线性函数
-    VectorLinearFunction f(2.5, b);
+    // 向量的仿射映射 f(x) = 2.5x + b
+    LinearFunction<std::vector<double>> f(2.5, b);
     std::cout << "Vector Linear function f(x) = " << 2.5 << " * x + ";
     printVector(b);
     std::cout << std::endl;
@@ -174,7 +151,481 @@ void testVectorLinearFunction() {
     printVector(x);
     std::cout << ") = ";
     printVector(f(x));
-    std::cout << std::endl << std::endl;
+    std::cout << std::endl;
+    
+    // 结果写入调用方的缓冲区，反复调用不分配内存；也可以原地计算
+    std::vector<double> out(x.size());
+    const double* buffer = out.data();
+    for (int i = 0; i < 3; ++i) {
+        f.evaluate(x, out);
+    }
+    std::cout << "Into caller buffer: ";
+    printVector(out);
+    std::cout << (out.data() == buffer ? " (same buffer)" : " (reallocated)") << std::endl;
+    std::vector<double> y = x;
+    f.evaluate(y, y);
+    std::cout << "In place: ";
+    printVector(y);
+    std::cout << std::endl;
+    
+    // 定长向量
+    LinearFunction<std::array<double, 3>> g(2.5, {4.0, 5.0, 6.0});
+    std::array<double, 3> z = g({7.0, 8.0, 9.0});
+    std::cout << "std::array<double, 3>: (" << z[0] << ", " << z[1] << ", " << z[2] << ")" << std::endl;
+    
+    // 维数不一致时抛出异常
+    try {
+        std::vector<double> wrong(2);
+        f.evaluate(x, wrong);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Dimension mismatch: " << e.what() << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// 批量计算测试：evaluate的结果应与逐点调用operator()完全相同
+void testBatchEvaluate() {
+    LinearFunction<double> f(2.5, 3.7);
+    Polynomial<double> p({1.5, 2.5, 3.5, 4.5});
+    const Function<double>* functions[] = {&f, &p};
+    const char* names[] = {"f(x) = 2.5 * x + 3.7", "p(x) = 4.5x^3 + 3.5x^2 + 2.5x + 1.5"};
+
+    // 点数超过一个块，覆盖完整块和剩余部分
+    std::vector<double> xs(100);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = -2.0 + 0.04 * i;
+    }
+
+    for (int k = 0; k < 2; ++k) {
+        std::vector<double> out(xs.size());
+        functions[k]->evaluate(xs.data(), out.data(), xs.size());
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < xs.size(); ++i) {
+            if (out[i] != (*functions[k])(xs[i])) {
+                ++mismatches;
+            }
+        }
+        std::cout << names[k] << " at " << xs.size() << " points: first values ";
+        printVector(std::vector<double>(out.begin(), out.begin() + 3));
+        std::cout << ", " << mismatches << " mismatches against scalar calls" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// 求值方法测试：Estrin方法与秦九韶算法的结果只差舍入误差
+void testEvalSchemes() {
+    // p(x) = 1 + x + x^2 + ... + x^20
+    std::vector<double> coeffs(21, 1.0);
+    Polynomial<double> p(coeffs);
+    double x = 0.9;
+    double exact = (1.0 - std::pow(x, 21)) / (1.0 - x);
+    std::cout << std::setprecision(17);
+    std::cout << "p(x) = 1 + x + ... + x^20, auto scheme: " << (p.usesEstrin() ? "Estrin" : "Horner") << std::endl;
+    std::cout << "Horner: " << p.horner(x) << ", Estrin: " << p.estrin(x) << ", closed form: " << exact << std::endl;
+    std::cout << std::setprecision(6);
+
+    // 同一点上计算多个多项式
+    std::vector<Polynomial<int>> polys = {
+        Polynomial<int>({1, 2, 3}),       // 3x^2 + 2x + 1
+        Polynomial<int>({0, 1}),          // x
+        Polynomial<int>({5, 0, 0, 0, 1})  // x^4 + 5
+    };
+    PolynomialPack<int> pack(polys);
+    std::vector<int> values(pack.size());
+    pack.evaluate(2, values.data());
+    std::cout << "Pack of " << pack.size() << " polynomials at x = 2: ";
+    printVector(values);
+    std::cout << ", separately: [" << polys[0](2) << ", " << polys[1](2) << ", " << polys[2](2) << "]" << std::endl;
+    std::cout << std::endl;
+}
+
+// 打印多项式的系数（从常数项开始）
+template <typename T>
+void printCoefficients(const Polynomial<T>& p) {
+    printVector(p.getCoefficients());
+}
+
+// 多项式运算测试
+void testPolynomialArithmetic() {
+    Polynomial<int> p({1, 2, 3});  // 3x^2 + 2x + 1
+    Polynomial<int> q({-1, 1});    // x - 1
+
+    std::cout << "p = "; printCoefficients(p);
+    std::cout << ", q = "; printCoefficients(q); std::cout << std::endl;
+    std::cout << "p + q = "; printCoefficients(p + q); std::cout << std::endl;
+    std::cout << "p - q = "; printCoefficients(p - q); std::cout << std::endl;
+    std::cout << "p * q = "; printCoefficients(p * q); std::cout << std::endl;
+    auto qr = divmod(p, q);
+    std::cout << "p / q = "; printCoefficients(qr.first);
+    std::cout << ", p % q = "; printCoefficients(qr.second); std::cout << std::endl;
+    std::cout << "p(q(x)) = "; printCoefficients(compose(p, q)); std::cout << std::endl;
+
+    // 大规模乘法：各算法的结果应该相同（int用NTT，结果精确）
+    std::vector<int> ca(5000), cb(5000);
+    for (size_t i = 0; i < ca.size(); ++i) {
+        ca[i] = static_cast<int>(i % 17) - 8;
+        cb[i] = static_cast<int>(i % 13) - 6;
+    }
+    Polynomial<int> a(ca), b(cb);
+    bool same = multiply(a, b, MultiplyAlgorithm::Schoolbook).getCoefficients() ==
+                multiply(a, b, MultiplyAlgorithm::Karatsuba).getCoefficients() &&
+                multiply(a, b, MultiplyAlgorithm::Schoolbook).getCoefficients() ==
+                multiply(a, b, MultiplyAlgorithm::FFT).getCoefficients();
+    std::cout << "Degree " << a.getDegree() << " * degree " << b.getDegree()
+              << ": schoolbook, Karatsuba and NTT agree: " << (same ? "yes" : "no") << std::endl;
+
+    // NTT本身：系数接近2^31时结果超过2^63，与__int128直接计算的卷积比较
+    std::vector<long long> la(3000), lb(3000);
+    for (size_t i = 0; i < la.size(); ++i) {
+        la[i] = 2147483647LL - static_cast<long long>(i % 7);
+        lb[i] = -2147483647LL + static_cast<long long>(i % 5);
+    }
+    std::vector<__int128> wide = nttMultiply(la.data(), la.size(), lb.data(), lb.size());
+    bool exactWide = true;
+    for (size_t k = 0; k < wide.size(); k += 97) {
+        __int128 sum = 0;
+        for (size_t i = k >= lb.size() ? k - lb.size() + 1 : 0; i <= k && i < la.size(); ++i) {
+            sum += static_cast<__int128>(la[i]) * lb[k - i];
+        }
+        exactWide = exactWide && wide[k] == sum;
+    }
+    std::cout << "NTT with coefficients near 2^31 (results beyond 2^63) exact: " << (exactWide ? "yes" : "no") << std::endl;
+
+    // double用FFT，结果有舍入误差
+    std::vector<double> da(ca.begin(), ca.end()), db(cb.begin(), cb.end());
+    std::vector<double> exact = multiply(Polynomial<double>(da), Polynomial<double>(db),
+                                         MultiplyAlgorithm::Schoolbook).getCoefficients();
+    std::vector<double> fast = (Polynomial<double>(da) * Polynomial<double>(db)).getCoefficients();
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < exact.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(exact[i] - fast[i]));
+    }
+    std::cout << "double FFT product, max difference to schoolbook: " << maxDiff << std::endl;
+    std::cout << std::endl;
+}
+
+// 表达式模板测试：组合后的表达式与直接计算的结果应该相同
+void testExpression() {
+    LinearFunction<double> l(2.0, 1.0);
+    Polynomial<double> p({1.0, 0.0, 3.0});  // p(x) = 3x^2 + 1
+
+    // h(x) = p(l(x)) * 2 + x^2 - 1
+    auto h = makeExpr(p)(makeExpr(l)) * 2.0 +
+             makeLambdaExpr<double>([](double x) { return x * x; }) - 1.0;
+    auto direct = [&](double x) { return p(l(x)) * 2.0 + x * x - 1.0; };
+
+    double x = 1.5;
+    std::cout << "h(x) = p(l(x)) * 2 + x^2 - 1, l(x) = 2x + 1, p(x) = 3x^2 + 1" << std::endl;
+    std::cout << "h(" << x << ") = " << h(x) << ", direct: " << direct(x) << std::endl;
+
+    // 批量求值，以及通过Function<double>接口使用
+    std::vector<double> xs(100), out(xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = -1.0 + 0.02 * i;
+    }
+    std::unique_ptr<Function<double>> f = makeFunction(h);
+    f->evaluate(xs.data(), out.data(), xs.size());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (out[i] != direct(xs[i]) || (*f)(xs[i]) != direct(xs[i])) {
+            ++mismatches;
+        }
+    }
+    std::cout << "Batched through Function<double>: " << mismatches << " mismatches at "
+              << xs.size() << " points" << std::endl;
+
+    // 引用一个虚接口的函数
+    auto g = compose(makeFunctionRef<double>(l), makeFunctionRef<double>(p));
+    std::cout << "l(p(" << x << ")) = " << g(x) << std::endl;
+    std::cout << std::endl;
+}
+
+// 求根测试：已知根的多项式，以及随机系数多项式的残差
+void testRootFinder() {
+    RootFinder finder;
+
+    // (x - 1)(x - 2)(x - 3) = x^3 - 6x^2 + 11x - 6
+    Polynomial<double> p({-6.0, 11.0, -6.0, 1.0});
+    std::vector<std::complex<double>> roots = finder.findRoots(p);
+    std::sort(roots.begin(), roots.end(), [](const std::complex<double>& a, const std::complex<double>& b) {
+        return a.real() < b.real();
+    });
+    std::cout << "Roots of x^3 - 6x^2 + 11x - 6: ";
+    for (size_t i = 0; i < roots.size(); ++i) {
+        printComplex(roots[i]);
+        std::cout << (i + 1 < roots.size() ? ", " : "");
+    }
+    std::cout << " (" << finder.getIterations() << " iterations)" << std::endl;
+
+    // x^4 + x^2 = x^2 (x^2 + 1)，含零根
+    roots = finder.findRoots(Polynomial<double>({0.0, 0.0, 1.0, 0.0, 1.0}));
+    std::cout << "Roots of x^4 + x^2: ";
+    for (size_t i = 0; i < roots.size(); ++i) {
+        printComplex(roots[i]);
+        std::cout << (i + 1 < roots.size() ? ", " : "");
+    }
+    std::cout << std::endl;
+
+    // 200次复系数多项式：每个根处的相对残差 |p(z)| / sum |a_i||z|^i
+    std::vector<std::complex<double>> coeffs(201);
+    for (size_t i = 0; i < coeffs.size(); ++i) {
+        coeffs[i] = std::complex<double>(std::cos(1.0 + 3.0 * i), std::sin(2.0 * i * i));
+    }
+    Polynomial<std::complex<double>> q(coeffs);
+    roots = finder.findRoots(q);
+    double maxResidual = 0.0;
+    for (const std::complex<double>& z : roots) {
+        // |z| > 1 时在1/z处计算倒序多项式，避免溢出
+        bool reversed = std::abs(z) > 1.0;
+        std::complex<double> y = reversed ? 1.0 / z : z;
+        std::complex<double> value = 0.0;
+        double scale = 0.0;
+        for (size_t i = 0; i < coeffs.size(); ++i) {
+            const std::complex<double>& c = coeffs[reversed ? i : coeffs.size() - 1 - i];
+            value = value * y + c;
+            scale = scale * std::abs(y) + std::abs(c);
+        }
+        maxResidual = std::max(maxResidual, std::abs(value) / scale);
+    }
+    std::cout << "Degree " << q.getDegree() << ": " << roots.size() << " roots in "
+              << finder.getIterations() << " iterations, converged: " << (finder.hasConverged() ? "yes" : "no")
+              << ", max relative residual " << maxResidual << std::endl;
+    std::cout << std::endl;
+}
+
+// 多点求值与插值测试
+void testMultipoint() {
+    // 精确类型：整数点上的求值，与逐点计算比较
+    Polynomial<int> p({1, -2, 0, 3});  // 3x^3 - 2x + 1
+    std::vector<int> points = {-2, -1, 0, 1, 2, 3};
+    std::vector<int> values = SubproductTree<int>(points).evaluate(p);
+    std::cout << "p(x) = 3x^3 - 2x + 1 at "; printVector(points);
+    std::cout << ": "; printVector(values); std::cout << std::endl;
+
+    // 插值还原p
+    std::vector<double> dx(points.begin(), points.end()), dy(values.begin(), values.end());
+    std::cout << "Interpolated coefficients: "; printCoefficients(interpolate(dx, dy)); std::cout << std::endl;
+
+    // 远离原点的实数点：树中系数增长超过kMultipointMaxGrowth，SubproductTree::interpolate退回Newton插值
+    std::vector<double> wx = {100.0, 200.0, 300.0, 400.0}, wy;
+    for (double x : wx) {
+        wy.push_back(3.0 * x * x * x - 2.0 * x + 1.0);
+    }
+    SubproductTree<double> wide(wx);
+    std::cout << "Growth " << wide.getGrowth() << " at "; printVector(wx);
+    std::cout << ", interpolated coefficients: "; printCoefficients(wide.interpolate(wy)); std::cout << std::endl;
+
+    // 4096次复系数多项式在单位圆上的4096个点：子乘积树与秦九韶算法比较，再插值还原系数
+    const size_t n = 4096;
+    const double pi = std::acos(-1.0);
+    std::vector<std::complex<double>> coeffs(n), xs(n);
+    for (size_t i = 0; i < n; ++i) {
+        coeffs[i] = std::complex<double>(std::cos(1.0 + 3.0 * i), std::sin(2.0 * i * i));
+        xs[i] = std::polar(1.0, 2.0 * pi * (i + 0.3 * std::sin(7.0 * i)) / n);
+    }
+    Polynomial<std::complex<double>> q(coeffs);
+    std::vector<std::complex<double>> fast = multipointEvaluate(q, xs);
+    double evalErr = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        evalErr = std::max(evalErr, std::abs(fast[i] - q.horner(xs[i])));
+    }
+    Polynomial<std::complex<double>> r = interpolate(xs, fast);
+    double interpErr = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        interpErr = std::max(interpErr, std::abs(r.getCoefficients()[i] - coeffs[i]));
+    }
+    std::cout << "Degree " << q.getDegree() << " at " << n << " points: max difference to Horner " << evalErr
+              << ", interpolation coefficient error " << interpErr << std::endl;
+    std::cout << std::endl;
+}
+
+// 自动微分与Newton/Halley求解测试
+void testDual() {
+    typedef Dual<double> D;
+
+    // 同一个Polynomial模板，系数类型换成Dual<double>，一次求值得到函数值和导数
+    Polynomial<D> p({D(1.0), D(2.0), D(3.0)});  // p(x) = 3x^2 + 2x + 1
+    D y = p(D::variable(2.0));
+    std::cout << "p(x) = 3x^2 + 2x + 1: p(2) = " << y.getValue() << ", p'(2) = " << y.getTangent() << std::endl;
+
+    LinearFunction<D> l(D(2.5), D(-1.0));
+    std::cout << "f(x) = 2.5x - 1: f(3) = " << l(D::variable(3.0)) << std::endl;
+
+    // 两个方向：g(x, y) = x^2 y + sin(y) 的梯度
+    typedef Dual<double, 2> D2;
+    D2 gx = D2::variable(1.5, 0), gy = D2::variable(0.5, 1);
+    D2 g = gx * gx * gy + sin(gy);
+    std::cout << "g(x, y) = x^2 y + sin(y) at (1.5, 0.5): " << g << std::endl;
+
+    // 求 x^2 - 2 = 0：Polynomial<Dual>用Newton法，Polynomial<Dual<Dual>>用Halley法
+    NewtonSolver<double> solver;
+    std::vector<double> c = {-2.0, 0.0, 1.0};
+    double root = solver.solve(Polynomial<D>(std::vector<D>(c.begin(), c.end())), 1.0);
+    std::cout << std::setprecision(16) << "sqrt(2): Newton " << root << " (" << solver.getIterations() << " evaluations)";
+    root = solver.solveHalley(Polynomial<Dual<D>>(std::vector<Dual<D>>(c.begin(), c.end())), 1.0);
+    std::cout << ", Halley " << root << " (" << solver.getIterations() << " evaluations)" << std::endl;
+
+    // 泛型lambda：cos(x) = x
+    auto h = [](auto x) { return cos(x) - x; };
+    std::cout << "cos(x) = x: " << solver.solve(h, 1.0) << std::endl;
+
+    // 方程组 x^2 + y^2 = 4, xy = 1
+    auto system = [](const std::array<D2, 2>& v) {
+        return std::array<D2, 2>{v[0] * v[0] + v[1] * v[1] - 4.0, v[0] * v[1] - 1.0};
+    };
+    std::array<double, 2> xy = solver.solveSystem<2>(system, {2.0, 0.5});
+    std::cout << "x^2 + y^2 = 4, xy = 1: (" << xy[0] << ", " << xy[1] << "), "
+              << solver.getIterations() << " iterations" << std::setprecision(6) << std::endl;
+    std::cout << std::endl;
+}
+
+// 编译期次数的多项式测试
+void testFixedPolynomial() {
+    // 常量表达式中求值
+    constexpr FixedPolynomial<int, 2> p(1, 2, 3);  // 3x^2 + 2x + 1
+    static_assert(p(2) == 17, "FixedPolynomial must be usable in constant expressions");
+    static_assert(p.derivative()(2) == 14, "derivative must be usable in constant expressions");
+    std::cout << "constexpr p(x) = 3x^2 + 2x + 1: p(2) = " << p(2) << ", p'(2) = " << p.derivative()(2) << std::endl;
+
+    // 通过Function<double>接口与Polynomial<double>互换
+    constexpr FixedPolynomial q(1.5, 2.5, 3.5, 4.5);  // 推导为FixedPolynomial<double, 3>
+    std::unique_ptr<Function<double>> functions[2] = {
+        makeFunction(q),
+        std::unique_ptr<Function<double>>(new Polynomial<double>(q.toPolynomial()))
+    };
+    const char* names[] = {"FixedPolynomial", "Polynomial"};
+    std::vector<double> xs(100);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = -2.0 + 0.04 * i;
+    }
+    std::vector<double> outs[2];
+    for (int k = 0; k < 2; ++k) {
+        outs[k].resize(xs.size());
+        functions[k]->evaluate(xs.data(), outs[k].data(), xs.size());
+        std::cout << names[k] << ": f(2) = " << (*functions[k])(2.0) << ", batch at " << xs.size()
+                  << " points: first values ";
+        printVector(std::vector<double>(outs[k].begin(), outs[k].begin() + 3));
+        std::cout << std::endl;
+    }
+
+    // 两种实现应当可以互换：逐点和批量结果都相同
+    size_t mismatches = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (outs[0][i] != outs[1][i] || (*functions[0])(xs[i]) != (*functions[1])(xs[i])) {
+            ++mismatches;
+        }
+    }
+    std::cout << mismatches << " mismatches between FixedPolynomial and Polynomial" << std::endl;
+    std::cout << std::endl;
+}
+
+// 稀疏多项式测试
+void testSparsePolynomial() {
+    typedef SparsePolynomial<double>::Term Term;
+    // x^1000000 + 3x^7 + 1：只存3项
+    SparsePolynomial<double> p({Term(1000000, 1.0), Term(7, 3.0), Term(0, 1.0)});
+    std::cout << "p(x) = x^1000000 + 3x^7 + 1: " << p.size() << " terms, degree " << p.getDegree()
+              << ", fill ratio " << p.fillRatio() << std::endl;
+    double x = 0.999999;
+    Polynomial<double> dense = p.toPolynomial();
+    std::cout << "p(" << x << ") sparse = " << std::setprecision(15) << p(x) << ", dense = " << dense(x)
+              << std::setprecision(6) << std::endl;
+    std::cout << "p(-1) = " << p(-1.0) << " (expected -1)" << std::endl;
+
+    // 间隔交替为3和5：x^3与x^5各只算一次
+    SparsePolynomial<double> alternating({Term(0, 1.0), Term(3, -2.0), Term(8, 0.5), Term(11, 3.0), Term(16, -1.0),
+                                          Term(21, 0.25)});
+    std::cout << "gaps 3,5,3,5,5 at 1.1: sparse = " << std::setprecision(15) << alternating(1.1)
+              << ", dense = " << alternating.toPolynomial()(1.1) << std::setprecision(6) << std::endl;
+
+    // 加减乘：(x^1000000 + 1)(x^1000000 - 1) = x^2000000 - 1
+    SparsePolynomial<double> a({Term(1000000, 1.0), Term(0, 1.0)});
+    SparsePolynomial<double> b({Term(1000000, 1.0), Term(0, -1.0)});
+    SparsePolynomial<double> product = a * b;
+    std::cout << "(x^1000000 + 1)(x^1000000 - 1) has " << product.size() << " terms, degree "
+              << product.getDegree() << std::endl;
+    std::cout << "(a + b) - a - b has " << ((a + b) - a - b).size() << " terms" << std::endl;
+
+    // 与稠密表示互相转换，并按填充率自动选择
+    Polynomial<double> q({1.0, 2.0, 0.0, 4.0});
+    SparsePolynomial<double> fromDense(q);
+    std::cout << "dense 4x^3 + 2x + 1 -> " << fromDense.size() << " sparse terms, q(2) = " << fromDense(2.0)
+              << ", round trip q(2) = " << fromDense.toPolynomial()(2.0) << std::endl;
+    std::unique_ptr<Function<double>> chosen[2] = {makePolynomialFunction(p), makePolynomialFunction(q)};
+    for (const auto& f : chosen) {
+        bool sparse = dynamic_cast<const SparsePolynomial<double>*>(f.get()) != nullptr;
+        std::cout << (sparse ? "sparse" : "dense") << " representation chosen, f(0.5) = " << (*f)(0.5) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Chebyshev近似测试
+void testChebyshev() {
+    // 光滑的复合函数：一段就够
+    auto smooth = makeExpr(Polynomial<double>({0.0, 1.0, 0.0, -0.5})) +
+                  makeLambdaExpr<double>([](double x) { return std::exp(std::sin(3.0 * x)); });
+    std::unique_ptr<Function<double>> f = makeFunction(smooth);
+    // 在0附近陡峭变化的函数：需要分段
+    std::unique_ptr<Function<double>> steep = makeFunction(makeLambdaExpr<double>([](double x) { return std::tanh(50.0 * x); }));
+
+    const Function<double>* functions[2] = {f.get(), steep.get()};
+    const char* names[2] = {"x - x^3/2 + exp(sin 3x)", "tanh(50x)"};
+    for (int i = 0; i < 2; ++i) {
+        ChebyshevApproximation<double> approx(*functions[i], -1.0, 1.0);
+        double maxErr = 0.0;
+        for (int k = 0; k <= 1000; ++k) {
+            double x = -1.0 + 0.002 * k;
+            maxErr = std::max(maxErr, std::abs(approx(x) - (*functions[i])(x)));
+        }
+        std::cout << names[i] << " on [-1, 1]: " << approx.getPieces().size() << " pieces, max degree "
+                  << approx.getDegree() << ", converged " << approx.hasConverged() << ", max error " << maxErr << std::endl;
+    }
+
+    // 保存后读回，结果应该完全相同
+    ChebyshevApproximation<double> approx(*steep, -1.0, 1.0);
+    std::stringstream stream;
+    approx.save(stream);
+    ChebyshevApproximation<double> loaded = ChebyshevApproximation<double>::load(stream);
+    std::size_t mismatches = 0;
+    for (int k = 0; k <= 1000; ++k) {
+        double x = -1.0 + 0.002 * k;
+        mismatches += approx(x) != loaded(x);
+    }
+    std::cout << "Saved and loaded surrogate: " << mismatches << " mismatches at 1001 points" << std::endl;
+    std::cout << std::endl;
+}
+
+// 自适应积分测试
+void testQuadrature() {
+    AdaptiveQuadrature<double> quadrature;
+    std::cout << std::setprecision(15);
+
+    // 光滑函数：exp(-x^2)在[-5, 5]上的积分为 sqrt(π) erf(5)
+    std::unique_ptr<Function<double>> gauss = makeFunction(makeLambdaExpr<double>([](double x) { return std::exp(-x * x); }));
+    double value = quadrature.integrate(*gauss, -5.0, 5.0);
+    std::cout << "exp(-x^2) on [-5, 5]: " << value << ", exact " << std::sqrt(std::acos(-1.0)) * std::erf(5.0)
+              << ", error estimate " << quadrature.getError() << ", " << quadrature.getIntervals() << " intervals" << std::endl;
+
+    // 端点奇异：1/sqrt(x)在[0, 1]上的积分为2，需要在0附近反复细分
+    std::unique_ptr<Function<double>> singular = makeFunction(makeLambdaExpr<double>([](double x) { return 1.0 / std::sqrt(x); }));
+    value = quadrature.integrate(*singular, 0.0, 1.0);
+    std::cout << "1/sqrt(x) on [0, 1]: " << value << ", exact 2, converged " << quadrature.hasConverged()
+              << ", " << quadrature.getIntervals() << " intervals" << std::endl;
+
+    // 单线程与线程池的结果应该完全相同
+    AdaptiveQuadrature<double>::Options serial;
+    serial.threads = 1;
+    AdaptiveQuadrature<double> serialQuadrature(serial);
+    std::cout << "1/sqrt(x) serial == pooled: " << (serialQuadrature.integrate(*singular, 0.0, 1.0) == value) << std::endl;
+
+    // 多项式走精确积分：3x^2 + 2x + 1在[0, 2]上的积分为14
+    Polynomial<double> p({1.0, 2.0, 3.0});
+    const Function<double>& f = p;
+    std::cout << "3x^2 + 2x + 1 on [0, 2]: " << quadrature.integrate(f, 0.0, 2.0) << ", "
+              << quadrature.getIntervals() << " intervals" << std::setprecision(6) << std::endl;
+    std::cout << std::endl;
 }
 
 int main() {
@@ -221,6 +672,50 @@ int main() {
         std::complex<double>(1.0, 1.0)
     );
     
+    // 测试批量计算
+    std::cout << "===== Testing batched evaluate =====" << std::endl;
+    testBatchEvaluate();
+    
+    // 测试求值方法
+    std::cout << "===== Testing evaluation schemes =====" << std::endl;
+    testEvalSchemes();
+    
+    // 测试多项式运算
+    std::cout << "===== Testing polynomial arithmetic =====" << std::endl;
+    testPolynomialArithmetic();
+    
+    // 测试表达式模板
+    std::cout << "===== Testing expression templates =====" << std::endl;
+    testExpression();
+    
+    // 测试求根
+    std::cout << "===== Testing root finder =====" << std::endl;
+    testRootFinder();
+    
+    // 测试多点求值与插值
+    std::cout << "===== Testing multipoint evaluation =====" << std::endl;
+    testMultipoint();
+    
+    // 测试自动微分
+    std::cout << "===== Testing automatic differentiation =====" << std::endl;
+    testDual();
+    
+    // 测试编译期次数的多项式
+    std::cout << "===== Testing FixedPolynomial =====" << std::endl;
+    testFixedPolynomial();
+    
+    // 测试稀疏多项式
+    std::cout << "===== Testing SparsePolynomial =====" << std::endl;
+    testSparsePolynomial();
+    
+    // 测试Chebyshev近似
+    std::cout << "===== Testing Chebyshev approximation =====" << std::endl;
+    testChebyshev();
+    
+    // 测试自适应积分
+    std::cout << "===== Testing adaptive quadrature =====" << std::endl;
+    testQuadrature();
+    
 #ifdef USE_GMP
     // 测试GMP库
     std::cout << "===== Testing with GMP =====" << std::endl;
@@ -246,6 +741,33 @@ int main() {
     std::cout << "Polynomial function p(x) = 3.5x^2 + 2.5x + 1.5" << std::endl;
     std::cout << "p(" << x << ") = " << p(x) << std::endl;
     std::cout << "Degree: " << p.getDegree() << std::endl;
+    
+    // 专门的求值路径按操作数的精度（256位）计算，批量和多线程版本结果相同
+    mpf_class third = mpf_class(1, 256) / 3;
+    std::vector<mpf_class> thirds(1000, third), values(thirds.size(), mpf_class(0, 256));
+    Polynomial<mpf_class> q({mpf_class(0, 256), mpf_class(1, 256)});  // q(x) = x
+    std::cout << "q(x) = x, precision of q(1/3): " << q(third).get_prec() << " bits, equal to 1/3: "
+              << (q(third) == third ? "yes" : "no") << std::endl;
+    p.evaluate(thirds.data(), values.data(), thirds.size());
+    std::vector<mpf_class> parallelValues(thirds.size(), mpf_class(0, 256));
+    evaluateParallel(p, thirds.data(), parallelValues.data(), thirds.size(), 4);
+    std::cout << "Batched and parallel evaluation agree: " << (values == parallelValues && values[0] == p(third) ? "yes" : "no")
+              << std::endl;
+    // 默认精度的out会被提高到计算精度，结果不被截断
+    std::vector<mpf_class> defaultValues(thirds.size());
+    p.evaluate(thirds.data(), defaultValues.data(), thirds.size());
+    std::cout << "Default-precision outputs raised to " << defaultValues[0].get_prec() << " bits, equal to p(1/3): "
+              << (defaultValues == values ? "yes" : "no") << std::endl;
+    
+    // GMP系数的多项式运算使用Karatsuba
+    Polynomial<mpz_class> z({mpz_class(1), mpz_class(1)});  // x + 1
+    Polynomial<mpz_class> z8 = square(square(square(z)));
+    std::cout << "(x + 1)^8 = ";
+    printCoefficients(z8);
+    std::cout << std::endl;
+    std::cout << "(x + 1)^8 / (x + 1)^2 = ";
+    printCoefficients(z8 / square(z));
+    std::cout << std::endl;
 #endif
     
     return 0;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+#include "Polynomial.hpp"
+
+// Newton 分形：对复平面上每个点做 Newton 迭代 z <- z - p(z)/p'(z)，
+// 按收敛到哪个根（吸引域）和所用的迭代次数着色
+class NewtonFractal {
+public:
+    // 构造时求出 p 的全部根和 p' 的系数，之后每个像素只做迭代和距离判断
+    explicit NewtonFractal(const Polynomial<std::complex<double>>& p);
+
+    // 计算给定点收敛到的根的编号和迭代次数，不收敛时返回 -1
+    int computeRoot(const std::complex<double>& z0, int maxIterations, int& iterations) const;
+
+    // 计算给定区域的 Newton 分形，图像按块分给多个线程（threads 为 0 时使用硬件线程数）。
+    // 结果编码为 根的编号 * maxIterations + 迭代次数，不收敛的点为 getColorLevels(maxIterations)，
+    // 可以直接交给 Image 的着色函数（以 getColorLevels(maxIterations) 作为最大迭代次数）
+    std::vector<std::vector<int>> computeSet(
+        double xMin, double yMin, double xMax, double yMax,
+        int width, int height, int maxIterations, unsigned threads = 0) const;
+
+    // 着色用的级数：每个根占 maxIterations 级
+    int getColorLevels(int maxIterations) const;
+
+    // 多项式的全部根
+    const std::vector<std::complex<double>>& getRoots() const;
+
+private:
+    // 系数按实部、虚部分开存放，从常数项开始
+    std::vector<double> re_, im_;   // p 的系数
+    std::vector<double> dre_, dim_; // p' 的系数
+    std::vector<std::complex<double>> roots_;
+    double tolerance2_;             // 收敛判定：|z - root|^2 < tolerance2_
+};
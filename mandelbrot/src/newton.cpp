@@ -0,0 +1,160 @@
+#include "include/newton.h"
+#include "RootFinder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+// 每个线程一次取一个 kTileSize x kTileSize 的块，块之间计算量差别很大（吸引域边界附近迭代次数多），
+// 动态取块比按行平均分配更均衡
+static const int kTileSize = 32;
+
+NewtonFractal::NewtonFractal(const Polynomial<std::complex<double>>& p) {
+    std::vector<std::complex<double>> c = p.getCoefficients();
+    while (!c.empty() && c.back() == std::complex<double>()) {
+        c.pop_back();
+    }
+    if (c.size() < 2) {
+        throw std::invalid_argument("NewtonFractal: polynomial must have degree >= 1");
+    }
+
+    // p 和 p' 的系数只算一次
+    for (size_t i = 0; i < c.size(); i++) {
+        re_.push_back(c[i].real());
+        im_.push_back(c[i].imag());
+        if (i > 0) {
+            dre_.push_back(i * c[i].real());
+            dim_.push_back(i * c[i].imag());
+        }
+    }
+
+    // 预先求出全部根，重根（Aberth 迭代给出的一簇近似值）合并为一个
+    RootFinder finder;
+    std::vector<std::complex<double>> found = finder.findRoots(Polynomial<std::complex<double>>(c));
+    double scale = 1.0;
+    for (const std::complex<double>& r : found) {
+        scale = std::max(scale, std::abs(r));
+    }
+    for (const std::complex<double>& r : found) {
+        bool duplicate = false;
+        for (const std::complex<double>& q : roots_) {
+            duplicate = duplicate || std::abs(r - q) < 1e-5 * scale;
+        }
+        if (!duplicate) {
+            roots_.push_back(r);
+        }
+    }
+
+    // 收敛半径取根之间最小距离的 1/4，这样落在半径内的点一定属于该根的吸引域附近
+    double tolerance = 1e-3 * scale;
+    for (size_t i = 0; i < roots_.size(); i++) {
+        for (size_t j = i + 1; j < roots_.size(); j++) {
+            tolerance = std::min(tolerance, 0.25 * std::abs(roots_[i] - roots_[j]));
+        }
+    }
+    tolerance2_ = tolerance * tolerance;
+}
+
+int NewtonFractal::computeRoot(const std::complex<double>& z0, int maxIterations, int& iterations) const {
+    const int n = re_.size() - 1;
+    const double* re = re_.data();
+    const double* im = im_.data();
+    const double* dre = dre_.data();
+    const double* dim = dim_.data();
+    double zr = z0.real();
+    double zi = z0.imag();
+
+    for (iterations = 0; iterations < maxIterations; iterations++) {
+        // 到各个根的距离判断
+        for (size_t k = 0; k < roots_.size(); k++) {
+            double dr = zr - roots_[k].real();
+            double di = zi - roots_[k].imag();
+            if (dr * dr + di * di < tolerance2_) {
+                return k;
+            }
+        }
+
+        // 同一个循环中用秦九韶算法同时计算 p(z) 和 p'(z)
+        double vr = re[n], vi = im[n];
+        double dr = dre[n - 1], di = dim[n - 1];
+        for (int i = n - 1; i >= 1; i--) {
+            double tr = vr * zr - vi * zi + re[i];
+            vi = vr * zi + vi * zr + im[i];
+            vr = tr;
+            double ur = dr * zr - di * zi + dre[i - 1];
+            di = dr * zi + di * zr + dim[i - 1];
+            dr = ur;
+        }
+        double tr = vr * zr - vi * zi + re[0];
+        vi = vr * zi + vi * zr + im[0];
+        vr = tr;
+
+        // z <- z - p / p'
+        double denom = dr * dr + di * di;
+        if (denom == 0.0) {
+            break; // 导数为 0，迭代无法继续
+        }
+        zr -= (vr * dr + vi * di) / denom;
+        zi -= (vi * dr - vr * di) / denom;
+        if (!std::isfinite(zr) || !std::isfinite(zi)) {
+            break;
+        }
+    }
+    return -1;
+}
+
+std::vector<std::vector<int>> NewtonFractal::computeSet(
+    double xMin, double yMin, double xMax, double yMax,
+    int width, int height, int maxIterations, unsigned threads) const {
+
+    std::vector<std::vector<int>> result(height, std::vector<int>(width));
+
+    double xStep = (xMax - xMin) / width;
+    double yStep = (yMax - yMin) / height;
+    int tilesX = (width + kTileSize - 1) / kTileSize;
+    int tilesY = (height + kTileSize - 1) / kTileSize;
+    int tiles = tilesX * tilesY;
+    int background = getColorLevels(maxIterations);
+
+    std::atomic<int> nextTile(0);
+    auto worker = [&]() {
+        for (int tile = nextTile++; tile < tiles; tile = nextTile++) {
+            int x0 = (tile % tilesX) * kTileSize;
+            int y0 = (tile / tilesX) * kTileSize;
+            int x1 = std::min(width, x0 + kTileSize);
+            int y1 = std::min(height, y0 + kTileSize);
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    std::complex<double> z(xMin + x * xStep, yMin + y * yStep);
+                    int iterations = 0;
+                    int root = computeRoot(z, maxIterations, iterations);
+                    result[y][x] = root < 0 ? background : root * maxIterations + iterations;
+                }
+            }
+        }
+    };
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned>(threads, tiles);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back(worker);
+    }
+    worker(); // 当前线程也参与计算
+    for (std::thread& w : workers) {
+        w.join();
+    }
+
+    return result;
+}
+
+int NewtonFractal::getColorLevels(int maxIterations) const {
+    return roots_.size() * maxIterations;
+}
+
+const std::vector<std::complex<double>>& NewtonFractal::getRoots() const {
+    return roots_;
+}
@@ -1,7 +1,10 @@
 #include "include/mandelbrot.h"
+#include "include/newton.h"
 #include "include/image.h"
 #include <iostream>
 #include <chrono>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 void printHelp() {
@@ -13,10 +16,57 @@ void printHelp() {
               << "                Add 's' for smooth HSV coloring (e.g. --png s)\n"
               << "  --zoom        Generate zoom animation\n"
               << "  --cuda        Use CUDA acceleration (if available)\n"
+              << "  --newton [c]  Render the Newton fractal of a polynomial instead\n"
+              << "                c: comma-separated coefficients from the constant term,\n"
+              << "                default -1,0,0,1 (z^3 - 1); works with --basic and --png\n"
               << "  --help        Display this help message\n"
               << std::endl;
 }
 
+// 计算并保存多项式的 Newton 分形，着色沿用 Image 的函数
+int renderNewton(const std::vector<std::complex<double>>& coefficients,
+                 const std::string& mode, bool useSmoothing,
+                 double xMin, double yMin, double xMax, double yMax,
+                 int width, int height) {
+    const int maxIterations = 64;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    NewtonFractal fractal((Polynomial<std::complex<double>>(coefficients)));
+    std::cout << "Newton fractal of a degree " << coefficients.size() - 1 << " polynomial, "
+              << fractal.getRoots().size() << " distinct roots:";
+    for (const std::complex<double>& root : fractal.getRoots()) {
+        std::cout << " " << root;
+    }
+    std::cout << std::endl;
+    
+    auto result = fractal.computeSet(xMin, yMin, xMax, yMax, width, height, maxIterations);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "Computation completed in " << elapsed.count() << " seconds" << std::endl;
+    
+    // 每个根占 maxIterations 级颜色，不收敛的点为黑色
+    int levels = fractal.getColorLevels(maxIterations);
+    bool saved = false;
+    std::string filename;
+    if (mode == "png") {
+        filename = "newton.png";
+        saved = Image::saveImage(result, filename, levels, useSmoothing);
+    } else if (mode == "basic") {
+        filename = "newton.ppm";
+        saved = Image::saveAsPPM(result, filename, levels);
+    } else {
+        std::cerr << "Zoom animation is only available for the Mandelbrot set" << std::endl;
+        return 1;
+    }
+    
+    if (!saved) {
+        std::cerr << "Failed to save Newton fractal" << std::endl;
+        return 1;
+    }
+    std::cout << "Newton fractal saved as " << filename << std::endl;
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     // 默认参数
     double xMin = -1.5;
@@ -31,6 +81,8 @@ int main(int argc, char* argv[]) {
     std::string mode = "basic";
     bool useSmoothing = false;
     bool useCUDA = false;
+    bool useNewton = false;
+    std::vector<std::complex<double>> newtonCoefficients = {-1.0, 0.0, 0.0, 1.0};
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -44,12 +96,46 @@ int main(int argc, char* argv[]) {
         }
         else if (arg == "--zoom") mode = "zoom";
         else if (arg == "--cuda") useCUDA = true;
+        else if (arg == "--newton") {
+            useNewton = true;
+            // 检查是否给出了系数
+            if (i+1 < argc && std::string(argv[i+1]).compare(0, 2, "--") != 0) {
+                newtonCoefficients.clear();
+                std::stringstream ss(argv[++i]);
+                std::string item;
+                try {
+                    while (std::getline(ss, item, ',')) {
+                        size_t used = 0;
+                        newtonCoefficients.push_back(std::stod(item, &used));
+                        if (used != item.size()) {
+                            throw std::invalid_argument(item);
+                        }
+                    }
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid --newton coefficient \"" << item << "\" in " << argv[i] << std::endl;
+                    printHelp();
+                    return 1;
+                }
+            }
+        }
         else if (arg == "--help") {
             printHelp();
             return 0;
         }
     }
     
+    if (useNewton) {
+        // 例如常数多项式：NewtonFractal 的构造函数会抛出异常
+        try {
+            return renderNewton(newtonCoefficients, mode, useSmoothing,
+                                xMin, yMin, xMax, yMax, width, height);
+        } catch (const std::exception& e) {
+            std::cerr << "Cannot render Newton fractal: " << e.what() << std::endl;
+            printHelp();
+            return 1;
+        }
+    }
+    
     std::cout << "Computing Mandelbrot set for region: (" 
               << xMin << ", " << yMin << ") to (" 
               << xMax << ", " << yMax << ")" << std::endl;
@@ -0,0 +1,272 @@
+#include "cnn.h"
+#include "gemm.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 3x3卷积（padding=1，步长1）在(oh, ow)处加偏置之前的值，越界的输入按0处理。
+// in为in_channels个h x w的通道，weight为一个输出通道的 [in_channels, 3, 3] 权重。
+// 内部的点不需要判断边界，只有边上一圈的点才逐个检查
+static inline float conv3x3_at(const float *in, int in_channels, int h, int w,
+                               const float *weight, int oh, int ow)
+{
+    float sum = 0.0f;
+    if (oh > 0 && oh < h - 1 && ow > 0 && ow < w - 1) {
+        for (int ic = 0; ic < in_channels; ic++) {
+            const float *src = in + (ic * h + oh - 1) * w + ow - 1;
+            for (int kh = 0; kh < 3; kh++) {
+                for (int kw = 0; kw < 3; kw++) {
+                    sum += src[kh * w + kw] * weight[ic * 9 + kh * 3 + kw];
+                }
+            }
+        }
+        return sum;
+    }
+    for (int ic = 0; ic < in_channels; ic++) {
+        for (int kh = 0; kh < 3; kh++) {
+            for (int kw = 0; kw < 3; kw++) {
+                int h_idx = oh + kh - 1;
+                int w_idx = ow + kw - 1;
+                if (h_idx >= 0 && h_idx < h && w_idx >= 0 && w_idx < w) {
+                    sum += in[(ic * h + h_idx) * w + w_idx] * weight[ic * 9 + kh * 3 + kw];
+                }
+            }
+        }
+    }
+    return sum;
+}
+
+// 卷积 + 偏置 + ReLU，一次写出激活后的结果: [in_channels, h, w] -> [out_channels, h, w]
+static void conv3x3_bias_relu(const float *in, int in_channels, int h, int w,
+                              const float *weight, const float *bias, int out_channels, float *out)
+{
+    for (int oc = 0; oc < out_channels; oc++) {
+        const float *wt = weight + oc * in_channels * 9;
+        for (int oh = 0; oh < h; oh++) {
+            for (int ow = 0; ow < w; ow++) {
+                float sum = conv3x3_at(in, in_channels, h, w, wt, oh, ow) + bias[oc];
+                out[(oc * h + oh) * w + ow] = sum > 0 ? sum : 0;
+            }
+        }
+    }
+}
+
+// 卷积 + 偏置 + ReLU + 两次2x2最大池化: [in_channels, h, w] -> [out_channels, h/4, w/4]。
+// 两次步长为2的2x2池化等于一次4x4池化，4x4窗口互不重叠，每个卷积输出只计算一次；
+// ReLU与取最大值可以交换，所以从0开始取最大值即可，卷积结果不需要写回内存
+static void conv3x3_relu_maxpool4(const float *in, int in_channels, int h, int w,
+                                  const float *weight, const float *bias, int out_channels, float *out)
+{
+    const int ph = h / 4, pw = w / 4;
+    for (int oc = 0; oc < out_channels; oc++) {
+        const float *wt = weight + oc * in_channels * 9;
+        for (int y = 0; y < ph; y++) {
+            for (int x = 0; x < pw; x++) {
+                float max_val = 0.0f;
+                for (int dy = 0; dy < 4; dy++) {
+                    for (int dx = 0; dx < 4; dx++) {
+                        float sum = conv3x3_at(in, in_channels, h, w, wt, 4*y + dy, 4*x + dx) + bias[oc];
+                        max_val = fmaxf(max_val, sum);
+                    }
+                }
+                out[(oc * ph + y) * pw + x] = max_val;
+            }
+        }
+    }
+}
+
+void cnn_dense(const float *in, int n_in, const float *weight, const float *bias, int n_out, int relu, float *out)
+{
+    for (int i = 0; i < n_out; i++) {
+        float sum = 0.0f;
+        for (int j = 0; j < n_in; j++) {
+            sum += in[j] * weight[i * n_in + j];
+        }
+        sum += bias[i];
+        out[i] = relu && !(sum > 0) ? 0 : sum;
+    }
+}
+
+// 单张图像的前向推理，保留各层结果
+void cnn_forward_activations(const struct cnn_params *params, const float *input, struct cnn_activations *act)
+{
+    // 输入标准化: 转换为与PyTorch相同的标准化格式
+    for (int i = 0; i < IMG_H * IMG_W; i++) {
+        // 应用与PyTorch相同的标准化: (x - mean) / std
+        act->input[i] = (input[i] - 0.1307f) / 0.3081f;
+    }
+
+    // 1. 第一个卷积层 + ReLU: input -> relu1
+    conv3x3_bias_relu(act->input, CONV1_IN_CHANNELS, IMG_H, IMG_W,
+                      params->conv1_weight, params->conv1_bias, CONV1_OUT_CHANNELS, act->relu1);
+
+    // 2. 第二个卷积层 + ReLU + 两次池化: relu1 -> pool2
+    conv3x3_relu_maxpool4(act->relu1, CONV2_IN_CHANNELS, CONV1_OUT_H, CONV1_OUT_W,
+                          params->conv2_weight, params->conv2_bias, CONV2_OUT_CHANNELS, act->pool2);
+
+    // 3. 第一个全连接层 + ReLU: pool2 (展平) -> fc1
+    cnn_dense(act->pool2, FC1_IN, params->fc1_weight, params->fc1_bias, FC1_OUT, 1, act->fc1);
+
+    // 4. 第二个全连接层: fc1 -> output
+    cnn_dense(act->fc1, FC2_IN, params->fc2_weight, params->fc2_bias, FC2_OUT, 0, act->output);
+}
+
+// 简化的CNN前向传播函数实现
+void cnn_forward(
+    const float *input,        // 输入图像 [1, 28, 28]
+    const float *conv1_weight, // [2, 1, 3, 3]
+    const float *conv1_bias,   // [2]
+    const float *conv2_weight, // [4, 2, 3, 3]
+    const float *conv2_bias,   // [4]
+    const float *fc1_weight,   // [24, 196]
+    const float *fc1_bias,     // [24]
+    const float *fc2_weight,   // [10, 24]
+    const float *fc2_bias,     // [10]
+    float *output              // [10]
+)
+{
+    struct cnn_params params = {conv1_weight, conv1_bias, conv2_weight, conv2_bias,
+                                fc1_weight, fc1_bias, fc2_weight, fc2_bias};
+    // 各层结果共约9.5KB，可以放在L1中
+    struct cnn_activations act;
+    cnn_forward_activations(&params, input, &act);
+    memcpy(output, act.output, sizeof(act.output));
+}
+
+// 找出最大值的索引，即识别结果
+int argmax(const float *output)
+{
+    int predicted = 0;
+    for (int i = 1; i < FC2_OUT; i++) {
+        if (output[predicted] < output[i]) {
+            predicted = i;
+        }
+    }
+    return predicted;
+}
+
+// 批量推理的中间结果。卷积层逐张图像计算（权重 x im2col列矩阵），一张图的列矩阵和特征图
+// 约80KB，可以留在L2中；全连接层的输入输出按 特征数 x n 存放，每一列是一张图，
+// 整批一次矩阵乘法，权重只读一遍
+struct cnn_batch_workspace {
+    int max_batch;
+    float *input;    // 标准化后的输入 [784]
+    float *col;      // im2col的结果，两个卷积层共用 [18, 784]
+    float *conv1;    // [2, 784]
+    float *conv2;    // [4, 784]
+    float *features; // 第二次池化的结果（展平） [196, n]
+    float *fc1;      // [24, n]
+    float *fc2;      // [10, n]
+};
+
+struct cnn_batch_workspace *cnn_batch_workspace_create(int max_batch)
+{
+    const size_t plane = IMG_H * IMG_W;
+    struct cnn_batch_workspace *ws = calloc(1, sizeof(*ws));
+    if (!ws || max_batch <= 0) {
+        free(ws);
+        return NULL;
+    }
+    ws->max_batch = max_batch;
+    ws->input = malloc(plane * sizeof(float));
+    ws->col = malloc(CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE * plane * sizeof(float));
+    ws->conv1 = malloc(CONV1_OUT_CHANNELS * plane * sizeof(float));
+    ws->conv2 = malloc(CONV2_OUT_CHANNELS * plane * sizeof(float));
+    ws->features = malloc(FC1_IN * (size_t)max_batch * sizeof(float));
+    ws->fc1 = malloc(FC1_OUT * (size_t)max_batch * sizeof(float));
+    ws->fc2 = malloc(FC2_OUT * (size_t)max_batch * sizeof(float));
+    if (!ws->input || !ws->col || !ws->conv1 || !ws->conv2 ||
+        !ws->features || !ws->fc1 || !ws->fc2) {
+        cnn_batch_workspace_free(ws);
+        return NULL;
+    }
+    return ws;
+}
+
+void cnn_batch_workspace_free(struct cnn_batch_workspace *ws)
+{
+    if (!ws) {
+        return;
+    }
+    free(ws->input);
+    free(ws->col);
+    free(ws->conv1);
+    free(ws->conv2);
+    free(ws->features);
+    free(ws->fc1);
+    free(ws->fc2);
+    free(ws);
+}
+
+// 每一行用对应的偏置初始化，之后sgemm在上面累加
+static void fill_bias(float *out, const float *bias, int rows, int cols)
+{
+    for (int r = 0; r < rows; r++) {
+        for (int j = 0; j < cols; j++) {
+            out[r * cols + j] = bias[r];
+        }
+    }
+}
+
+static void relu(float *x, int size)
+{
+    for (int i = 0; i < size; i++) {
+        x[i] = x[i] > 0 ? x[i] : 0;
+    }
+}
+
+void cnn_forward_batch(const struct cnn_params *params, const float *input, int n,
+                       float *output, struct cnn_batch_workspace *ws)
+{
+    const int plane = IMG_H * IMG_W;
+    const int k1 = CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE;
+    const int k2 = CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE;
+
+    for (int b = 0; b < n; b++) {
+        // 输入标准化，与cnn_forward相同
+        for (int i = 0; i < plane; i++) {
+            ws->input[i] = (input[b * plane + i] - 0.1307f) / 0.3081f;
+        }
+
+        // 1. 第一个卷积层 + ReLU: [2, 9] x [9, 784]
+        im2col(ws->input, CONV1_IN_CHANNELS, plane, IMG_H, IMG_W, CONV1_KERNEL_SIZE, CONV1_PADDING, ws->col);
+        fill_bias(ws->conv1, params->conv1_bias, CONV1_OUT_CHANNELS, plane);
+        sgemm(CONV1_OUT_CHANNELS, plane, k1, params->conv1_weight, k1, ws->col, plane, ws->conv1, plane);
+        relu(ws->conv1, CONV1_OUT_CHANNELS * plane);
+
+        // 2. 第二个卷积层: [4, 18] x [18, 784]
+        im2col(ws->conv1, CONV2_IN_CHANNELS, plane, CONV1_OUT_H, CONV1_OUT_W, CONV2_KERNEL_SIZE, CONV2_PADDING, ws->col);
+        fill_bias(ws->conv2, params->conv2_bias, CONV2_OUT_CHANNELS, plane);
+        sgemm(CONV2_OUT_CHANNELS, plane, k2, params->conv2_weight, k2, ws->col, plane, ws->conv2, plane);
+
+        // 3. ReLU + 两次池化（合并为一次4x4池化），结果作为全连接层输入的第b列:
+        //    features[(c * 49 + h * 7 + w) * n + b]
+        for (int c = 0; c < CONV2_OUT_CHANNELS; c++) {
+            const float *src = ws->conv2 + c * CONV2_OUT_H * CONV2_OUT_W;
+            for (int h = 0; h < POOL2_OUT_H; h++) {
+                for (int w = 0; w < POOL2_OUT_W; w++) {
+                    float max_val = 0.0f;
+                    for (int dy = 0; dy < 4; dy++) {
+                        const float *p = src + (4*h + dy) * CONV2_OUT_W + 4*w;
+                        max_val = fmaxf(max_val, fmaxf(fmaxf(p[0], p[1]), fmaxf(p[2], p[3])));
+                    }
+                    ws->features[((c * POOL2_OUT_H + h) * POOL2_OUT_W + w) * n + b] = max_val;
+                }
+            }
+        }
+    }
+
+    // 4. 第一个全连接层 + ReLU: [24, 196] x [196, n]
+    fill_bias(ws->fc1, params->fc1_bias, FC1_OUT, n);
+    sgemm(FC1_OUT, n, FC1_IN, params->fc1_weight, FC1_IN, ws->features, n, ws->fc1, n);
+    relu(ws->fc1, FC1_OUT * n);
+
+    // 5. 第二个全连接层: [10, 24] x [24, n]，结果转置为 n x 10
+    fill_bias(ws->fc2, params->fc2_bias, FC2_OUT, n);
+    sgemm(FC2_OUT, n, FC2_IN, params->fc2_weight, FC2_IN, ws->fc1, n, ws->fc2, n);
+    for (int b = 0; b < n; b++) {
+        for (int i = 0; i < FC2_OUT; i++) {
+            output[b * FC2_OUT + i] = ws->fc2[i * n + b];
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef CNN_H
+#define CNN_H
+
+// 参数维度常量
+#define IMG_W 28
+#define IMG_H 28
+#define IMG_C 1
+
+// 卷积层1参数
+#define CONV1_IN_CHANNELS 1
+#define CONV1_OUT_CHANNELS 2
+#define CONV1_KERNEL_SIZE 3
+#define CONV1_PADDING 1
+#define CONV1_OUT_W 28
+#define CONV1_OUT_H 28
+
+// 卷积层2参数
+#define CONV2_IN_CHANNELS 2
+#define CONV2_OUT_CHANNELS 4
+#define CONV2_KERNEL_SIZE 3
+#define CONV2_PADDING 1
+#define CONV2_OUT_W 28
+#define CONV2_OUT_H 28
+
+// 池化后的尺寸
+#define POOL1_OUT_W 14
+#define POOL1_OUT_H 14
+#define POOL2_OUT_W 7
+#define POOL2_OUT_H 7
+
+// 全连接层参数
+#define FC1_IN (4 * 7 * 7)
+#define FC1_OUT 24
+#define FC2_IN 24
+#define FC2_OUT 10
+
+// 各层参数数量，顺序与parameters_cnn.bin中一致
+#define CONV1_WEIGHT_SIZE (CONV1_OUT_CHANNELS * CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE)
+#define CONV2_WEIGHT_SIZE (CONV2_OUT_CHANNELS * CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE)
+#define FC1_WEIGHT_SIZE (FC1_OUT * FC1_IN)
+#define FC2_WEIGHT_SIZE (FC2_OUT * FC2_IN)
+
+// 网络的全部参数
+struct cnn_params {
+    const float *conv1_weight; // [2, 1, 3, 3]
+    const float *conv1_bias;   // [2]
+    const float *conv2_weight; // [4, 2, 3, 3]
+    const float *conv2_bias;   // [4]
+    const float *fc1_weight;   // [24, 196]
+    const float *fc1_bias;     // [24]
+    const float *fc2_weight;   // [10, 24]
+    const float *fc2_bias;     // [10]
+};
+
+// 单张图像的前向推理（参考实现），input为归一化到[0, 1]的28x28图像
+void cnn_forward(const float *input, const float *conv1_weight, const float *conv1_bias,
+                 const float *conv2_weight, const float *conv2_bias,
+                 const float *fc1_weight, const float *fc1_bias,
+                 const float *fc2_weight, const float *fc2_bias,
+                 float *output);
+
+// 全连接层 out = weight * in + bias（weight为 [n_out, n_in]），relu非0时再做ReLU
+void cnn_dense(const float *in, int n_in, const float *weight, const float *bias, int n_out, int relu, float *out);
+
+// 单张图像前向推理的各层结果
+struct cnn_activations {
+    float input[IMG_C * IMG_H * IMG_W];                          // 标准化后的输入
+    float relu1[CONV1_OUT_CHANNELS * CONV1_OUT_H * CONV1_OUT_W]; // 第一个卷积层 + ReLU
+    float pool2[FC1_IN];                                         // 第二个卷积层 + ReLU + 两次池化
+    float fc1[FC1_OUT];                                          // 第一个全连接层 + ReLU
+    float output[FC2_OUT];                                       // 第二个全连接层
+};
+
+// 与cnn_forward相同，但保留各层结果（INT8量化校准时统计各层激活值的范围）
+void cnn_forward_activations(const struct cnn_params *params, const float *input, struct cnn_activations *act);
+
+// 网络输出中最大值的索引，即识别结果
+int argmax(const float *output);
+
+// 批量推理的中间结果缓冲区，按最大批大小分配一次，之后反复使用
+struct cnn_batch_workspace;
+
+struct cnn_batch_workspace *cnn_batch_workspace_create(int max_batch);
+void cnn_batch_workspace_free(struct cnn_batch_workspace *ws);
+
+// 批量前向推理：input为连续存放的n张28x28图像（与cnn_forward的输入相同），
+// output为n x 10。两个卷积层用im2col展开后与全连接层一样做矩阵乘法，n不能超过max_batch。
+// 每张图像的结果与n无关，但累加顺序与cnn_forward不同，输出只在舍入误差内相同
+void cnn_forward_batch(const struct cnn_params *params, const float *input, int n,
+                       float *output, struct cnn_batch_workspace *ws);
+
+#endif // CNN_H
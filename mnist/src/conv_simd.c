@@ -0,0 +1,327 @@
+#include "conv_simd.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CONV_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// 计算一个输出通道第oh行的28个点: out_row[ow] = ReLU(sum weight[ic][kh][kw] * in[ic][oh + kh][ow + kw] + bias)，
+// in为in_channels个补0后的通道（第ic个从in + ic * PAD_PLANE开始），weight为 [in_channels, 3, 3]
+typedef void (*conv_row_fn)(const float *in, int in_channels, const float *weight, float bias, int oh, float *out_row);
+
+static void conv_row_scalar(const float *in, int in_channels, const float *weight, float bias, int oh, float *out_row)
+{
+    for (int ow = 0; ow < IMG_W; ow++) {
+        float sum = 0.0f;
+        for (int ic = 0; ic < in_channels; ic++) {
+            for (int kh = 0; kh < 3; kh++) {
+                for (int kw = 0; kw < 3; kw++) {
+                    sum += in[ic * PAD_PLANE + (oh + kh) * PAD_W + ow + kw] * weight[ic * 9 + kh * 3 + kw];
+                }
+            }
+        }
+        sum += bias;
+        out_row[ow] = sum > 0 ? sum : 0;
+    }
+}
+
+static void qconv_row_scalar(const int16_t *in, int in_channels, const int8_t *weight, int32_t bias, float m,
+                             int oh, int16_t *out_row)
+{
+    for (int ow = 0; ow < IMG_W; ow++) {
+        int32_t sum = bias;
+        for (int ic = 0; ic < in_channels; ic++) {
+            for (int kh = 0; kh < 3; kh++) {
+                for (int kw = 0; kw < 3; kw++) {
+                    sum += in[ic * PAD_PLANE + (oh + kh) * PAD_W + ow + kw] * weight[ic * 9 + kh * 3 + kw];
+                }
+            }
+        }
+        out_row[ow] = requantize_relu(sum, m);
+    }
+}
+
+// INT8卷积核最多的位置数（第二个卷积层：2个输入通道 x 9）
+#define QCONV_MAX_TAPS (CONV2_IN_CHANNELS * 9)
+
+// 把卷积核的各个位置两两配对：第j对的两个输入行为 in + off[2j]、in + off[2j + 1]，
+// 两个权重打包为一个32位数（低16位为第一个），madd时与交错后的输入相乘。位置数为奇数时最后一个与权重0配对
+static int qconv_pairs(int in_channels, const int8_t *weight, int oh, int *off, int32_t *wpair)
+{
+    const int taps = in_channels * 9;
+    int t = 0;
+    for (int ic = 0; ic < in_channels; ic++) {
+        for (int kh = 0; kh < 3; kh++) {
+            int row = ic * PAD_PLANE + (oh + kh) * PAD_W;
+            off[t++] = row;
+            off[t++] = row + 1;
+            off[t++] = row + 2;
+        }
+    }
+    off[taps] = off[taps - 1];
+    int pairs = (taps + 1) / 2;
+    for (int j = 0; j < pairs; j++) {
+        int16_t w0 = weight[2 * j];
+        int16_t w1 = 2 * j + 1 < taps ? weight[2 * j + 1] : 0;
+        wpair[j] = (int32_t)(uint16_t)w0 | (int32_t)((uint32_t)(uint16_t)w1 << 16);
+    }
+    return pairs;
+}
+
+#ifdef CONV_SIMD_X86
+
+// 一行28个点为7个4路向量，累加器全部放在寄存器中，每个权重只广播一次
+__attribute__((target("sse4.1")))
+static void conv_row_sse4(const float *in, int in_channels, const float *weight, float bias, int oh, float *out_row)
+{
+    __m128 acc[IMG_W / 4];
+    for (int v = 0; v < IMG_W / 4; v++) {
+        acc[v] = _mm_setzero_ps();
+    }
+    for (int ic = 0; ic < in_channels; ic++) {
+        for (int kh = 0; kh < 3; kh++) {
+            const float *src = in + ic * PAD_PLANE + (oh + kh) * PAD_W;
+            for (int kw = 0; kw < 3; kw++) {
+                __m128 w = _mm_set1_ps(weight[ic * 9 + kh * 3 + kw]);
+                for (int v = 0; v < IMG_W / 4; v++) {
+                    acc[v] = _mm_add_ps(acc[v], _mm_mul_ps(_mm_loadu_ps(src + 4 * v + kw), w));
+                }
+            }
+        }
+    }
+    __m128 b = _mm_set1_ps(bias);
+    __m128 zero = _mm_setzero_ps();
+    for (int v = 0; v < IMG_W / 4; v++) {
+        _mm_storeu_ps(out_row + 4 * v, _mm_max_ps(_mm_add_ps(acc[v], b), zero));
+    }
+}
+
+// 一行28个点为3个8路向量加1个4路向量
+__attribute__((target("avx2")))
+static void conv_row_avx2(const float *in, int in_channels, const float *weight, float bias, int oh, float *out_row)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+    for (int ic = 0; ic < in_channels; ic++) {
+        for (int kh = 0; kh < 3; kh++) {
+            const float *src = in + ic * PAD_PLANE + (oh + kh) * PAD_W;
+            for (int kw = 0; kw < 3; kw++) {
+                __m256 w = _mm256_set1_ps(weight[ic * 9 + kh * 3 + kw]);
+                acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(src + kw), w));
+                acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(src + 8 + kw), w));
+                acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(src + 16 + kw), w));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(src + 24 + kw), _mm256_castps256_ps128(w)));
+            }
+        }
+    }
+    __m256 b = _mm256_set1_ps(bias);
+    __m256 zero = _mm256_setzero_ps();
+    _mm256_storeu_ps(out_row, _mm256_max_ps(_mm256_add_ps(acc0, b), zero));
+    _mm256_storeu_ps(out_row + 8, _mm256_max_ps(_mm256_add_ps(acc1, b), zero));
+    _mm256_storeu_ps(out_row + 16, _mm256_max_ps(_mm256_add_ps(acc2, b), zero));
+    _mm_storeu_ps(out_row + 24, _mm_max_ps(_mm_add_ps(acc3, _mm256_castps256_ps128(b)), _mm_setzero_ps()));
+}
+
+// INT8：每次取8个点（起点0、8、16、20，最后一组与前一组重叠），
+// 两个位置的输入交错后 [a0 b0 a1 b1 ...] 与 [w0 w1 w0 w1 ...] 做madd，得到4个点的int32部分和
+__attribute__((target("sse4.1")))
+static void qconv_row_sse4(const int16_t *in, int in_channels, const int8_t *weight, int32_t bias, float m,
+                           int oh, int16_t *out_row)
+{
+    static const int start[4] = {0, 8, 16, IMG_W - 8};
+    int off[QCONV_MAX_TAPS + 1];
+    int32_t wpair[(QCONV_MAX_TAPS + 1) / 2];
+    int pairs = qconv_pairs(in_channels, weight, oh, off, wpair);
+
+    __m128i acc[8];
+    for (int v = 0; v < 8; v++) {
+        acc[v] = _mm_set1_epi32(bias);
+    }
+    for (int j = 0; j < pairs; j++) {
+        const int16_t *a = in + off[2 * j];
+        const int16_t *b = in + off[2 * j + 1];
+        __m128i w = _mm_set1_epi32(wpair[j]);
+        for (int g = 0; g < 4; g++) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + start[g]));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + start[g]));
+            acc[2 * g] = _mm_add_epi32(acc[2 * g], _mm_madd_epi16(_mm_unpacklo_epi16(va, vb), w));
+            acc[2 * g + 1] = _mm_add_epi32(acc[2 * g + 1], _mm_madd_epi16(_mm_unpackhi_epi16(va, vb), w));
+        }
+    }
+    // 与requantize_relu相同：max(acc, 0) * m，截断到127，按当前舍入模式（最近偶数）转换为整数
+    __m128 vm = _mm_set1_ps(m);
+    __m128 limit = _mm_set1_ps(127.0f);
+    for (int v = 0; v < 8; v++) {
+        __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_max_epi32(acc[v], _mm_setzero_si128())), vm);
+        acc[v] = _mm_cvtps_epi32(_mm_min_ps(f, limit));
+    }
+    for (int g = 0; g < 4; g++) {
+        _mm_storeu_si128((__m128i *)(out_row + start[g]), _mm_packs_epi32(acc[2 * g], acc[2 * g + 1]));
+    }
+}
+
+// INT8：每次取16个点（起点0和12，有重叠）。256位的unpack在两个128位半边内分别交错，
+// 所以lo为第0-3、8-11个点，hi为第4-7、12-15个点；packs同样按半边进行，结果恰好是第0-15个点的顺序
+__attribute__((target("avx2")))
+static void qconv_row_avx2(const int16_t *in, int in_channels, const int8_t *weight, int32_t bias, float m,
+                           int oh, int16_t *out_row)
+{
+    int off[QCONV_MAX_TAPS + 1];
+    int32_t wpair[(QCONV_MAX_TAPS + 1) / 2];
+    int pairs = qconv_pairs(in_channels, weight, oh, off, wpair);
+
+    __m256i lo0 = _mm256_set1_epi32(bias), hi0 = lo0, lo1 = lo0, hi1 = lo0;
+    for (int j = 0; j < pairs; j++) {
+        const int16_t *a = in + off[2 * j];
+        const int16_t *b = in + off[2 * j + 1];
+        __m256i w = _mm256_set1_epi32(wpair[j]);
+        __m256i va = _mm256_loadu_si256((const __m256i *)a);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+        lo0 = _mm256_add_epi32(lo0, _mm256_madd_epi16(_mm256_unpacklo_epi16(va, vb), w));
+        hi0 = _mm256_add_epi32(hi0, _mm256_madd_epi16(_mm256_unpackhi_epi16(va, vb), w));
+        va = _mm256_loadu_si256((const __m256i *)(a + IMG_W - 16));
+        vb = _mm256_loadu_si256((const __m256i *)(b + IMG_W - 16));
+        lo1 = _mm256_add_epi32(lo1, _mm256_madd_epi16(_mm256_unpacklo_epi16(va, vb), w));
+        hi1 = _mm256_add_epi32(hi1, _mm256_madd_epi16(_mm256_unpackhi_epi16(va, vb), w));
+    }
+    __m256 vm = _mm256_set1_ps(m);
+    __m256 limit = _mm256_set1_ps(127.0f);
+    __m256i zero = _mm256_setzero_si256();
+    lo0 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_max_epi32(lo0, zero)), vm), limit));
+    hi0 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_max_epi32(hi0, zero)), vm), limit));
+    lo1 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_max_epi32(lo1, zero)), vm), limit));
+    hi1 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_max_epi32(hi1, zero)), vm), limit));
+    _mm256_storeu_si256((__m256i *)out_row, _mm256_packs_epi32(lo0, hi0));
+    _mm256_storeu_si256((__m256i *)(out_row + IMG_W - 16), _mm256_packs_epi32(lo1, hi1));
+}
+
+#endif // CONV_SIMD_X86
+
+static const char *const isa_names[CONV_ISA_COUNT] = {"scalar", "sse4", "avx2"};
+
+const char *conv_isa_name(enum conv_isa isa)
+{
+    return isa >= 0 && isa < CONV_ISA_COUNT ? isa_names[isa] : "unknown";
+}
+
+int conv_isa_parse(const char *name)
+{
+    if (strcmp(name, "auto") == 0) {
+        return conv_isa_best();
+    }
+    for (int i = 0; i < CONV_ISA_COUNT; i++) {
+        if (strcmp(name, isa_names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int conv_isa_supported(enum conv_isa isa)
+{
+    switch (isa) {
+    case CONV_ISA_SCALAR:
+        return 1;
+#ifdef CONV_SIMD_X86
+    case CONV_ISA_SSE4:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.1");
+    case CONV_ISA_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return 0;
+    }
+}
+
+enum conv_isa conv_isa_best(void)
+{
+    int best = CONV_ISA_SCALAR;
+    for (int i = CONV_ISA_SCALAR + 1; i < CONV_ISA_COUNT; i++) {
+        best = conv_isa_supported(i) ? i : best;
+    }
+    return best;
+}
+
+static conv_row_fn conv_row_for(enum conv_isa isa)
+{
+    switch (isa) {
+#ifdef CONV_SIMD_X86
+    case CONV_ISA_SSE4:
+        return conv_row_sse4;
+    case CONV_ISA_AVX2:
+        return conv_row_avx2;
+#endif
+    default:
+        return conv_row_scalar;
+    }
+}
+
+void cnn_forward_simd(const struct cnn_params *params, const float *input, float *output, enum conv_isa isa)
+{
+    const conv_row_fn conv_row = conv_row_for(isa);
+
+    // 补0后的输入和第一个卷积层的结果，共约11KB
+    float in_pad[CONV1_IN_CHANNELS * PAD_PLANE];
+    float relu1_pad[CONV1_OUT_CHANNELS * PAD_PLANE];
+    float pool2[FC1_IN];
+    float fc1[FC1_OUT];
+    float row[CONV2_OUT_W];
+
+    memset(in_pad, 0, sizeof(in_pad));
+    memset(relu1_pad, 0, sizeof(relu1_pad));
+
+    // 输入标准化，写入补0后的缓冲区中间
+    for (int h = 0; h < IMG_H; h++) {
+        for (int w = 0; w < IMG_W; w++) {
+            in_pad[(h + 1) * PAD_W + w + 1] = (input[h * IMG_W + w] - 0.1307f) / 0.3081f;
+        }
+    }
+
+    // 1. 第一个卷积层 + ReLU，每行直接写入第二个卷积层的补0输入
+    for (int oc = 0; oc < CONV1_OUT_CHANNELS; oc++) {
+        for (int oh = 0; oh < CONV1_OUT_H; oh++) {
+            conv_row(in_pad, CONV1_IN_CHANNELS, params->conv1_weight + oc * CONV1_IN_CHANNELS * 9,
+                     params->conv1_bias[oc], oh, relu1_pad + oc * PAD_PLANE + (oh + 1) * PAD_W + 1);
+        }
+    }
+
+    // 2. 第二个卷积层 + ReLU + 4x4池化：每4行卷积结果取最大值得到一行池化结果
+    for (int oc = 0; oc < CONV2_OUT_CHANNELS; oc++) {
+        for (int y = 0; y < POOL2_OUT_H; y++) {
+            float *pooled = pool2 + (oc * POOL2_OUT_H + y) * POOL2_OUT_W;
+            for (int x = 0; x < POOL2_OUT_W; x++) {
+                pooled[x] = 0.0f;
+            }
+            for (int dy = 0; dy < 4; dy++) {
+                conv_row(relu1_pad, CONV2_IN_CHANNELS, params->conv2_weight + oc * CONV2_IN_CHANNELS * 9,
+                         params->conv2_bias[oc], 4 * y + dy, row);
+                for (int x = 0; x < POOL2_OUT_W; x++) {
+                    float m = fmaxf(fmaxf(row[4*x], row[4*x + 1]), fmaxf(row[4*x + 2], row[4*x + 3]));
+                    pooled[x] = fmaxf(pooled[x], m);
+                }
+            }
+        }
+    }
+
+    // 3. 全连接层
+    cnn_dense(pool2, FC1_IN, params->fc1_weight, params->fc1_bias, FC1_OUT, 1, fc1);
+    cnn_dense(fc1, FC2_IN, params->fc2_weight, params->fc2_bias, FC2_OUT, 0, output);
+}
+
+qconv_row_fn qconv_row_for(enum conv_isa isa)
+{
+    switch (isa) {
+#ifdef CONV_SIMD_X86
+    case CONV_ISA_SSE4:
+        return qconv_row_sse4;
+    case CONV_ISA_AVX2:
+        return qconv_row_avx2;
+#endif
+    default:
+        return qconv_row_scalar;
+    }
+}
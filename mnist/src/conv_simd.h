@@ -0,0 +1,65 @@
+#ifndef CONV_SIMD_H
+#define CONV_SIMD_H
+
+#include <stdint.h>
+#include "cnn.h"
+
+// 针对本网络两个3x3卷积层的SIMD实现：输入预先补好一圈0（padding），每次计算一个输出通道的
+// 一整行（28个点分布在SIMD的各个通道上），内层循环没有边界判断。
+// 每个点的乘加顺序与cnn_forward相同（不使用FMA），补的0只会加上±0，所以结果与cnn_forward一致
+
+// 补0后的通道：上下左右各补一圈0为30x30，每行按32个元素存放（float与INT8推理共用这一布局）
+#define PAD_H (IMG_H + 2)
+#define PAD_W 32
+#define PAD_PLANE (PAD_H * PAD_W)
+
+// 卷积核使用的指令集
+enum conv_isa {
+    CONV_ISA_SCALAR,
+    CONV_ISA_SSE4,
+    CONV_ISA_AVX2,
+    CONV_ISA_COUNT
+};
+
+// 指令集的名字（"scalar"、"sse4"、"avx2"）
+const char *conv_isa_name(enum conv_isa isa);
+
+// 按名字查找指令集，"auto"表示当前CPU支持的最快的指令集；找不到时返回-1
+int conv_isa_parse(const char *name);
+
+// 当前CPU是否支持该指令集
+int conv_isa_supported(enum conv_isa isa);
+
+// 当前CPU支持的最快的指令集
+enum conv_isa conv_isa_best(void);
+
+// 单张图像的前向推理，输入输出与cnn_forward相同，卷积层使用isa对应的卷积核（CPU必须支持）
+void cnn_forward_simd(const struct cnn_params *params, const float *input, float *output, enum conv_isa isa);
+
+// 四舍五入到最近的整数（恰在中间时取偶数，与默认舍入模式下的lrintf相同），|x| <= 2^22。
+// 加上1.5 * 2^23后float的最小单位为1，舍入由加法完成；不调用库函数，循环可以向量化
+static inline float round_even(float x)
+{
+    return x + 0x1.8p23f - 0x1.8p23f;
+}
+
+// INT8推理中对int32累加结果做ReLU并按步长比m（m > 0）重新量化为[0, 127]
+static inline int16_t requantize_relu(int32_t acc, float m)
+{
+    float v = acc > 0 ? acc * m : 0.0f;
+    return (int16_t)round_even(v < 127.0f ? v : 127.0f);
+}
+
+// INT8推理的卷积行核：计算一个输出通道第oh行的28个点
+//   out_row[ow] = requantize_relu(sum weight[ic][kh][kw] * in[ic][oh + kh][ow + kw] + bias, m)
+// in为in_channels个补0后的通道（第ic个从in + ic * PAD_PLANE开始），元素是int8范围内的值，按int16存放，
+// 这样SIMD实现可以把相邻两个卷积核位置的输入交错后用一条madd（int16相乘、相邻两对相加为int32）计算。
+// 累加是整数运算，重新量化的每一步也与requantize_relu相同，所以各指令集的结果完全相同。
+// 重新量化是单调不减的，池化可以在重新量化之后进行
+typedef void (*qconv_row_fn)(const int16_t *in, int in_channels, const int8_t *weight, int32_t bias, float m,
+                             int oh, int16_t *out_row);
+
+// isa对应的INT8卷积行核（CPU必须支持）
+qconv_row_fn qconv_row_for(enum conv_isa isa);
+
+#endif // CONV_SIMD_H
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, sysconf
+
+#include "eval.h"
+#include "conv_simd.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// 一个线程负责的图像区间 [begin, end) 和它自己的统计结果
+struct eval_task {
+    const struct cnn_params *params;
+    struct eval_options options;
+    const uint8_t *images; // 连续存放的28x28图像
+    const uint8_t *labels;
+    uint32_t begin, end;
+    int status; // 0表示成功，-1表示分配内存失败
+    int correct;
+    int confusion[FC2_OUT][FC2_OUT];
+};
+
+static void *eval_worker(void *arg)
+{
+    struct eval_task *task = arg;
+    const struct cnn_params *p = task->params;
+    const struct eval_options *opt = &task->options;
+
+    // 每批最多batch张图像连续存放，batch为0时逐张推理
+    int batch = opt->qparams || opt->isa >= 0 ? 0 : opt->batch;
+    // INT8推理总是使用行卷积核，未指定指令集时用CPU支持的最快的
+    enum conv_isa int8_isa = opt->isa >= 0 ? (enum conv_isa)opt->isa : conv_isa_best();
+    int max_batch = batch > 0 ? batch : 1;
+    float *input = malloc((size_t)max_batch * IMG_H * IMG_W * sizeof(float));
+    float *output = malloc((size_t)max_batch * FC2_OUT * sizeof(float));
+    struct cnn_batch_workspace *ws = batch > 0 ? cnn_batch_workspace_create(batch) : NULL;
+    if (!input || !output || (batch > 0 && !ws)) {
+        task->status = -1;
+        goto done;
+    }
+
+    for (uint32_t first = task->begin; first < task->end; first += max_batch) {
+        int n = task->end - first < (uint32_t)max_batch ? (int)(task->end - first) : max_batch;
+
+        // 将图像数据转换为浮点数
+        for (int b = 0; b < n; b++) {
+            for (int j = 0; j < IMG_H * IMG_W; j++) {
+                input[b * IMG_H * IMG_W + j] = task->images[(size_t)(first + b) * IMG_H * IMG_W + j] / 255.0f; // 简单归一化，cnn_forward中会做正确的标准化
+            }
+        }
+
+        // 执行CNN前向推理
+        if (opt->qparams) {
+            cnn_forward_int8(opt->qparams, input, output, int8_isa);
+        } else if (ws) {
+            cnn_forward_batch(p, input, n, output, ws);
+        } else if (opt->isa >= 0) {
+            cnn_forward_simd(p, input, output, opt->isa);
+        } else {
+            cnn_forward(input, p->conv1_weight, p->conv1_bias, p->conv2_weight, p->conv2_bias,
+                        p->fc1_weight, p->fc1_bias, p->fc2_weight, p->fc2_bias, output);
+        }
+
+        for (int b = 0; b < n; b++) {
+            int label = task->labels[first + b];
+            int predicted = argmax(output + b * FC2_OUT);
+            task->confusion[label][predicted]++;
+            task->correct += predicted == label;
+        }
+    }
+
+done:
+    cnn_batch_workspace_free(ws);
+    free(input);
+    free(output);
+    return NULL;
+}
+
+int evaluate_test_set(const struct cnn_params *params, const uint8_t *images, const uint8_t *labels,
+                      uint32_t num_images, const struct eval_options *options, struct eval_result *result)
+{
+    int threads = options->threads;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if ((uint32_t)threads > num_images) {
+        threads = num_images > 0 ? (int)num_images : 1;
+    }
+
+    struct eval_task *tasks = calloc(threads, sizeof(*tasks));
+    pthread_t *workers = calloc(threads, sizeof(*workers));
+    if (!tasks || !workers) {
+        free(tasks);
+        free(workers);
+        return -1;
+    }
+    for (int t = 0; t < threads; t++) {
+        tasks[t].params = params;
+        tasks[t].options = *options;
+        tasks[t].images = images;
+        tasks[t].labels = labels;
+        tasks[t].begin = (uint64_t)num_images * t / threads;
+        tasks[t].end = (uint64_t)num_images * (t + 1) / threads;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // 第0个区间由当前线程计算
+    int started = 1;
+    int status = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&workers[started], NULL, eval_worker, &tasks[started]) != 0) {
+            status = -1;
+            break;
+        }
+    }
+    eval_worker(&tasks[0]);
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    // 合并各线程的统计结果
+    memset(result, 0, sizeof(*result));
+    result->total = num_images;
+    result->threads = threads;
+    result->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    for (int t = 0; t < threads; t++) {
+        status = tasks[t].status != 0 ? -1 : status;
+        result->correct += tasks[t].correct;
+        for (int i = 0; i < FC2_OUT; i++) {
+            for (int j = 0; j < FC2_OUT; j++) {
+                result->confusion[i][j] += tasks[t].confusion[i][j];
+            }
+        }
+    }
+
+    free(tasks);
+    free(workers);
+    return status;
+}
+
+void print_confusion_matrix(const struct eval_result *result)
+{
+    printf("混淆矩阵（行：真实标签，列：识别结果）:\n     ");
+    for (int j = 0; j < FC2_OUT; j++) {
+        printf("%6d", j);
+    }
+    printf("\n");
+    for (int i = 0; i < FC2_OUT; i++) {
+        printf("%5d", i);
+        for (int j = 0; j < FC2_OUT; j++) {
+            printf("%6d", result->confusion[i][j]);
+        }
+        printf("\n");
+    }
+}
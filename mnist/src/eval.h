@@ -0,0 +1,36 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <stdint.h>
+#include "cnn.h"
+#include "quant.h"
+
+// 测试集评估的统计结果
+struct eval_result {
+    int total;                       // 图像数
+    int correct;                     // 识别正确的图像数
+    int confusion[FC2_OUT][FC2_OUT]; // 混淆矩阵 [真实标签][识别结果]
+    int threads;                     // 实际使用的线程数
+    double seconds;                  // 推理耗时（不含读取数据）
+};
+
+// 推理方式
+struct eval_options {
+    int batch;                         // 每批推理的图像数，0表示逐张推理
+    int threads;                       // 线程数，0表示使用CPU核数
+    int isa;                           // 逐张推理时：-1表示调用cnn_forward，否则用该指令集调用cnn_forward_simd
+    const struct cnn_qparams *qparams; // 不为NULL时逐张调用cnn_forward_int8（忽略batch），isa为-1时用conv_isa_best()
+};
+
+// 多线程评估测试集，images为连续存放的num_images张28x28图像。图像按连续区间平均分给各线程，
+// 每个线程使用自己的缓冲区并单独统计，全部结束后再合并，所以结果与线程数无关。
+// 推理方式不同时结果可能不同：批量推理的矩阵乘法先加偏置、再按gemm.c中的SGEMM_KC分段累加，
+// 与逐张推理的累加顺序不同，logits只在舍入误差内一致（批大小本身不影响结果）。
+// 成功返回0，分配内存或创建线程失败返回-1
+int evaluate_test_set(const struct cnn_params *params, const uint8_t *images, const uint8_t *labels,
+                      uint32_t num_images, const struct eval_options *options, struct eval_result *result);
+
+// 打印混淆矩阵
+void print_confusion_matrix(const struct eval_result *result);
+
+#endif // EVAL_H
@@ -0,0 +1,113 @@
+#include "gemm.h"
+#include <string.h>
+
+// 分块大小：B的一块（SGEMM_KC x SGEMM_NC）留在L1/L2中，被A的所有行块反复使用；
+// 微内核每次计算C的SGEMM_MR x SGEMM_NR个元素，累加器全部放在寄存器中
+#define SGEMM_MR 4
+#define SGEMM_NR 8
+#define SGEMM_KC 128
+#define SGEMM_NC 512
+
+// 把A的mr行（mr <= SGEMM_MR）、kc列打包为按列交错的面板 pa[p * SGEMM_MR + i]，不足的行补0
+static void pack_a(int mr, int kc, const float *a, int lda, float *pa)
+{
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < SGEMM_MR; i++) {
+            pa[p * SGEMM_MR + i] = i < mr ? a[i * lda + p] : 0.0f;
+        }
+    }
+}
+
+// 微内核：C[0..mr)[0..SGEMM_NR) += PA * B。内层循环次数固定，编译器可以完全展开并向量化
+static void sgemm_kernel(int mr, int kc, const float *pa, const float *b, int ldb, float *c, int ldc)
+{
+    float acc[SGEMM_MR][SGEMM_NR] = {{0.0f}};
+    for (int p = 0; p < kc; p++) {
+        const float *bp = b + p * ldb;
+        for (int i = 0; i < SGEMM_MR; i++) {
+            float ai = pa[p * SGEMM_MR + i];
+            for (int j = 0; j < SGEMM_NR; j++) {
+                acc[i][j] += ai * bp[j];
+            }
+        }
+    }
+    for (int i = 0; i < mr; i++) {
+        for (int j = 0; j < SGEMM_NR; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+
+// 列数不足SGEMM_NR的剩余部分
+static void sgemm_edge(int mr, int nr, int kc, const float *pa, const float *b, int ldb, float *c, int ldc)
+{
+    for (int i = 0; i < mr; i++) {
+        for (int j = 0; j < nr; j++) {
+            float sum = 0.0f;
+            for (int p = 0; p < kc; p++) {
+                sum += pa[p * SGEMM_MR + i] * b[p * ldb + j];
+            }
+            c[i * ldc + j] += sum;
+        }
+    }
+}
+
+void sgemm(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc)
+{
+    float pa[SGEMM_KC * SGEMM_MR];
+
+    for (int pc = 0; pc < k; pc += SGEMM_KC) {
+        int kc = k - pc < SGEMM_KC ? k - pc : SGEMM_KC;
+        for (int jc = 0; jc < n; jc += SGEMM_NC) {
+            int nc = n - jc < SGEMM_NC ? n - jc : SGEMM_NC;
+            for (int ic = 0; ic < m; ic += SGEMM_MR) {
+                int mr = m - ic < SGEMM_MR ? m - ic : SGEMM_MR;
+                pack_a(mr, kc, a + ic * lda + pc, lda, pa);
+
+                const float *bb = b + pc * ldb + jc;
+                float *cc = c + ic * ldc + jc;
+                int jr = 0;
+                for (; jr + SGEMM_NR <= nc; jr += SGEMM_NR) {
+                    sgemm_kernel(mr, kc, pa, bb + jr, ldb, cc + jr, ldc);
+                }
+                if (jr < nc) {
+                    sgemm_edge(mr, nc - jr, kc, pa, bb + jr, ldb, cc + jr, ldc);
+                }
+            }
+        }
+    }
+}
+
+void im2col(const float *in, int channels, int channel_stride, int h, int w, int ksize, int pad, float *col)
+{
+    const int plane = h * w;
+
+    for (int c = 0; c < channels; c++) {
+        const float *src = in + c * channel_stride;
+        for (int kh = 0; kh < ksize; kh++) {
+            for (int kw = 0; kw < ksize; kw++) {
+                float *row = col + ((c * ksize + kh) * ksize + kw) * plane;
+                // 这一行中有效的输出列范围 [ow0, ow1)，其余位置对应padding
+                int dw = kw - pad;
+                int ow0 = dw < 0 ? -dw : 0;
+                int ow1 = dw > 0 ? w - dw : w;
+
+                for (int oh = 0; oh < h; oh++) {
+                    int ih = oh + kh - pad;
+                    float *d = row + oh * w;
+                    if (ih < 0 || ih >= h) {
+                        memset(d, 0, w * sizeof(float));
+                        continue;
+                    }
+                    for (int ow = 0; ow < ow0; ow++) {
+                        d[ow] = 0.0f;
+                    }
+                    memcpy(d + ow0, src + ih * w + ow0 + dw, (ow1 - ow0) * sizeof(float));
+                    for (int ow = ow1; ow < w; ow++) {
+                        d[ow] = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+// 矩阵均为行主序，ld为相邻两行的间距（以元素计）
+
+// C += A * B，A为m x k，B为k x n，C为m x n
+void sgemm(int m, int n, int k, const float *a, int lda, const float *b, int ldb, float *c, int ldc);
+
+// 把一张图像的channels个通道展开为卷积的列矩阵（步长1，输出尺寸与输入相同）。
+// 第c个通道从in + c * channel_stride开始，是h x w的图像；
+// 输出为 (channels * ksize * ksize) x (h * w)，行号为 (c, kh, kw)，越界的位置填0
+void im2col(const float *in, int channels, int channel_stride, int h, int w, int ksize, int pad, float *col);
+
+#endif // GEMM_H
@@ -0,0 +1,168 @@
+#define _POSIX_C_SOURCE 200809L // mmap
+
+#include "loader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define IDX_IMAGES_MAGIC 0x00000803
+#define IDX_LABELS_MAGIC 0x00000801
+#define IDX_IMAGES_HEADER 16
+#define IDX_LABELS_HEADER 8
+
+int map_file(const char *filename, struct mapped_file *file)
+{
+    file->data = NULL;
+    file->size = 0;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "无法打开文件 %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "文件 %s 为空或无法读取大小\n", filename);
+        close(fd);
+        return -1;
+    }
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // 映射建立后就不再需要文件描述符
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "无法映射文件 %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    file->data = data;
+    file->size = st.st_size;
+    return 0;
+}
+
+void unmap_file(struct mapped_file *file)
+{
+    if (file->data) {
+        munmap((void *)file->data, file->size);
+    }
+    file->data = NULL;
+    file->size = 0;
+}
+
+// 读取大端整数（4字节）
+static uint32_t read_big_endian(const uint8_t *bytes)
+{
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+int open_mnist_images(const char *filename, struct mnist_images *images)
+{
+    memset(images, 0, sizeof(*images));
+    if (map_file(filename, &images->file) != 0) {
+        return -1;
+    }
+
+    const uint8_t *data = images->file.data;
+    size_t size = images->file.size;
+    if (size < IDX_IMAGES_HEADER || read_big_endian(data) != IDX_IMAGES_MAGIC) {
+        fprintf(stderr, "%s 不是IDX图像文件\n", filename);
+        close_mnist_images(images);
+        return -1;
+    }
+    images->count = read_big_endian(data + 4);
+    images->rows = read_big_endian(data + 8);
+    images->cols = read_big_endian(data + 12);
+    if (images->rows != IMG_H || images->cols != IMG_W) {
+        fprintf(stderr, "%s 中图像尺寸为 %ux%u，必须为 %dx%d\n", filename, images->rows, images->cols, IMG_H, IMG_W);
+        close_mnist_images(images);
+        return -1;
+    }
+    if (size != IDX_IMAGES_HEADER + (size_t)images->count * images->rows * images->cols) {
+        fprintf(stderr, "%s 的大小（%zu字节）与文件头中的 %u 张图像不符\n", filename, size, images->count);
+        close_mnist_images(images);
+        return -1;
+    }
+    images->pixels = data + IDX_IMAGES_HEADER;
+    return 0;
+}
+
+int open_mnist_labels(const char *filename, struct mnist_labels *labels)
+{
+    memset(labels, 0, sizeof(*labels));
+    if (map_file(filename, &labels->file) != 0) {
+        return -1;
+    }
+
+    const uint8_t *data = labels->file.data;
+    size_t size = labels->file.size;
+    if (size < IDX_LABELS_HEADER || read_big_endian(data) != IDX_LABELS_MAGIC) {
+        fprintf(stderr, "%s 不是IDX标签文件\n", filename);
+        close_mnist_labels(labels);
+        return -1;
+    }
+    labels->count = read_big_endian(data + 4);
+    if (size != IDX_LABELS_HEADER + (size_t)labels->count) {
+        fprintf(stderr, "%s 的大小（%zu字节）与文件头中的 %u 个标签不符\n", filename, size, labels->count);
+        close_mnist_labels(labels);
+        return -1;
+    }
+    labels->labels = data + IDX_LABELS_HEADER;
+    for (uint32_t i = 0; i < labels->count; i++) {
+        if (labels->labels[i] >= FC2_OUT) {
+            fprintf(stderr, "%s 中第 %u 个标签（%u）超出范围\n", filename, i, labels->labels[i]);
+            close_mnist_labels(labels);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void close_mnist_images(struct mnist_images *images)
+{
+    unmap_file(&images->file);
+    images->pixels = NULL;
+    images->count = 0;
+}
+
+void close_mnist_labels(struct mnist_labels *labels)
+{
+    unmap_file(&labels->file);
+    labels->labels = NULL;
+    labels->count = 0;
+}
+
+int map_cnn_params(const char *filename, struct cnn_params *params, struct mapped_file *file)
+{
+    static const size_t expected = CONV1_WEIGHT_SIZE + CONV1_OUT_CHANNELS + CONV2_WEIGHT_SIZE + CONV2_OUT_CHANNELS +
+                                   FC1_WEIGHT_SIZE + FC1_OUT + FC2_WEIGHT_SIZE + FC2_OUT;
+
+    if (map_file(filename, file) != 0) {
+        return -1;
+    }
+    if (file->size != expected * sizeof(float)) {
+        fprintf(stderr, "参数文件 %s 的大小为 %zu 字节，网络需要 %zu 个float（%zu 字节）\n",
+                filename, file->size, expected, expected * sizeof(float));
+        unmap_file(file);
+        return -1;
+    }
+
+    // mmap返回的地址按页对齐，各层参数的偏移都是4的倍数，可以直接作为float数组使用
+    const float *p = (const float *)file->data;
+    params->conv1_weight = p;
+    p += CONV1_WEIGHT_SIZE;
+    params->conv1_bias = p;
+    p += CONV1_OUT_CHANNELS;
+    params->conv2_weight = p;
+    p += CONV2_WEIGHT_SIZE;
+    params->conv2_bias = p;
+    p += CONV2_OUT_CHANNELS;
+    params->fc1_weight = p;
+    p += FC1_WEIGHT_SIZE;
+    params->fc1_bias = p;
+    p += FC1_OUT;
+    params->fc2_weight = p;
+    p += FC2_WEIGHT_SIZE;
+    params->fc2_bias = p;
+    return 0;
+}
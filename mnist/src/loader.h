@@ -0,0 +1,45 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cnn.h"
+
+// 用mmap只读映射整个文件，不复制数据：同一台机器上的多个进程共享页缓存中的同一份内存，
+// 只有实际访问到的页才会从磁盘读入
+
+// 只读映射的文件
+struct mapped_file {
+    const uint8_t *data;
+    size_t size;
+};
+
+// 成功返回0，失败时打印原因并返回-1
+int map_file(const char *filename, struct mapped_file *file);
+void unmap_file(struct mapped_file *file);
+
+// IDX格式的MNIST图像文件：pixels为连续存放的count张rows x cols图像，直接指向映射的内存
+struct mnist_images {
+    struct mapped_file file;
+    uint32_t count, rows, cols;
+    const uint8_t *pixels;
+};
+
+// IDX格式的MNIST标签文件：labels[i]为第i张图像的标签（0~9）
+struct mnist_labels {
+    struct mapped_file file;
+    uint32_t count;
+    const uint8_t *labels;
+};
+
+// 映射并检查文件头（魔数、尺寸）和文件大小，成功返回0，失败时打印原因并返回-1
+int open_mnist_images(const char *filename, struct mnist_images *images);
+int open_mnist_labels(const char *filename, struct mnist_labels *labels);
+void close_mnist_images(struct mnist_images *images);
+void close_mnist_labels(struct mnist_labels *labels);
+
+// 映射parameters_cnn.bin（按层顺序连续存放的float32，本机字节序），params中的指针指向映射的内存。
+// 文件大小必须与网络结构一致。成功返回0，失败时打印原因并返回-1；用完后unmap_file(file)
+int map_cnn_params(const char *filename, struct cnn_params *params, struct mapped_file *file);
+
+#endif // LOADER_H
@@ -4,396 +4,245 @@
 #include <stdint.h>
 #include <math.h>
 #include <string.h>
+#include "cnn.h"
+#include "conv_simd.h"
+#include "eval.h"
+#include "loader.h"
+#include "quant.h"
 
-// 参数维度常量
-#define IMG_W 28
-#define IMG_H 28
-#define IMG_C 1
-
-// 卷积层1参数
-#define CONV1_IN_CHANNELS 1
-#define CONV1_OUT_CHANNELS 2
-#define CONV1_KERNEL_SIZE 3
-#define CONV1_PADDING 1
-#define CONV1_OUT_W 28
-#define CONV1_OUT_H 28
-
-// 卷积层2参数
-#define CONV2_IN_CHANNELS 2
-#define CONV2_OUT_CHANNELS 4
-#define CONV2_KERNEL_SIZE 3
-#define CONV2_PADDING 1
-#define CONV2_OUT_W 28
-#define CONV2_OUT_H 28
-
-// 池化后的尺寸
-#define POOL1_OUT_W 14
-#define POOL1_OUT_H 14
-#define POOL2_OUT_W 7
-#define POOL2_OUT_H 7
-
-// 全连接层参数
-#define FC1_IN 4 * 7 * 7 
-#define FC1_OUT 24
-#define FC2_IN 24
-#define FC2_OUT 10
+#define PARAMS_FILE "./ExportPara/parameters_cnn.bin"
+#define QPARAMS_FILE "./ExportPara/parameters_cnn_int8.bin"
+#define TEST_IMAGES_FILE "./data/t10k-images-idx3-ubyte"
+#define TEST_LABELS_FILE "./data/t10k-labels-idx1-ubyte"
 
 // 函数声明
-uint32_t read_big_endian(FILE *fp);
-uint8_t **read_mnist_images(const char *filename, uint32_t *num_images, uint32_t *rows, uint32_t *cols);
-uint8_t *read_mnist_labels(const char *filename, uint32_t *num_labels);
 void readbmp(const char *filename, float *img);
-void cnn_forward(float *input, float *conv1_weight, float *conv1_bias, 
-                float *conv2_weight, float *conv2_bias, 
-                float *fc1_weight, float *fc1_bias, 
-                float *fc2_weight, float *fc2_bias, 
-                float *output);
 
 int main(int argc, char *argv[])
 {
     assert(sizeof(float) == 4); // 确保float是4字节
 
-    // 打开参数文件
-    FILE *fp = fopen("./ExportPara/parameters_cnn.bin", "rb");
-    if (!fp)
-    {
-        printf("无法打开参数文件！\n");
-        return 1;
-    }
-
-    // 分配内存
-    float *conv1_weight = (float *)malloc(CONV1_OUT_CHANNELS * CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE * sizeof(float));
-    float *conv1_bias = (float *)malloc(CONV1_OUT_CHANNELS * sizeof(float));
-    float *conv2_weight = (float *)malloc(CONV2_OUT_CHANNELS * CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE * sizeof(float));
-    float *conv2_bias = (float *)malloc(CONV2_OUT_CHANNELS * sizeof(float));
-    float *fc1_weight = (float *)malloc(FC1_OUT * FC1_IN * sizeof(float));
-    float *fc1_bias = (float *)malloc(FC1_OUT * sizeof(float));
-    float *fc2_weight = (float *)malloc(FC2_OUT * FC2_IN * sizeof(float));
-    float *fc2_bias = (float *)malloc(FC2_OUT * sizeof(float));
-
-    if (!conv1_weight || !conv1_bias || !conv2_weight || !conv2_bias ||
-        !fc1_weight || !fc1_bias || !fc2_weight || !fc2_bias)
-    {
-        printf("内存分配失败！\n");
-        fclose(fp);
-        return 2;
-    }
-
-    // 读取参数
-    size_t nread;
-
-    // 读取卷积层1参数
-    nread = fread(conv1_weight, sizeof(float), CONV1_OUT_CHANNELS * CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE, fp);
-    if (nread != CONV1_OUT_CHANNELS * CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE)
-    {
-        printf("conv1_weight读取失败, read %zu elements\n", nread);
-        return 3;
-    }
-
-    nread = fread(conv1_bias, sizeof(float), CONV1_OUT_CHANNELS, fp);
-    if (nread != CONV1_OUT_CHANNELS)
+    // 解析命令行参数：[图片路径] [--batch N] [--threads N] [--simd ISA] [--quantize N] [--int8]
+    const char *image_path = NULL;
+    int batch = 0;
+    int threads = 0;
+    int isa = conv_isa_best(); // 不小于0时逐张推理，卷积层使用该指令集的SIMD卷积核（默认用CPU支持的最好的）
+    int batch_given = 0, simd_given = 0;
+    int calibration = 0; // 大于0时用这么多张测试集图像校准并生成量化参数文件
+    int use_int8 = 0;
+    for (int i = 1; i < argc; i++)
     {
-        printf("conv1_bias读取失败\n");
-        return 4;
-    }
-
-    // 读取卷积层2参数
-    nread = fread(conv2_weight, sizeof(float), CONV2_OUT_CHANNELS * CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE, fp);
-    if (nread != CONV2_OUT_CHANNELS * CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE)
-    {
-        printf("conv2_weight读取失败\n");
-        return 5;
+        if ((strcmp(argv[i], "--batch") == 0 || strcmp(argv[i], "-b") == 0) && i + 1 < argc)
+        {
+            batch = atoi(argv[++i]);
+            batch_given = 1;
+        }
+        else if ((strcmp(argv[i], "--threads") == 0 || strcmp(argv[i], "-t") == 0) && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc)
+        {
+            isa = conv_isa_parse(argv[++i]);
+            simd_given = 1;
+            if (isa < 0 || !conv_isa_supported(isa))
+            {
+                printf("不支持的指令集: %s\n", argv[i]);
+                batch = -1;
+                break;
+            }
+        }
+        else if (strcmp(argv[i], "--quantize") == 0 && i + 1 < argc)
+        {
+            calibration = atoi(argv[++i]);
+            if (calibration <= 0)
+            {
+                batch = -1;
+                break;
+            }
+        }
+        else if (strcmp(argv[i], "--int8") == 0)
+        {
+            use_int8 = 1;
+        }
+        else if (argv[i][0] != '-' && !image_path)
+        {
+            image_path = argv[i];
+        }
+        else
+        {
+            batch = -1;
+            break;
+        }
     }
-
-    nread = fread(conv2_bias, sizeof(float), CONV2_OUT_CHANNELS, fp);
-    if (nread != CONV2_OUT_CHANNELS)
+    if (batch_given && !simd_given)
     {
-        printf("conv2_bias读取失败\n");
-        return 6;
+        // 只指定了--batch：测试集用批量推理（批大小为0时逐张调用参考实现cnn_forward）
+        isa = -1;
     }
-
-    // 读取全连接层1参数
-    nread = fread(fc1_weight, sizeof(float), FC1_OUT * FC1_IN, fp);
-    if (nread != FC1_OUT * FC1_IN)
+    if (batch < 0 || threads < 0)
     {
-        printf("fc1_weight读取失败\n");
-        return 7;
+        printf("用法: %s [图片.bmp] [--batch N] [--threads N] [--simd ISA] [--quantize N] [--int8]\n", argv[0]);
+        printf("  --simd ISA    逐张推理的卷积核（auto、scalar、sse4、avx2），默认auto，即CPU支持的最快的SIMD卷积核\n");
+        printf("  --batch N     测试集评估改用批量推理，每批N张（im2col+GEMM，通常比默认的逐张SIMD慢；\n");
+        printf("                0表示逐张调用参考实现cnn_forward）；同时指定--simd时忽略\n");
+        printf("  --threads N   测试集评估的线程数（默认0，表示使用全部CPU核）\n");
+        printf("  --quantize N  用测试集前N张图像校准，生成INT8量化参数文件 %s\n", QPARAMS_FILE);
+        printf("  --int8        使用INT8量化参数推理；评估测试集时同时给出与float推理的对比\n");
+        return 1;
     }
 
-    nread = fread(fc1_bias, sizeof(float), FC1_OUT, fp);
-    if (nread != FC1_OUT)
+    // 映射参数文件，各层参数直接指向映射的内存
+    struct cnn_params params;
+    struct mapped_file params_file;
+    if (map_cnn_params(PARAMS_FILE, &params, &params_file) != 0)
     {
-        printf("fc1_bias读取失败\n");
-        return 8;
+        printf("无法读取参数文件！\n");
+        return 1;
     }
 
-    // 读取全连接层2参数
-    nread = fread(fc2_weight, sizeof(float), FC2_OUT * FC2_IN, fp);
-    if (nread != FC2_OUT * FC2_IN)
+    struct cnn_qparams qparams;
+    if (calibration > 0)
     {
-        printf("fc2_weight读取失败\n");
-        return 9;
+        // 量化模式：校准并写入量化参数文件
+        struct mnist_images images;
+        if (open_mnist_images(TEST_IMAGES_FILE, &images) != 0)
+        {
+            return 3;
+        }
+        uint32_t count = (uint32_t)calibration < images.count ? (uint32_t)calibration : images.count;
+        cnn_quantize(&params, images.pixels, count, &qparams);
+        close_mnist_images(&images);
+        if (save_cnn_qparams(QPARAMS_FILE, &qparams) != 0)
+        {
+            return 4;
+        }
+        printf("已用测试集前 %u 张图像校准，INT8量化参数写入 %s\n", count, QPARAMS_FILE);
+        unmap_file(&params_file);
+        return 0;
     }
-
-    nread = fread(fc2_bias, sizeof(float), FC2_OUT, fp);
-    if (nread != FC2_OUT)
+    if (use_int8 && load_cnn_qparams(QPARAMS_FILE, &qparams) != 0)
     {
-        printf("fc2_bias读取失败\n");
-        return 10;
+        printf("无法读取量化参数文件，请先运行 %s --quantize N\n", argv[0]);
+        return 1;
     }
 
-    fclose(fp);
-
-    if (argc == 2)
+    if (image_path)
     {
         // 单个图像推理模式
         float img[IMG_C * IMG_H * IMG_W];
         float output[10];
 
         // 读取BMP图像
-        readbmp(argv[1], img);
+        readbmp(image_path, img);
 
         // 执行CNN前向推理
-        cnn_forward(img, conv1_weight, conv1_bias, conv2_weight, conv2_bias,
-                    fc1_weight, fc1_bias, fc2_weight, fc2_bias, output);
-
-        // 找出最大值的索引
-        int predicted = 0;
-        for (int i = 0; i < 10; i++)
+        if (use_int8)
         {
-            //printf("%f ", output[i]);
-            if (output[predicted] < output[i])
-            {
-                predicted = i;
-            }
+            cnn_forward_int8(&qparams, img, output, isa >= 0 ? (enum conv_isa)isa : conv_isa_best());
+        }
+        else if (isa >= 0)
+        {
+            cnn_forward_simd(&params, img, output, isa);
+        }
+        else
+        {
+            cnn_forward(img, params.conv1_weight, params.conv1_bias, params.conv2_weight, params.conv2_bias,
+                        params.fc1_weight, params.fc1_bias, params.fc2_weight, params.fc2_bias, output);
         }
 
-        printf("识别结果: %d\n", predicted);
+        printf("识别结果: %d\n", argmax(output));
     }
     else
     {
         // 测试集评估模式
-        const char *image_file = "./data/t10k-images-idx3-ubyte";
-        const char *label_file = "./data/t10k-labels-idx1-ubyte";
-
-        uint32_t num_images, rows, cols, num_labels;
-        uint8_t **images = read_mnist_images(image_file, &num_images, &rows, &cols);
-        uint8_t *labels = read_mnist_labels(label_file, &num_labels);
+        struct mnist_images images;
+        struct mnist_labels labels;
+        if (open_mnist_images(TEST_IMAGES_FILE, &images) != 0 || open_mnist_labels(TEST_LABELS_FILE, &labels) != 0)
+        {
+            return 3;
+        }
+        if (images.count != labels.count)
+        {
+            printf("图像数量（%u）与标签数量（%u）不一致！\n", images.count, labels.count);
+            return 3;
+        }
 
-        printf("测试集图像数量: %u\n", num_images);
+        printf("测试集图像数量: %u\n", images.count);
 
-        // 统计正确预测数量
-        int correct = 0;
-        for (int i = 0; i < num_images; i++)
+        struct eval_options options = {batch, threads, isa, NULL};
+        struct eval_result result;
+        if (evaluate_test_set(&params, images.pixels, labels.labels, images.count, &options, &result) != 0)
         {
-            float img[IMG_C * IMG_H * IMG_W];
-            float output[10];
-
-            // 将图像数据转换为浮点数
-            for (int j = 0; j < IMG_H * IMG_W; j++)
-            {
-                img[j] = images[i][j] / 255.0f; // 简单归一化，cnn_forward中会做正确的标准化
-            }
+            printf("内存分配或创建线程失败！\n");
+            return 2;
+        }
 
-            // 执行CNN前向推理
-            cnn_forward(img, conv1_weight, conv1_bias, conv2_weight, conv2_bias,
-                        fc1_weight, fc1_bias, fc2_weight, fc2_bias, output);
+        // 打印准确率和吞吐量
+        float accuracy = (float)result.correct / result.total;
+        printf("测试准确率: %.4f (%d/%d)\n", accuracy, result.correct, result.total);
+        print_confusion_matrix(&result);
+        char mode[64];
+        if (isa >= 0)
+        {
+            snprintf(mode, sizeof(mode), "逐张推理，%s卷积核", conv_isa_name(isa));
+        }
+        else if (batch > 0)
+        {
+            snprintf(mode, sizeof(mode), "批大小 %d", batch);
+        }
+        else
+        {
+            snprintf(mode, sizeof(mode), "逐张推理，参考实现");
+        }
+        printf("推理耗时: %.3f 秒（%s，%d 个线程），吞吐量: %.0f 张/秒\n",
+               result.seconds, mode, result.threads, result.total / result.seconds);
 
-            // 找出最大值的索引
-            int predicted = 0;
-            for (int j = 1; j < 10; j++)
+        if (use_int8)
+        {
+            // INT8推理总是逐张进行，卷积层使用与float SIMD卷积核相同的指令集。为了与同样的方式比较吞吐量，
+            // 上面不是逐张调用SIMD卷积核时，再用该指令集逐张测一遍float
+            enum conv_isa int8_isa = isa >= 0 ? (enum conv_isa)isa : conv_isa_best();
+            struct eval_result fresult = result;
+            if (isa < 0)
             {
-                if (output[predicted] < output[j])
+                struct eval_options foptions = {0, threads, int8_isa, NULL};
+                if (evaluate_test_set(&params, images.pixels, labels.labels, images.count, &foptions, &fresult) != 0)
                 {
-                    predicted = j;
+                    printf("内存分配或创建线程失败！\n");
+                    return 2;
                 }
+                printf("float推理耗时: %.3f 秒（逐张推理，%s卷积核，%d 个线程），吞吐量: %.0f 张/秒\n",
+                       fresult.seconds, conv_isa_name(int8_isa), fresult.threads, fresult.total / fresult.seconds);
             }
 
-            // 检查预测是否正确
-            if (predicted == labels[i])
-            {
-                correct++;
-            }
-
-            // 每处理1000张图像打印一次进度
-            if ((i + 1) % 1000 == 0)
+            // 用同样的评估流程测INT8推理
+            struct eval_result qresult;
+            options.qparams = &qparams;
+            if (evaluate_test_set(&params, images.pixels, labels.labels, images.count, &options, &qresult) != 0)
             {
-                printf("已处理 %d/%u 张图像\n", i + 1, num_images);
+                printf("内存分配或创建线程失败！\n");
+                return 2;
             }
+            float qaccuracy = (float)qresult.correct / qresult.total;
+            printf("INT8测试准确率: %.4f (%d/%d)，与float相比: %+.4f\n",
+                   qaccuracy, qresult.correct, qresult.total, qaccuracy - accuracy);
+            print_confusion_matrix(&qresult);
+            printf("INT8推理耗时: %.3f 秒（逐张推理，%s卷积核，%d 个线程），吞吐量: %.0f 张/秒，为逐张float的 %.2f 倍\n",
+                   qresult.seconds, conv_isa_name(int8_isa), qresult.threads, qresult.total / qresult.seconds,
+                   fresult.seconds / qresult.seconds);
         }
 
-        // 打印准确率
-        float accuracy = (float)correct / num_images;
-        printf("测试准确率: %.4f (%d/%u)\n", accuracy, correct, num_images);
-
-        // 释放测试集内存
-        for (uint32_t i = 0; i < num_images; i++)
-        {
-            free(images[i]);
-        }
-        free(images);
-        free(labels);
+        // 释放测试集映射
+        close_mnist_images(&images);
+        close_mnist_labels(&labels);
     }
 
-    // 释放参数内存
-    free(conv1_weight);
-    free(conv1_bias);
-    free(conv2_weight);
-    free(conv2_bias);
-    free(fc1_weight);
-    free(fc1_bias);
-    free(fc2_weight);
-    free(fc2_bias);
+    unmap_file(&params_file);
 
     return 0;
 }
 
-// 简化的CNN前向传播函数实现
-void cnn_forward(
-    float *input,        // 输入图像 [1, 28, 28]
-    float *conv1_weight, // [2, 1, 3, 3]
-    float *conv1_bias,   // [2]
-    float *conv2_weight, // [3, 2, 3, 3]
-    float *conv2_bias,   // [3]
-    float *fc1_weight,   // [16, 147]
-    float *fc1_bias,     // [16]
-    float *fc2_weight,   // [10, 16]
-    float *fc2_bias,     // [10]
-    float *output        // [10]
-)
-{
-    // 临时缓冲区
-    float conv1_output[CONV1_OUT_CHANNELS * CONV1_OUT_H * CONV1_OUT_W];
-    float relu1_output[CONV1_OUT_CHANNELS * CONV1_OUT_H * CONV1_OUT_W];
-    float conv2_output[CONV2_OUT_CHANNELS * CONV2_OUT_H * CONV2_OUT_W];
-    float relu2_output[CONV2_OUT_CHANNELS * CONV2_OUT_H * CONV2_OUT_W];
-    float pool1_output[CONV2_OUT_CHANNELS * POOL1_OUT_H * POOL1_OUT_W];
-    float pool2_output[CONV2_OUT_CHANNELS * POOL2_OUT_H * POOL2_OUT_W];
-    float fc1_output[FC1_OUT];
-    
-    // 输入标准化: 转换为与PyTorch相同的标准化格式
-    float normalized_input[IMG_C * IMG_H * IMG_W];
-    for (int i = 0; i < IMG_H * IMG_W; i++) {
-        // 应用与PyTorch相同的标准化: (x - mean) / std
-        normalized_input[i] = (input[i] - 0.1307f) / 0.3081f;
-    }
-    
-    // 1. 第一个卷积层: input -> conv1_output
-    for (int oc = 0; oc < CONV1_OUT_CHANNELS; oc++) {
-        for (int oh = 0; oh < CONV1_OUT_H; oh++) {
-            for (int ow = 0; ow < CONV1_OUT_W; ow++) {
-                float sum = 0.0f;
-                
-                for (int kh = 0; kh < CONV1_KERNEL_SIZE; kh++) {
-                    for (int kw = 0; kw < CONV1_KERNEL_SIZE; kw++) {
-                        int h_idx = oh + kh - CONV1_PADDING;
-                        int w_idx = ow + kw - CONV1_PADDING;
-                        
-                        if (h_idx >= 0 && h_idx < IMG_H && w_idx >= 0 && w_idx < IMG_W) {
-                            float in_val = normalized_input[h_idx * IMG_W + w_idx];
-                            float weight_val = conv1_weight[oc * CONV1_IN_CHANNELS * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE + 
-                                                          0 * CONV1_KERNEL_SIZE * CONV1_KERNEL_SIZE + 
-                                                          kh * CONV1_KERNEL_SIZE + kw];
-                            sum += in_val * weight_val;
-                        }
-                    }
-                }
-                
-                // 添加偏置
-                sum += conv1_bias[oc];
-                conv1_output[oc * CONV1_OUT_H * CONV1_OUT_W + oh * CONV1_OUT_W + ow] = sum;
-            }
-        }
-    }
-    
-    // 应用ReLU到conv1_output
-    for (int i = 0; i < CONV1_OUT_CHANNELS * CONV1_OUT_H * CONV1_OUT_W; i++) {
-        relu1_output[i] = conv1_output[i] > 0 ? conv1_output[i] : 0;
-    }
-    
-    // 2. 第二个卷积层: relu1_output -> conv2_output
-    for (int oc = 0; oc < CONV2_OUT_CHANNELS; oc++) {
-        for (int oh = 0; oh < CONV2_OUT_H; oh++) {
-            for (int ow = 0; ow < CONV2_OUT_W; ow++) {
-                float sum = 0.0f;
-                
-                for (int ic = 0; ic < CONV2_IN_CHANNELS; ic++) {
-                    for (int kh = 0; kh < CONV2_KERNEL_SIZE; kh++) {
-                        for (int kw = 0; kw < CONV2_KERNEL_SIZE; kw++) {
-                            int h_idx = oh + kh - CONV2_PADDING;
-                            int w_idx = ow + kw - CONV2_PADDING;
-                            
-                            if (h_idx >= 0 && h_idx < CONV1_OUT_H && w_idx >= 0 && w_idx < CONV1_OUT_W) {
-                                float in_val = relu1_output[ic * CONV1_OUT_H * CONV1_OUT_W + h_idx * CONV1_OUT_W + w_idx];
-                                float weight_val = conv2_weight[oc * CONV2_IN_CHANNELS * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE + 
-                                                              ic * CONV2_KERNEL_SIZE * CONV2_KERNEL_SIZE +
-                                                              kh * CONV2_KERNEL_SIZE + kw];
-                                sum += in_val * weight_val;
-                            }
-                        }
-                    }
-                }
-                
-                // 添加偏置
-                sum += conv2_bias[oc];
-                conv2_output[oc * CONV2_OUT_H * CONV2_OUT_W + oh * CONV2_OUT_W + ow] = sum;
-            }
-        }
-    }
-
-    // 应用ReLU到conv2_output
-    for (int i = 0; i < CONV2_OUT_CHANNELS * CONV2_OUT_H * CONV2_OUT_W; i++) {
-        relu2_output[i] = conv2_output[i] > 0 ? conv2_output[i] : 0;
-    }
-    
-    // 3. 第一次池化: relu2_output -> pool1_output
-    for (int c = 0; c < CONV2_OUT_CHANNELS; c++) {
-        for (int h = 0; h < POOL1_OUT_H; h++) {
-            for (int w = 0; w < POOL1_OUT_W; w++) {
-                float max_val = relu2_output[c * CONV2_OUT_H * CONV2_OUT_W + 2*h * CONV2_OUT_W + 2*w];
-                max_val = fmaxf(max_val, relu2_output[c * CONV2_OUT_H * CONV2_OUT_W + 2*h * CONV2_OUT_W + 2*w+1]);
-                max_val = fmaxf(max_val, relu2_output[c * CONV2_OUT_H * CONV2_OUT_W + (2*h+1) * CONV2_OUT_W + 2*w]);
-                max_val = fmaxf(max_val, relu2_output[c * CONV2_OUT_H * CONV2_OUT_W + (2*h+1) * CONV2_OUT_W + 2*w+1]);
-                
-                pool1_output[c * POOL1_OUT_H * POOL1_OUT_W + h * POOL1_OUT_W + w] = max_val;
-            }
-        }
-    }
-    
-    // 4. 第二次池化: pool1_output -> pool2_output
-    for (int c = 0; c < CONV2_OUT_CHANNELS; c++) {
-        for (int h = 0; h < POOL2_OUT_H; h++) {
-            for (int w = 0; w < POOL2_OUT_W; w++) {
-                float max_val = pool1_output[c * POOL1_OUT_H * POOL1_OUT_W + 2*h * POOL1_OUT_W + 2*w];
-                max_val = fmaxf(max_val, pool1_output[c * POOL1_OUT_H * POOL1_OUT_W + 2*h * POOL1_OUT_W + 2*w+1]);
-                max_val = fmaxf(max_val, pool1_output[c * POOL1_OUT_H * POOL1_OUT_W + (2*h+1) * POOL1_OUT_W + 2*w]);
-                max_val = fmaxf(max_val, pool1_output[c * POOL1_OUT_H * POOL1_OUT_W + (2*h+1) * POOL1_OUT_W + 2*w+1]);
-                
-                pool2_output[c * POOL2_OUT_H * POOL2_OUT_W + h * POOL2_OUT_W + w] = max_val;
-            }
-        }
-    }
-    
-    // 5. 第一个全连接层: pool2_output (展平) -> fc1_output
-    for (int i = 0; i < FC1_OUT; i++) {
-        float sum = 0.0f;
-        for (int j = 0; j < FC1_IN; j++) {
-            sum += pool2_output[j] * fc1_weight[i * FC1_IN + j];
-        }
-        sum += fc1_bias[i];
-        fc1_output[i] = sum > 0 ? sum : 0; // ReLU
-    }
-    
-    // 6. 第二个全连接层: fc1_output -> output
-    for (int i = 0; i < FC2_OUT; i++) {
-        float sum = 0.0f;
-        for (int j = 0; j < FC2_IN; j++) {
-            sum += fc1_output[j] * fc2_weight[i * FC2_IN + j];
-        }
-        output[i] = sum + fc2_bias[i];
-    }
-}
-
 void readbmp(const char *filename, float *img)
 {
     FILE *f = fopen(filename, "rb");
@@ -452,68 +301,3 @@ void readbmp(const char *filename, float *img)
     free(row_buf);
     fclose(f);
 }
-
-// 读取大端整数（4字节）
-uint32_t read_big_endian(FILE *fp)
-{
-    uint8_t bytes[4];
-    fread(bytes, sizeof(uint8_t), 4, fp);
-    return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
-}
-
-// 读取图像数据
-uint8_t **read_mnist_images(const char *filename, uint32_t *num_images, uint32_t *rows, uint32_t *cols)
-{
-    FILE *fp = fopen(filename, "rb");
-    if (!fp)
-    {
-        perror("Failed to open image file");
-        exit(1);
-    }
-
-    uint32_t magic = read_big_endian(fp);
-    if (magic != 0x00000803)
-    {
-        fprintf(stderr, "Invalid image file magic number: %08X\n", magic);
-        exit(1);
-    }
-
-    *num_images = read_big_endian(fp);
-    *rows = read_big_endian(fp);
-    *cols = read_big_endian(fp);
-
-    uint8_t **images = malloc(*num_images * sizeof(uint8_t *));
-    for (uint32_t i = 0; i < *num_images; ++i)
-    {
-        images[i] = malloc((*rows) * (*cols) * sizeof(uint8_t));
-        fread(images[i], sizeof(uint8_t), (*rows) * (*cols), fp);
-    }
-
-    fclose(fp);
-    return images;
-}
-
-// 读取标签数据
-uint8_t *read_mnist_labels(const char *filename, uint32_t *num_labels)
-{
-    FILE *fp = fopen(filename, "rb");
-    if (!fp)
-    {
-        perror("Failed to open label file");
-        exit(1);
-    }
-
-    uint32_t magic = read_big_endian(fp);
-    if (magic != 0x00000801)
-    {
-        fprintf(stderr, "Invalid label file magic number: %08X\n", magic);
-        exit(1);
-    }
-
-    *num_labels = read_big_endian(fp);
-    uint8_t *labels = malloc(*num_labels * sizeof(uint8_t));
-    fread(labels, sizeof(uint8_t), *num_labels, fp);
-
-    fclose(fp);
-    return labels;
-}
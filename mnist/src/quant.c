@@ -0,0 +1,250 @@
+#include "quant.h"
+#include "loader.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// 量化参数文件以8字节的标识开头，之后依次是struct cnn_qparams的各个字段
+static const char QPARAMS_MAGIC[8] = "CNNINT8";
+
+// 对称量化到[-127, 127]，与截断lrintf(x)的结果相同（|x|须小于2^22，输入和权重都远小于这个值）。
+// 先舍入再用整数比较截断，没有浮点比较，循环可以向量化
+static inline int8_t saturate_int8(float x)
+{
+    int32_t v = (int32_t)round_even(x);
+    v = v < 127 ? v : 127;
+    v = v > -127 ? v : -127;
+    return (int8_t)v;
+}
+
+// 最大绝对值对应127，全为0的通道步长取1
+static float scale_for(float max_abs)
+{
+    return max_abs > 0 ? max_abs / 127.0f : 1.0f;
+}
+
+static void update_max(float *max_abs, const float *x, int n)
+{
+    for (int i = 0; i < n; i++) {
+        float v = fabsf(x[i]);
+        *max_abs = v > *max_abs ? v : *max_abs;
+    }
+}
+
+// 量化一层的权重和偏置。weight为 [out, in_channels * group]，第ic个输入通道对应连续的group个权重
+static void quantize_layer(const float *weight, const float *bias, int out, int in_channels, int group,
+                           const float *in_scale, int8_t *qweight, float *scale, int32_t *qbias)
+{
+    const int in = in_channels * group;
+    for (int oc = 0; oc < out; oc++) {
+        float max_abs = 0.0f;
+        for (int j = 0; j < in; j++) {
+            float v = fabsf(weight[oc * in + j] * in_scale[j / group]);
+            max_abs = v > max_abs ? v : max_abs;
+        }
+        scale[oc] = scale_for(max_abs);
+        for (int j = 0; j < in; j++) {
+            qweight[oc * in + j] = saturate_int8(weight[oc * in + j] * in_scale[j / group] / scale[oc]);
+        }
+        qbias[oc] = (int32_t)lrintf(bias[oc] / scale[oc]);
+    }
+}
+
+void cnn_quantize(const struct cnn_params *params, const uint8_t *images, uint32_t count, struct cnn_qparams *qparams)
+{
+    float input_max[CONV1_IN_CHANNELS] = {0};
+    float relu1_max[CONV1_OUT_CHANNELS] = {0};
+    float pool2_max[CONV2_OUT_CHANNELS] = {0};
+    float fc1_max[FC1_OUT] = {0};
+    const int plane = IMG_H * IMG_W;
+    const int pooled = POOL2_OUT_H * POOL2_OUT_W;
+
+    // 统计校准图像上每层输入各通道的最大绝对值
+    for (uint32_t i = 0; i < count; i++) {
+        float img[IMG_C * IMG_H * IMG_W];
+        struct cnn_activations act;
+        for (int j = 0; j < plane; j++) {
+            img[j] = images[(size_t)i * plane + j] / 255.0f;
+        }
+        cnn_forward_activations(params, img, &act);
+
+        update_max(&input_max[0], act.input, plane);
+        for (int c = 0; c < CONV1_OUT_CHANNELS; c++) {
+            update_max(&relu1_max[c], act.relu1 + c * plane, plane);
+        }
+        for (int c = 0; c < CONV2_OUT_CHANNELS; c++) {
+            update_max(&pool2_max[c], act.pool2 + c * pooled, pooled);
+        }
+        for (int j = 0; j < FC1_OUT; j++) {
+            update_max(&fc1_max[j], act.fc1 + j, 1);
+        }
+    }
+
+    memset(qparams, 0, sizeof(*qparams));
+    for (int c = 0; c < CONV1_IN_CHANNELS; c++) {
+        qparams->conv1_in_scale[c] = scale_for(input_max[c]);
+    }
+    for (int c = 0; c < CONV2_IN_CHANNELS; c++) {
+        qparams->conv2_in_scale[c] = scale_for(relu1_max[c]);
+    }
+    for (int c = 0; c < CONV2_OUT_CHANNELS; c++) {
+        qparams->fc1_in_scale[c] = scale_for(pool2_max[c]);
+    }
+    for (int j = 0; j < FC2_IN; j++) {
+        qparams->fc2_in_scale[j] = scale_for(fc1_max[j]);
+    }
+
+    quantize_layer(params->conv1_weight, params->conv1_bias, CONV1_OUT_CHANNELS, CONV1_IN_CHANNELS, 9,
+                   qparams->conv1_in_scale, qparams->conv1_weight, qparams->conv1_scale, qparams->conv1_bias);
+    quantize_layer(params->conv2_weight, params->conv2_bias, CONV2_OUT_CHANNELS, CONV2_IN_CHANNELS, 9,
+                   qparams->conv2_in_scale, qparams->conv2_weight, qparams->conv2_scale, qparams->conv2_bias);
+    quantize_layer(params->fc1_weight, params->fc1_bias, FC1_OUT, CONV2_OUT_CHANNELS, pooled,
+                   qparams->fc1_in_scale, qparams->fc1_weight, qparams->fc1_scale, qparams->fc1_bias);
+    quantize_layer(params->fc2_weight, params->fc2_bias, FC2_OUT, FC2_IN, 1,
+                   qparams->fc2_in_scale, qparams->fc2_weight, qparams->fc2_scale, qparams->fc2_bias);
+}
+
+// 文件中的字段，按struct cnn_qparams中的顺序
+struct qparams_field {
+    void *data;
+    size_t size;
+};
+
+#define QPARAMS_FIELD(q, name) {(void *)(q)->name, sizeof((q)->name)}
+#define QPARAMS_LAYER(q, layer) \
+    QPARAMS_FIELD(q, layer##_in_scale), QPARAMS_FIELD(q, layer##_weight), \
+    QPARAMS_FIELD(q, layer##_scale), QPARAMS_FIELD(q, layer##_bias)
+#define QPARAMS_FIELD_COUNT 16
+
+static void qparams_fields(const struct cnn_qparams *q, struct qparams_field *fields)
+{
+    struct qparams_field all[QPARAMS_FIELD_COUNT] = {
+        QPARAMS_LAYER(q, conv1), QPARAMS_LAYER(q, conv2), QPARAMS_LAYER(q, fc1), QPARAMS_LAYER(q, fc2)};
+    memcpy(fields, all, sizeof(all));
+}
+
+int save_cnn_qparams(const char *filename, const struct cnn_qparams *qparams)
+{
+    struct qparams_field fields[QPARAMS_FIELD_COUNT];
+    qparams_fields(qparams, fields);
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "无法写入量化参数文件 %s\n", filename);
+        return -1;
+    }
+    int ok = fwrite(QPARAMS_MAGIC, 1, sizeof(QPARAMS_MAGIC), fp) == sizeof(QPARAMS_MAGIC);
+    for (int i = 0; i < QPARAMS_FIELD_COUNT && ok; i++) {
+        ok = fwrite(fields[i].data, 1, fields[i].size, fp) == fields[i].size;
+    }
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "写入量化参数文件 %s 失败\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+int load_cnn_qparams(const char *filename, struct cnn_qparams *qparams)
+{
+    struct qparams_field fields[QPARAMS_FIELD_COUNT];
+    qparams_fields(qparams, fields);
+    size_t expected = sizeof(QPARAMS_MAGIC);
+    for (int i = 0; i < QPARAMS_FIELD_COUNT; i++) {
+        expected += fields[i].size;
+    }
+
+    struct mapped_file file;
+    if (map_file(filename, &file) != 0) {
+        return -1;
+    }
+    if (file.size != expected || memcmp(file.data, QPARAMS_MAGIC, sizeof(QPARAMS_MAGIC)) != 0) {
+        fprintf(stderr, "%s 不是与当前网络结构一致的量化参数文件\n", filename);
+        unmap_file(&file);
+        return -1;
+    }
+    // 参数只有约5KB，复制出来以保证各字段对齐
+    const uint8_t *p = file.data + sizeof(QPARAMS_MAGIC);
+    for (int i = 0; i < QPARAMS_FIELD_COUNT; i++) {
+        memcpy(fields[i].data, p, fields[i].size);
+        p += fields[i].size;
+    }
+    unmap_file(&file);
+    return 0;
+}
+
+// int8向量点积，int32累加
+static inline int32_t dot_int8(const int8_t *a, const int8_t *b, int n)
+{
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void cnn_forward_int8(const struct cnn_qparams *q, const float *input, float *output, enum conv_isa isa)
+{
+    const qconv_row_fn conv_row = qconv_row_for(isa);
+
+    // 补0后的输入和第一个卷积层的结果（int8范围的值按int16存放），共约5.6KB
+    int16_t in_pad[CONV1_IN_CHANNELS * PAD_PLANE];
+    int16_t relu1_pad[CONV1_OUT_CHANNELS * PAD_PLANE];
+    int16_t row[CONV2_OUT_W];
+    int8_t q_pool2[FC1_IN];
+    int8_t q_fc1[FC1_OUT];
+    const int pooled = POOL2_OUT_H * POOL2_OUT_W;
+
+    memset(in_pad, 0, sizeof(in_pad));
+    memset(relu1_pad, 0, sizeof(relu1_pad));
+
+    // 输入标准化后量化，写入补0后的缓冲区中间
+    float inv_scale = 1.0f / q->conv1_in_scale[0];
+    for (int h = 0; h < IMG_H; h++) {
+        for (int w = 0; w < IMG_W; w++) {
+            in_pad[(h + 1) * PAD_W + w + 1] = saturate_int8((input[h * IMG_W + w] - 0.1307f) / 0.3081f * inv_scale);
+        }
+    }
+
+    // 1. 第一个卷积层 + ReLU，按第二个卷积层的输入步长重新量化，每行直接写入第二个卷积层的补0输入
+    for (int oc = 0; oc < CONV1_OUT_CHANNELS; oc++) {
+        const int8_t *wt = q->conv1_weight + oc * CONV1_IN_CHANNELS * 9;
+        float m = q->conv1_scale[oc] / q->conv2_in_scale[oc];
+        for (int oh = 0; oh < CONV1_OUT_H; oh++) {
+            conv_row(in_pad, CONV1_IN_CHANNELS, wt, q->conv1_bias[oc], m, oh,
+                     relu1_pad + oc * PAD_PLANE + (oh + 1) * PAD_W + 1);
+        }
+    }
+
+    // 2. 第二个卷积层 + ReLU，按全连接层1的输入步长重新量化后做4x4池化。
+    // 重新量化单调不减，先量化再取最大值与在int32累加结果上取最大值相同
+    for (int oc = 0; oc < CONV2_OUT_CHANNELS; oc++) {
+        const int8_t *wt = q->conv2_weight + oc * CONV2_IN_CHANNELS * 9;
+        float m = q->conv2_scale[oc] / q->fc1_in_scale[oc];
+        for (int y = 0; y < POOL2_OUT_H; y++) {
+            int16_t col_max[CONV2_OUT_W] = {0};
+            for (int dy = 0; dy < 4; dy++) {
+                conv_row(relu1_pad, CONV2_IN_CHANNELS, wt, q->conv2_bias[oc], m, 4 * y + dy, row);
+                for (int x = 0; x < CONV2_OUT_W; x++) {
+                    col_max[x] = row[x] > col_max[x] ? row[x] : col_max[x];
+                }
+            }
+            for (int x = 0; x < POOL2_OUT_W; x++) {
+                int16_t a = col_max[4 * x] > col_max[4 * x + 1] ? col_max[4 * x] : col_max[4 * x + 1];
+                int16_t b = col_max[4 * x + 2] > col_max[4 * x + 3] ? col_max[4 * x + 2] : col_max[4 * x + 3];
+                q_pool2[oc * pooled + y * POOL2_OUT_W + x] = (int8_t)(a > b ? a : b);
+            }
+        }
+    }
+
+    // 3. 第一个全连接层 + ReLU
+    for (int i = 0; i < FC1_OUT; i++) {
+        int32_t acc = dot_int8(q_pool2, q->fc1_weight + i * FC1_IN, FC1_IN) + q->fc1_bias[i];
+        q_fc1[i] = (int8_t)requantize_relu(acc, q->fc1_scale[i] / q->fc2_in_scale[i]);
+    }
+
+    // 4. 第二个全连接层，输出还原为float
+    for (int i = 0; i < FC2_OUT; i++) {
+        int32_t acc = dot_int8(q_fc1, q->fc2_weight + i * FC2_IN, FC2_IN) + q->fc2_bias[i];
+        output[i] = acc * q->fc2_scale[i];
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef QUANT_H
+#define QUANT_H
+
+#include <stdint.h>
+#include "cnn.h"
+#include "conv_simd.h"
+
+// INT8训练后量化
+//
+// 每层的输入按通道对称量化: x ≈ q * in_scale[c]，q为int8，in_scale由校准图像上各通道的最大值确定。
+// 输入通道的步长折算进权重后，权重再按输出通道对称量化: w * in_scale[ic] ≈ q * scale[oc]，
+// 偏置按scale[oc]量化为int32。这样int8乘、int32累加的结果乘以scale[oc]就是该层的输出，
+// 再除以下一层的in_scale重新量化为int8
+
+// 量化后的网络参数，字段顺序即量化参数文件中的顺序
+struct cnn_qparams {
+    float conv1_in_scale[CONV1_IN_CHANNELS];
+    int8_t conv1_weight[CONV1_WEIGHT_SIZE];
+    float conv1_scale[CONV1_OUT_CHANNELS];
+    int32_t conv1_bias[CONV1_OUT_CHANNELS];
+
+    float conv2_in_scale[CONV2_IN_CHANNELS];
+    int8_t conv2_weight[CONV2_WEIGHT_SIZE];
+    float conv2_scale[CONV2_OUT_CHANNELS];
+    int32_t conv2_bias[CONV2_OUT_CHANNELS];
+
+    float fc1_in_scale[CONV2_OUT_CHANNELS]; // 按池化前的通道，同一通道的49个特征共用
+    int8_t fc1_weight[FC1_WEIGHT_SIZE];
+    float fc1_scale[FC1_OUT];
+    int32_t fc1_bias[FC1_OUT];
+
+    float fc2_in_scale[FC2_IN];
+    int8_t fc2_weight[FC2_WEIGHT_SIZE];
+    float fc2_scale[FC2_OUT];
+    int32_t fc2_bias[FC2_OUT];
+};
+
+// 用前count张图像（连续存放的28x28图像）上float推理的激活值校准，量化params
+void cnn_quantize(const struct cnn_params *params, const uint8_t *images, uint32_t count, struct cnn_qparams *qparams);
+
+// 写入/读取量化参数文件，成功返回0，失败时打印原因并返回-1
+int save_cnn_qparams(const char *filename, const struct cnn_qparams *qparams);
+int load_cnn_qparams(const char *filename, struct cnn_qparams *qparams);
+
+// 单张图像的INT8前向推理：输入与cnn_forward相同（归一化到[0, 1]的28x28图像），输出为float。
+// 两个卷积层使用isa对应的INT8卷积行核（CPU必须支持），各指令集的结果完全相同
+void cnn_forward_int8(const struct cnn_qparams *qparams, const float *input, float *output, enum conv_isa isa);
+
+#endif // QUANT_H
@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cnn.h"
+#include "conv_simd.h"
+#include "loader.h"
+#include "quant.h"
+
+// 检查各指令集的SIMD卷积核：与参考实现cnn_forward在测试集前1000张图像和一组随机图像上比较输出；
+// INT8推理用同一组图像校准，各指令集的输出必须与标量实现逐位相同
+
+#define NUM_TEST_IMAGES 1000
+#define NUM_RANDOM_IMAGES 200
+#define TOLERANCE 1e-5f // 相对误差上限
+
+static double now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    struct cnn_params params;
+    struct mapped_file params_file;
+    if (map_cnn_params("./ExportPara/parameters_cnn.bin", &params, &params_file) != 0)
+    {
+        return 1;
+    }
+
+    // 测试图像：测试集（如果存在）和随机图像
+    int count = 0;
+    uint8_t *pixels = malloc((size_t)(NUM_TEST_IMAGES + NUM_RANDOM_IMAGES) * IMG_H * IMG_W);
+    float *inputs = malloc((size_t)(NUM_TEST_IMAGES + NUM_RANDOM_IMAGES) * IMG_H * IMG_W * sizeof(float));
+    float *expected = malloc((size_t)(NUM_TEST_IMAGES + NUM_RANDOM_IMAGES) * FC2_OUT * sizeof(float));
+    if (!pixels || !inputs || !expected)
+    {
+        printf("内存分配失败！\n");
+        return 2;
+    }
+    struct mnist_images images;
+    if (open_mnist_images("./data/t10k-images-idx3-ubyte", &images) == 0)
+    {
+        count = images.count < NUM_TEST_IMAGES ? (int)images.count : NUM_TEST_IMAGES;
+        memcpy(pixels, images.pixels, (size_t)count * IMG_H * IMG_W);
+        close_mnist_images(&images);
+    }
+    srand(2024);
+    for (int i = count * IMG_H * IMG_W; i < (count + NUM_RANDOM_IMAGES) * IMG_H * IMG_W; i++)
+    {
+        pixels[i] = (uint8_t)(rand() & 0xFF);
+    }
+    count += NUM_RANDOM_IMAGES;
+    for (int i = 0; i < count * IMG_H * IMG_W; i++)
+    {
+        inputs[i] = pixels[i] / 255.0f;
+    }
+
+    // 参考结果
+    double t0 = now();
+    for (int i = 0; i < count; i++)
+    {
+        const float *img = inputs + i * IMG_H * IMG_W;
+        cnn_forward(img, params.conv1_weight, params.conv1_bias, params.conv2_weight, params.conv2_bias,
+                    params.fc1_weight, params.fc1_bias, params.fc2_weight, params.fc2_bias, expected + i * FC2_OUT);
+    }
+    double reference_us = (now() - t0) / count * 1e6;
+    printf("%-10s %8.2f us/张\n", "reference", reference_us);
+
+    int failures = 0;
+    for (int isa = 0; isa < CONV_ISA_COUNT; isa++)
+    {
+        if (!conv_isa_supported(isa))
+        {
+            printf("%-10s CPU不支持，跳过\n", conv_isa_name(isa));
+            continue;
+        }
+
+        float max_error = 0.0f;
+        int mismatches = 0;
+        t0 = now();
+        for (int i = 0; i < count; i++)
+        {
+            float output[FC2_OUT];
+            cnn_forward_simd(&params, inputs + i * IMG_H * IMG_W, output, isa);
+            for (int j = 0; j < FC2_OUT; j++)
+            {
+                float ref = expected[i * FC2_OUT + j];
+                float error = fabsf(output[j] - ref) / (1.0f + fabsf(ref));
+                max_error = error > max_error ? error : max_error;
+            }
+            mismatches += argmax(output) != argmax(expected + i * FC2_OUT);
+        }
+        double us = (now() - t0) / count * 1e6;
+
+        int ok = max_error <= TOLERANCE && mismatches == 0;
+        failures += !ok;
+        printf("%-10s %8.2f us/张  最大相对误差 %.2e  识别结果不同 %d 张  %s\n",
+               conv_isa_name(isa), us, max_error, mismatches, ok ? "通过" : "失败");
+    }
+
+    // INT8：标量实现为基准
+    struct cnn_qparams qparams;
+    cnn_quantize(&params, pixels, (uint32_t)count, &qparams);
+    float *expected_int8 = malloc((size_t)count * FC2_OUT * sizeof(float));
+    if (!expected_int8)
+    {
+        printf("内存分配失败！\n");
+        return 2;
+    }
+    t0 = now();
+    for (int i = 0; i < count; i++)
+    {
+        cnn_forward_int8(&qparams, inputs + i * IMG_H * IMG_W, expected_int8 + i * FC2_OUT, CONV_ISA_SCALAR);
+    }
+    printf("int8 %-5s %8.2f us/张\n", conv_isa_name(CONV_ISA_SCALAR), (now() - t0) / count * 1e6);
+    for (int isa = CONV_ISA_SCALAR + 1; isa < CONV_ISA_COUNT; isa++)
+    {
+        if (!conv_isa_supported(isa))
+        {
+            continue;
+        }
+        int differ = 0;
+        t0 = now();
+        for (int i = 0; i < count; i++)
+        {
+            float output[FC2_OUT];
+            cnn_forward_int8(&qparams, inputs + i * IMG_H * IMG_W, output, isa);
+            differ += memcmp(output, expected_int8 + i * FC2_OUT, sizeof(output)) != 0;
+        }
+        double us = (now() - t0) / count * 1e6;
+        failures += differ != 0;
+        printf("int8 %-5s %8.2f us/张  与标量结果不同 %d 张  %s\n", conv_isa_name(isa), us, differ, differ == 0 ? "通过" : "失败");
+    }
+
+    free(expected_int8);
+    free(pixels);
+    free(inputs);
+    free(expected);
+    unmap_file(&params_file);
+    return failures == 0 ? 0 : 1;
+}